@@ -1,7 +1,10 @@
 #include "./application.h"
 #include "./helper.h"
+#include "./jsonwriter.h"
+#include "./metricsexporter.h"
 
 #include "../connector/syncthingconfig.h"
+#include "../connector/syncthingipc.h"
 
 #include <c++utilities/application/failure.h>
 #include <c++utilities/io/ansiescapecodes.h>
@@ -11,9 +14,14 @@
 #include <qtutilities/misc/conversion.h>
 
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
 #include <QNetworkAccessManager>
 #include <QHostAddress>
+#include <QJsonObject>
+#include <QJsonArray>
 
+#include <cstring>
 #include <functional>
 #include <iostream>
 
@@ -39,7 +47,7 @@ void exitApplication(int statusCode)
 inline QString argToQString(const char *arg)
 {
 #if !defined(PLATFORM_WINDOWS)
-    return argToQString(arg);
+    return QString::fromLocal8Bit(arg);
 #else
     // under Windows args are converted to UTF-8
     return QString::fromUtf8(arg);
@@ -47,10 +55,13 @@ inline QString argToQString(const char *arg)
 }
 
 Application::Application() :
-    m_expectedResponse(0)
+    m_expectedResponse(0),
+    m_minLogLevel(-1),
+    m_followingLog(false),
+    m_eventsDuration(0)
 {
-    // take ownership over the global QNetworkAccessManager
-    networkAccessManager().setParent(this);
+    // take ownership over the global QNetworkAccessManager instances
+    setNetworkAccessManagerParent(this);
     exitFunction = &exitApplication;
 
     // setup argument callbacks
@@ -65,10 +76,20 @@ Application::Application() :
     m_args.resume.setCallback(bind(&Application::requestResume, this, _1));
     m_args.resumeAll.setCallback(bind(&Application::requestResumeAll, this, _1));
     m_args.waitForIdle.setCallback(bind(&Application::initWaitForIdle, this, _1));
+    m_args.events.setCallback(bind(&Application::initEvents, this, _1));
+    m_args.watch.setCallback(bind(&Application::initWatch, this, _1));
+    m_args.bench.setCallback(bind(&Application::runBenchmark, this, _1));
 
     // connect signals and slots
     connect(&m_connection, &SyncthingConnection::statusChanged, this, &Application::handleStatusChanged);
     connect(&m_connection, &SyncthingConnection::error, this, &Application::handleError);
+    m_idleTimer.setSingleShot(true);
+    m_waitTimeoutTimer.setSingleShot(true);
+    connect(&m_idleTimer, &QTimer::timeout, &QCoreApplication::quit);
+    connect(&m_waitTimeoutTimer, &QTimer::timeout, this, &Application::handleWaitForIdleTimeout);
+    m_logPollTimer.setSingleShot(true);
+    m_logPollTimer.setInterval(2000);
+    connect(&m_logPollTimer, &QTimer::timeout, this, &Application::requestNewLogEntries);
 }
 
 Application::~Application()
@@ -93,6 +114,17 @@ int Application::exec(int argc, const char * const *argv)
             return 0;
         }
 
+        // print statistics about recorded events, no connection required
+        if(m_args.events.isPresent() && m_args.stats.isPresent()) {
+            return printEventStatistics();
+        }
+
+        // run the command against multiple instances concurrently if multiple URLs or an inventory are specified
+        // note: serve-metrics handles multiple instances within this process
+        if((m_args.url.occurrences() > 1 || m_args.inventory.isPresent()) && !m_args.serveMetrics.isPresent()) {
+            return runOnMultipleInstances(argc, argv);
+        }
+
         // locate and read Syncthing config file
         QString configFile;
         const char *configFileArgValue = m_args.configFile.firstValue();
@@ -117,7 +149,7 @@ int Application::exec(int argc, const char * const *argv)
         if(const char *urlArgValue = m_args.url.firstValue()) {
             m_settings.syncthingUrl = argToQString(urlArgValue);
         } else if(!config.guiAddress.isEmpty()) {
-            m_settings.syncthingUrl = (config.guiEnforcesSecureConnection || !QHostAddress(config.guiAddress.mid(0, config.guiAddress.indexOf(QChar(':')))).isLoopback() ? QStringLiteral("https://") : QStringLiteral("http://")) + config.guiAddress;
+            m_settings.syncthingUrl = config.syncthingUrl();
         } else {
             m_settings.syncthingUrl = QStringLiteral("http://localhost:8080");
         }
@@ -139,8 +171,67 @@ int Application::exec(int argc, const char * const *argv)
             }
         }
 
+        // serve metrics until interrupted, connections are managed by the exporter
+        if(m_args.serveMetrics.isPresent()) {
+            return serveMetrics();
+        }
+
+        // rescanning paths requires the config to look up the dirs containing the paths
+        if(m_args.rescan.isPresent() && m_args.rescan.values().empty() && !m_args.path.isPresent()) {
+            cerr << "Error: No directories or paths to rescan specified" << endl;
+            return 1;
+        }
+        const bool rescanningPaths = isRescanningPaths();
+
+        // try to delegate to a running Syncthing Tray instance which is already connected to avoid the
+        // REST API round-trips required to establish a new connection
+        int exitCode;
+        if(!m_args.noTray.isPresent() && !rescanningPaths && delegateToTray(exitCode)) {
+            return exitCode;
+        }
+
+        // request the status of relevant dirs when connecting so it is known before the callbacks are invoked
+        if(m_args.status.isPresent() || m_args.waitForIdle.isPresent() || m_args.watch.isPresent()) {
+            QStringList dirIds;
+            for(size_t i = 0; i != m_args.dir.occurrences(); ++i) {
+                dirIds << argToQString(m_args.dir.values(i).front());
+            }
+            m_connection.setRequestingDirStatusOnConnect(!dirIds.isEmpty() || !m_args.dev.isPresent(), dirIds);
+        }
+        if(m_args.log.isPresent() && !initLogFilters()) {
+            return 1;
+        }
+        if(m_args.bench.isPresent() && !initBenchmark()) {
+            return 1;
+        }
+        if(m_args.events.isPresent() && !initEventRecording()) {
+            return 1;
+        }
+        if(m_args.waitForIdle.isPresent() && !initWaitForIdleTimers()) {
+            return 1;
+        }
+
+        // request only the data required by the specified commands when connecting
+        // note: the config is always requested, it is all --rescan-all, --pause-all and --resume-all need
+        SyncthingConnectProfile connectProfile = SyncthingConnectProfile::Config;
+        if(m_args.status.isPresent()) {
+            connectProfile = connectProfile | SyncthingConnectProfile::Status | SyncthingConnectProfile::Connections
+                    | SyncthingConnectProfile::DirStatistics | SyncthingConnectProfile::DevStatistics | SyncthingConnectProfile::Events;
+        }
+        if(m_args.waitForIdle.isPresent()) {
+            connectProfile = connectProfile | SyncthingConnectProfile::Status | SyncthingConnectProfile::Connections | SyncthingConnectProfile::Events;
+        }
+        if(m_args.events.isPresent()) {
+            connectProfile = connectProfile | SyncthingConnectProfile::Events;
+        }
+        if(m_args.watch.isPresent()) {
+            connectProfile = connectProfile | SyncthingConnectProfile::Status | SyncthingConnectProfile::Connections | SyncthingConnectProfile::Events;
+        }
+        m_connection.setConnectProfile(connectProfile);
+
         // finally to request / establish connection
-        if(m_args.status.isPresent() || m_args.rescanAll.isPresent() || m_args.pauseAll.isPresent() || m_args.resumeAll.isPresent() || m_args.waitForIdle.isPresent()) {
+        if(m_args.status.isPresent() || m_args.rescanAll.isPresent() || m_args.pauseAll.isPresent() || m_args.resumeAll.isPresent() || m_args.waitForIdle.isPresent()
+                || m_args.events.isPresent() || m_args.watch.isPresent() || rescanningPaths) {
             // those arguments rquire establishing a connection first, the actual handler is called by handleStatusChanged() when
             // the connection has been established
             m_connection.reconnect(m_settings);
@@ -161,14 +252,232 @@ int Application::exec(int argc, const char * const *argv)
     }
 }
 
+/*!
+ * \brief Returns the number of elements of argv to be skipped when passing \a arg to the process for a particular instance.
+ */
+static int instanceSpecificArgCount(const char *arg)
+{
+    static const char *const instanceSpecificArgs[] = { "--url", "-u", "--api-key", "-k", "--cert", "--inventory", "--max-parallel" };
+    for(const char *instanceSpecificArg : instanceSpecificArgs) {
+        const size_t size = strlen(instanceSpecificArg);
+        if(!strncmp(arg, instanceSpecificArg, size)) {
+            if(!arg[size]) {
+                return 2;
+            } else if(arg[size] == '=') {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*!
+ * \brief Determines the targets specified via --url and --inventory.
+ * \remarks The API key and certificate specified via the command line are used unless specified in the inventory.
+ */
+bool Application::readInstanceTargets(std::vector<InstanceTarget> &targets)
+{
+    for(size_t i = 0; i != m_args.url.occurrences(); ++i) {
+        targets.emplace_back();
+        targets.back().url = QString::fromLocal8Bit(m_args.url.values(i).front());
+    }
+    if(const char *inventoryArgValue = m_args.inventory.firstValue()) {
+        QString errorMessage;
+        if(!InstanceRunner::readInventory(fromNativeFileName(inventoryArgValue), targets, errorMessage)) {
+            cerr << "Error: Unable to read inventory \"" << inventoryArgValue << "\": " << errorMessage.toLocal8Bit().data() << endl;
+            return false;
+        }
+    }
+    if(targets.empty()) {
+        cerr << "Error: No instances specified" << endl;
+        return false;
+    }
+    for(InstanceTarget &target : targets) {
+        if(target.apiKey.isEmpty() && m_args.apiKey.firstValue()) {
+            target.apiKey = QString::fromLocal8Bit(m_args.apiKey.firstValue());
+        }
+        if(target.certificate.isEmpty() && m_args.certificate.firstValue()) {
+            target.certificate = QString::fromLocal8Bit(m_args.certificate.firstValue());
+        }
+    }
+    return true;
+}
+
+int Application::runOnMultipleInstances(int argc, const char *const *argv)
+{
+    if(m_args.watch.isPresent() || m_args.events.isPresent()) {
+        cerr << "Error: watch and events can not be used with multiple instances" << endl;
+        return 1;
+    }
+
+    vector<InstanceTarget> targets;
+    if(!readInstanceTargets(targets)) {
+        return 1;
+    }
+    int maxParallel = 16;
+    if(const char *maxParallelArgValue = m_args.maxParallel.firstValue()) {
+        bool ok;
+        maxParallel = QByteArray(maxParallelArgValue).toInt(&ok);
+        if(!ok || maxParallel <= 0) {
+            cerr << "Error: Specified max. number of parallel instances \"" << maxParallelArgValue << "\" is not a positive number" << endl;
+            return 1;
+        }
+    }
+
+    // pass all other arguments to the processes for the particular instances
+    QStringList commonArgs;
+    for(int i = 1; i < argc;) {
+        if(const int skip = instanceSpecificArgCount(argv[i])) {
+            i += skip;
+        } else {
+            commonArgs << QString::fromLocal8Bit(argv[i++]);
+        }
+    }
+
+    InstanceRunner runner(QCoreApplication::applicationFilePath(), commonArgs, move(targets));
+    connect(&runner, &InstanceRunner::finished, &QCoreApplication::exit);
+    runner.start(maxParallel);
+    return QCoreApplication::exec();
+}
+
+int Application::serveMetrics()
+{
+    QString address(QStringLiteral("127.0.0.1"));
+    quint16 port = 9494;
+    if(const char *listenArgValue = m_args.listen.firstValue()) {
+        const QString listen(QString::fromLocal8Bit(listenArgValue));
+        const int portSeparator = listen.lastIndexOf(QChar(':'));
+        bool ok = portSeparator > 0;
+        if(ok) {
+            port = listen.mid(portSeparator + 1).toUShort(&ok);
+            address = listen.left(portSeparator);
+            if(address.startsWith(QChar('[')) && address.endsWith(QChar(']'))) {
+                address = address.mid(1, address.size() - 2);
+            }
+        }
+        if(!ok || QHostAddress(address).isNull()) {
+            cerr << "Error: Specified address \"" << listenArgValue << "\" is not of the form \"IP address:port\"" << endl;
+            return 1;
+        }
+    }
+
+    MetricsExporter exporter;
+    if(m_args.url.occurrences() > 1 || m_args.inventory.isPresent()) {
+        vector<InstanceTarget> targets;
+        if(!readInstanceTargets(targets)) {
+            return 1;
+        }
+        for(const InstanceTarget &target : targets) {
+            SyncthingConnectionSettings settings(m_settings);
+            settings.syncthingUrl = target.url;
+            if(!target.apiKey.isEmpty()) {
+                settings.apiKey = target.apiKey.toUtf8();
+            }
+            if(!target.certificate.isEmpty() && target.certificate != m_settings.httpsCertPath) {
+                settings.httpsCertPath = target.certificate;
+                if(!settings.loadHttpsCert()) {
+                    cerr << "Error: Unable to load certificate \"" << target.certificate.toLocal8Bit().data() << "\"" << endl;
+                    return -3;
+                }
+            }
+            exporter.addTarget(settings);
+        }
+    } else {
+        exporter.addTarget(m_settings);
+    }
+    if(!exporter.listen(QHostAddress(address), port)) {
+        cerr << "Error: Unable to listen on " << address.toLocal8Bit().data() << ':' << port << ": " << exporter.errorString().toLocal8Bit().data() << endl;
+        return 1;
+    }
+    const bool ipv6 = QHostAddress(address).protocol() == QAbstractSocket::IPv6Protocol;
+    cerr << "Serving metrics on http://" << (ipv6 ? "[" : "") << address.toLocal8Bit().data() << (ipv6 ? "]" : "") << ':' << port << "/metrics" << endl;
+    return QCoreApplication::exec();
+}
+
+/*!
+ * \brief Forwards the status request or the commands to a running Syncthing Tray instance.
+ * \returns Returns whether the request could be handled by the tray. In this case \a exitCode is set to the exit code
+ *          which would have been used when handling the request directly.
+ */
+bool Application::delegateToTray(int &exitCode)
+{
+    QJsonObject request, response;
+    request.insert(QStringLiteral("url"), m_settings.syncthingUrl);
+
+    // forward all commands at once so either all or none of them are handled by the tray
+    QJsonArray commands;
+    const auto addCommand = [&commands](const char *command, const Argument &arg, bool takesIds) {
+        if(!arg.isPresent()) {
+            return;
+        }
+        QJsonObject commandObject;
+        commandObject.insert(QStringLiteral("command"), QString::fromLatin1(command));
+        if(takesIds) {
+            QJsonArray ids;
+            for(size_t i = 0; i != arg.occurrences(); ++i) {
+                for(const char *value : arg.values(i)) {
+                    ids.append(argToQString(value));
+                }
+            }
+            commandObject.insert(QStringLiteral("ids"), ids);
+        }
+        commands.append(commandObject);
+    };
+    addCommand("rescan", m_args.rescan, true);
+    addCommand("rescan-all", m_args.rescanAll, false);
+    addCommand("pause", m_args.pause, true);
+    addCommand("pause-all", m_args.pauseAll, false);
+    addCommand("resume", m_args.resume, true);
+    addCommand("resume-all", m_args.resumeAll, false);
+
+    if(m_args.status.isPresent()) {
+        if(!commands.isEmpty()
+                || querySyncthingTray(SyncthingIpcRequest::StatusSnapshot, request, response) != SyncthingIpcResult::Ok
+                || !m_connection.restoreSnapshot(response)) {
+            return false;
+        }
+        m_args.parser.invokeCallbacks();
+        exitCode = 0;
+        return true;
+    }
+    if(commands.isEmpty()) {
+        return false;
+    }
+
+    request.insert(QStringLiteral("commands"), commands);
+    switch(querySyncthingTray(SyncthingIpcRequest::Command, request, response)) {
+    case SyncthingIpcResult::Ok:
+        exitCode = 0;
+        break;
+    case SyncthingIpcResult::CommandFailed:
+        exitCode = -3;
+        break;
+    default:
+        return false;
+    }
+    for(const QJsonValue &resultValue : response.value(QStringLiteral("results")).toArray()) {
+        const QJsonObject result(resultValue.toObject());
+        const QString error(result.value(QStringLiteral("error")).toString());
+        if(!error.isEmpty()) {
+            cerr << "Error: Unable to " << result.value(QStringLiteral("command")).toString().toLocal8Bit().data()
+                 << ' ' << result.value(QStringLiteral("id")).toString().toLocal8Bit().data() << ": " << error.toLocal8Bit().data() << '\n';
+        }
+    }
+    cerr << "Forwarded request to Syncthing Tray" << endl;
+    return true;
+}
+
 void Application::handleStatusChanged(SyncthingStatus newStatus)
 {
     Q_UNUSED(newStatus)
     if(m_connection.isConnected()) {
-        eraseLine(cout);
-        cout << '\r';
+        // erase the "Connecting to ..." line (printed to stderr so stdout is not cluttered)
+        eraseLine(cerr);
+        cerr << '\r';
+        // the callbacks must only be invoked once (and not on every further status change)
+        disconnect(&m_connection, &SyncthingConnection::statusChanged, this, &Application::handleStatusChanged);
         m_args.parser.invokeCallbacks();
-        if(!m_args.waitForIdle.isPresent()) {
+        if(!m_args.waitForIdle.isPresent() && !m_args.events.isPresent() && !m_args.watch.isPresent()) {
             m_connection.disconnect();
         }
     }
@@ -188,14 +497,65 @@ void Application::handleResponse()
 
 void Application::handleError(const QString &message)
 {
-    eraseLine(cout);
+    // restore the terminal so the error is visible
+    m_dashboard.reset();
+    eraseLine(cerr);
     cerr << "\rError: " << message.toLocal8Bit().data() << endl;
     QCoreApplication::exit(-3);
 }
 
+bool Application::initLogFilters()
+{
+    if(const char *sinceArgValue = m_args.since.firstValue()) {
+        // accept a duration (eg. "10m") or an ISO 8601 time, Syncthing expects the time in RFC 3339 format
+        const QString since(QString::fromLocal8Bit(sinceArgValue));
+        QDateTime sinceTime;
+        static const char units[] = "smhd";
+        static const int unitSeconds[] = { 1, 60, 60 * 60, 24 * 60 * 60 };
+        const char *const unit = since.isEmpty() ? nullptr : strchr(units, since.at(since.size() - 1).toLatin1());
+        bool ok = false;
+        if(unit && *unit) {
+            const int amount = since.left(since.size() - 1).toInt(&ok);
+            if(ok && amount >= 0) {
+                sinceTime = QDateTime::currentDateTimeUtc().addSecs(-static_cast<qint64>(amount) * unitSeconds[unit - units]);
+            }
+        } else {
+            sinceTime = QDateTime::fromString(since, Qt::ISODate);
+        }
+        if(!sinceTime.isValid()) {
+            cerr << "Error: Specified time \"" << sinceArgValue << "\" is neither an ISO 8601 time nor a duration" << endl;
+            return false;
+        }
+        m_logSince = sinceTime.toUTC().toString(Qt::ISODate);
+    }
+    if(const char *levelArgValue = m_args.level.firstValue()) {
+        // levels as used by Syncthing's logger
+        static const char *const levelNames[] = { "debug", "verbose", "info", "warning" };
+        m_minLogLevel = !strcmp(levelArgValue, "warn") ? 3 : -1;
+        for(int i = 0; i != 4; ++i) {
+            if(!strcmp(levelArgValue, levelNames[i])) {
+                m_minLogLevel = i;
+            }
+        }
+        if(m_minLogLevel < 0) {
+            cerr << "Error: Specified log level \"" << levelArgValue << "\" is invalid, use debug, verbose, info or warning" << endl;
+            return false;
+        }
+    }
+    if(const char *filterArgValue = m_args.filter.firstValue()) {
+        m_logFilter.setPattern(QString::fromLocal8Bit(filterArgValue));
+        if(!m_logFilter.isValid()) {
+            cerr << "Error: Specified filter \"" << filterArgValue << "\" is invalid: " << m_logFilter.errorString().toLocal8Bit().data() << endl;
+            return false;
+        }
+        m_logFilter.optimize();
+    }
+    return true;
+}
+
 void Application::requestLog(const ArgumentOccurrence &)
 {
-    m_connection.requestLog(bind(&Application::printLog, this, _1));
+    m_connection.requestLog(bind(&Application::printLog, this, _1), m_logSince);
     cerr << "Request log from " << m_settings.syncthingUrl.toLocal8Bit().data() << " ...";
     cerr.flush();
 }
@@ -216,15 +576,80 @@ void Application::requestRestart(const ArgumentOccurrence &)
     cerr.flush();
 }
 
+/*!
+ * \brief Returns whether the specified value of the rescan argument is a local path rather than a directory ID.
+ */
+static bool isPathValue(const char *value)
+{
+    return !strcmp(value, ".") || !strcmp(value, "..") || strchr(value, '/')
+#ifdef PLATFORM_WINDOWS
+            || strchr(value, '\\')
+#endif
+            ;
+}
+
+bool Application::isRescanningPaths() const
+{
+    if(!m_args.rescan.isPresent()) {
+        return false;
+    }
+    if(m_args.path.isPresent()) {
+        return true;
+    }
+    for(const char *value : m_args.rescan.values()) {
+        if(isPathValue(value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Application::requestRescan(const ArgumentOccurrence &occurrence)
 {
-    m_expectedResponse = occurrence.values.size();
+    m_expectedResponse = 0;
     connect(&m_connection, &SyncthingConnection::rescanTriggered, this, &Application::handleResponse);
     for(const char *value : occurrence.values) {
-        cerr << "Request rescanning " << value << " ...\n";
-        m_connection.rescan(argToQString(value));
+        if(isPathValue(value)) {
+            requestRescanPath(value);
+        } else {
+            cerr << "Request rescanning " << value << " ...\n";
+            ++m_expectedResponse;
+            m_connection.rescan(argToQString(value));
+        }
+    }
+    for(size_t i = 0; i != m_args.path.occurrences(); ++i) {
+        for(const char *value : m_args.path.values(i)) {
+            requestRescanPath(value);
+        }
     }
     cerr.flush();
+    if(!m_expectedResponse) {
+        // the connection has been established to look up the paths (otherwise there is at least one dir ID)
+        cerr << "Error: None of the specified paths is within a Syncthing directory" << endl;
+        QCoreApplication::exit(1);
+    }
+}
+
+/*!
+ * \brief Requests rescanning only the specified \a path within the directory containing it.
+ * \remarks Requires the connection to be established so the directories are known.
+ */
+void Application::requestRescanPath(const char *path)
+{
+    QString relativePath;
+    int row;
+    const SyncthingDir *const dir = m_connection.findDirInfoByPath(QFileInfo(fromNativeFileName(path)).absoluteFilePath(), relativePath, row);
+    if(!dir) {
+        cerr << "Warning: Specified path \"" << path << "\" is not within any Syncthing directory and will be ignored\n";
+        return;
+    }
+    cerr << "Request rescanning " << dir->id.toLocal8Bit().data();
+    if(!relativePath.isEmpty()) {
+        cerr << " (" << relativePath.toLocal8Bit().data() << ')';
+    }
+    cerr << " ...\n";
+    ++m_expectedResponse;
+    m_connection.rescan(dir->id, relativePath);
 }
 
 void Application::requestRescanAll(const ArgumentOccurrence &)
@@ -275,6 +700,10 @@ void Application::requestResumeAll(const ArgumentOccurrence &)
 
 void Application::findRelevantDirsAndDevs()
 {
+    // pointers to previous dirs/devs might be dangling
+    m_relevantDirs.clear();
+    m_relevantDevs.clear();
+
     int dummy;
     if(m_args.dir.isPresent()) {
         m_relevantDirs.reserve(m_args.dir.occurrences());
@@ -315,6 +744,11 @@ void Application::findRelevantDirsAndDevs()
 void Application::printStatus(const ArgumentOccurrence &)
 {
     findRelevantDirsAndDevs();
+    if(m_args.json.isPresent()) {
+        printStatusAsJson();
+        QCoreApplication::exit();
+        return;
+    }
 
     // display dirs
     if(!m_relevantDirs.empty()) {
@@ -328,24 +762,7 @@ void Application::printStatus(const ArgumentOccurrence &)
             setStyle(cout);
             printProperty("Label", dir->label);
             printProperty("Path", dir->path);
-            const char *status;
-            switch(dir->status) {
-            case SyncthingDirStatus::Idle:
-                status = "idle"; break;
-            case SyncthingDirStatus::Unshared:
-                status = "unshared"; break;
-            case SyncthingDirStatus::Scanning:
-                status = "scanning"; break;
-            case SyncthingDirStatus::Synchronizing:
-                status = "synchronizing"; break;
-            case SyncthingDirStatus::Paused:
-                status = "paused"; break;
-            case SyncthingDirStatus::OutOfSync:
-                status = "out of sync"; break;
-            default:
-                status = "unknown";
-            }
-            printProperty("Status", status);
+            printProperty("Status", dirStatusString(*dir));
             printProperty("Last scan time", dir->lastScanTime);
             printProperty("Last file time", dir->lastFileTime);
             printProperty("Last file name", dir->lastFileName);
@@ -378,28 +795,7 @@ void Application::printStatus(const ArgumentOccurrence &)
             cout << dev->name.toLocal8Bit().data() << '\n';
             setStyle(cout);
             printProperty("ID", dev->id);
-            const char *status;
-            if(dev->paused) {
-                status = "paused";
-            } else {
-                switch(dev->status) {
-                case SyncthingDevStatus::Disconnected:
-                    status = "disconnected"; break;
-                case SyncthingDevStatus::OwnDevice:
-                    status = "own device"; break;
-                case SyncthingDevStatus::Idle:
-                    status = "idle"; break;
-                case SyncthingDevStatus::Synchronizing:
-                    status = "synchronizing"; break;
-                case SyncthingDevStatus::OutOfSync:
-                    status = "out of sync"; break;
-                case SyncthingDevStatus::Rejected:
-                    status = "rejected"; break;
-                default:
-                    status = "unknown";
-                }
-            }
-            printProperty("Status", status);
+            printProperty("Status", devStatusString(*dev));
             printProperty("Addresses", dev->addresses);
             printProperty("Compression", dev->compression);
             printProperty("Cert name", dev->certName);
@@ -421,18 +817,136 @@ void Application::printStatus(const ArgumentOccurrence &)
     QCoreApplication::exit();
 }
 
+void Application::printStatusAsJson()
+{
+    JsonWriter writer(cout);
+    writer.beginObject();
+    writer.key("dirs").beginArray();
+    for(const SyncthingDir *dir : m_relevantDirs) {
+        writer.beginObject();
+        writer.property("id", dir->id);
+        writer.property("label", dir->label);
+        writer.property("path", dir->path);
+        writer.property("status", dirStatusString(*dir));
+        writer.property("progressPercentage", dir->progressPercentage);
+        writer.property("lastScanTime", dir->lastScanTime);
+        writer.property("lastFileTime", dir->lastFileTime);
+        writer.property("lastFileName", dir->lastFileName);
+        writer.property("lastFileDeleted", dir->lastFileDeleted);
+        writer.property("downloadProgress", dir->downloadLabel);
+        writer.property("devices", dir->devices);
+        writer.property("readOnly", dir->readOnly);
+        writer.property("ignorePermissions", dir->ignorePermissions);
+        writer.property("autoNormalize", dir->autoNormalize);
+        writer.property("rescanInterval", dir->rescanInterval);
+        writer.property("minDiskFreePercentage", dir->minDiskFreePercentage);
+        writer.property("globalBytes", dir->globalBytes);
+        writer.property("globalFiles", dir->globalFiles);
+        writer.property("localBytes", dir->localBytes);
+        writer.property("localFiles", dir->localFiles);
+        writer.property("neededBytes", dir->neededByted);
+        writer.property("neededFiles", dir->neededFiles);
+        writer.key("errors").beginArray();
+        for(const SyncthingDirError &error : dir->errors) {
+            writer.beginObject().property("message", error.message).property("path", error.path).endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.key("devs").beginArray();
+    for(const SyncthingDev *dev : m_relevantDevs) {
+        writer.beginObject();
+        writer.property("id", dev->id);
+        writer.property("name", dev->name);
+        writer.property("status", devStatusString(*dev));
+        writer.property("paused", dev->paused);
+        writer.property("introducer", dev->introducer);
+        writer.property("addresses", dev->addresses);
+        writer.property("compression", dev->compression);
+        writer.property("certName", dev->certName);
+        writer.property("connectionAddress", dev->connectionAddress);
+        writer.property("connectionType", dev->connectionType);
+        writer.property("clientVersion", dev->clientVersion);
+        writer.property("lastSeen", dev->lastSeen);
+        writer.property("totalIncomingTraffic", dev->totalIncomingTraffic);
+        writer.property("totalOutgoingTraffic", dev->totalOutgoingTraffic);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+    writer.endLine();
+}
+
 void Application::printLog(const std::vector<SyncthingLogEntry> &logEntries)
 {
-    eraseLine(cout);
-    cout << '\r';
+    if(!m_followingLog) {
+        eraseLine(cerr);
+        cerr << '\r';
+    }
 
+    const bool json = m_args.json.isPresent();
+    const bool filtering = !m_logFilter.pattern().isEmpty();
+    JsonWriter writer(cout);
     for(const SyncthingLogEntry &entry : logEntries) {
-        cout << DateTime::fromIsoStringLocal(entry.when.toLocal8Bit().data()).toString(DateTimeOutputFormat::DateAndTime, true).data() << ':' << ' ' << entry.message.toLocal8Bit().data() << '\n';
+        // apply filters before formatting anything, entries without level (older Syncthing versions) are kept
+        if((entry.level >= 0 && entry.level < m_minLogLevel) || (filtering && !m_logFilter.match(entry.message).hasMatch())) {
+            continue;
+        }
+        if(json) {
+            writer.beginObject().property("when", entry.when).property("message", entry.message);
+            if(entry.level >= 0) {
+                writer.property("level", entry.level);
+            }
+            writer.endObject();
+            writer.endLine();
+        } else {
+            cout << DateTime::fromIsoStringLocal(entry.when.toLocal8Bit().data()).toString(DateTimeOutputFormat::DateAndTime, true).data() << ':' << ' ' << entry.message.toLocal8Bit().data() << '\n';
+        }
     }
     cout.flush();
+
+    // continue after the last entry when following (only that time is kept so memory usage is constant)
+    if(!logEntries.empty()) {
+        m_logSince = logEntries.back().when;
+    }
+    if(m_args.follow.isPresent()) {
+        m_followingLog = true;
+        m_logPollTimer.start();
+        return;
+    }
     QCoreApplication::exit();
 }
 
+void Application::requestNewLogEntries()
+{
+    m_connection.requestLog(bind(&Application::printLog, this, _1), m_logSince);
+}
+
+bool Application::initWaitForIdleTimers()
+{
+    bool ok = true;
+    if(const char *timeoutArgValue = m_args.timeout.firstValue()) {
+        const int timeout = QByteArray(timeoutArgValue).toInt(&ok);
+        if(!ok || timeout <= 0) {
+            cerr << "Error: Specified timeout \"" << timeoutArgValue << "\" is not a positive number of milliseconds" << endl;
+            return false;
+        }
+        m_waitTimeoutTimer.start(timeout);
+    }
+    if(const char *idleDurationArgValue = m_args.idleDuration.firstValue()) {
+        const int idleDuration = QByteArray(idleDurationArgValue).toInt(&ok);
+        if(!ok || idleDuration < 0) {
+            cerr << "Error: Specified idle duration \"" << idleDurationArgValue << "\" is not a number of milliseconds" << endl;
+            return false;
+        }
+        m_idleTimer.setInterval(idleDuration);
+    } else {
+        m_idleTimer.setInterval(0);
+    }
+    return true;
+}
+
 void Application::initWaitForIdle(const ArgumentOccurrence &)
 {
     findRelevantDirsAndDevs();
@@ -449,16 +963,22 @@ void Application::initWaitForIdle(const ArgumentOccurrence &)
     connect(&m_connection, &SyncthingConnection::devStatusChanged, this, &Application::waitForIdle);
 }
 
-void Application::waitForIdle()
+QString Application::busyDirsAndDevs() const
 {
+    QStringList busy;
     for(const SyncthingDir *dir : m_relevantDirs) {
         switch(dir->status) {
         case SyncthingDirStatus::Unknown:
         case SyncthingDirStatus::Idle:
         case SyncthingDirStatus::Unshared:
             break;
+        case SyncthingDirStatus::Synchronizing:
+            busy << (dir->progressPercentage > 0
+                     ? QStringLiteral("%1 (synchronizing, %2 %)").arg(dir->displayName()).arg(dir->progressPercentage)
+                     : QStringLiteral("%1 (synchronizing)").arg(dir->displayName()));
+            break;
         default:
-            return;
+            busy << QStringLiteral("%1 (%2)").arg(dir->displayName(), QString::fromLatin1(dirStatusString(*dir)));
         }
     }
     for(const SyncthingDev *dev : m_relevantDevs) {
@@ -469,10 +989,205 @@ void Application::waitForIdle()
         case SyncthingDevStatus::Idle:
             break;
         default:
-            return;
+            busy << QStringLiteral("%1 (%2)").arg(dev->name.isEmpty() ? dev->id : dev->name, QString::fromLatin1(devStatusString(*dev)));
+        }
+    }
+    return busy.join(QStringLiteral(", "));
+}
+
+void Application::waitForIdle()
+{
+    const QString busy(busyDirsAndDevs());
+    if(!busy.isEmpty()) {
+        // restart the quiet period when idling again
+        m_idleTimer.stop();
+        if(busy != m_lastWaitProgress) {
+            cerr << "Waiting for " << (m_lastWaitProgress = busy).toLocal8Bit().data() << endl;
         }
+        return;
+    }
+    if(m_idleTimer.interval() <= 0) {
+        QCoreApplication::exit();
+        return;
+    }
+    if(!m_idleTimer.isActive()) {
+        m_lastWaitProgress.clear();
+        cerr << "Idling, ensuring nothing happens within " << m_idleTimer.interval() << " ms ..." << endl;
+        m_idleTimer.start();
+    }
+}
+
+void Application::handleWaitForIdleTimeout()
+{
+    eraseLine(cerr);
+    cerr << "\rError: Timeout exceeded";
+    if(m_connection.isConnected()) {
+        const QString busy(busyDirsAndDevs());
+        if(!busy.isEmpty()) {
+            cerr << ", still waiting for " << busy.toLocal8Bit().data();
+        }
+    } else {
+        cerr << " before the connection could be established";
+    }
+    cerr << endl;
+    QCoreApplication::exit(-5);
+}
+
+void Application::initEvents(const ArgumentOccurrence &)
+{
+    if(m_eventRecorder) {
+        connect(&m_connection, &SyncthingConnection::newEvents, m_eventRecorder.get(), &EventRecorder::record);
+        connect(m_eventRecorder.get(), &EventRecorder::failed, this, [] {
+            QCoreApplication::exit(1);
+        });
+        cerr << "Recording events to " << m_args.record.firstValue() << " ..." << endl;
+    } else {
+        connect(&m_connection, &SyncthingConnection::newEvents, this, &Application::printEvents);
+        cerr << "Waiting for events ..." << endl;
+    }
+    if(m_eventsDuration > 0) {
+        QTimer::singleShot(m_eventsDuration, &QCoreApplication::quit);
+    }
+}
+
+void Application::initWatch(const ArgumentOccurrence &)
+{
+    m_dashboard.reset(new Dashboard(m_connection));
+    m_dashboard->start();
+}
+
+/*!
+ * \brief Reads the positive number specified via \a arg into \a value if \a arg is present.
+ */
+static bool readPositiveNumber(const ConfigValueArgument &arg, int &value)
+{
+    const char *const argValue = arg.firstValue();
+    if(!argValue) {
+        return true;
+    }
+    bool ok;
+    value = QByteArray(argValue).toInt(&ok);
+    if(!ok || value <= 0) {
+        cerr << "Error: Value \"" << argValue << "\" specified for --" << arg.name() << " is not a positive number" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool Application::initBenchmark()
+{
+    // request what is requested when connecting by default
+    QStringList endpoints;
+    if(m_args.endpoints.isPresent()) {
+        for(size_t i = 0; i != m_args.endpoints.occurrences(); ++i) {
+            for(const char *value : m_args.endpoints.values(i)) {
+                endpoints << QString::fromLocal8Bit(value);
+            }
+        }
+    } else {
+        endpoints << QStringLiteral("system/config") << QStringLiteral("system/status") << QStringLiteral("system/connections")
+                  << QStringLiteral("stats/folder") << QStringLiteral("stats/device") << QStringLiteral("system/error");
+    }
+    if(endpoints.isEmpty()) {
+        cerr << "Error: No endpoints specified" << endl;
+        return false;
+    }
+    int iterations = 100, duration = 0, concurrency = 4;
+    if(!readPositiveNumber(m_args.iterations, iterations) || !readPositiveNumber(m_args.duration, duration)
+            || !readPositiveNumber(m_args.concurrency, concurrency)) {
+        return false;
+    }
+    m_benchmark.reset(new Benchmark(m_connection, endpoints));
+    m_benchmark->setIterations(iterations);
+    m_benchmark->setDuration(duration);
+    m_benchmark->setConcurrency(concurrency);
+    connect(m_benchmark.get(), &Benchmark::finished, this, &Application::printBenchmarkResults);
+    return true;
+}
+
+bool Application::initEventRecording()
+{
+    if(!readPositiveNumber(m_args.duration, m_eventsDuration)) {
+        return false;
+    }
+    if(m_args.types.isPresent()) {
+        QStringList types;
+        for(size_t i = 0; i != m_args.types.occurrences(); ++i) {
+            for(const char *value : m_args.types.values(i)) {
+                types << QString::fromLocal8Bit(value);
+            }
+        }
+        m_connection.setEventTypes(types);
+    }
+    const char *const recordArgValue = m_args.record.firstValue();
+    if(!recordArgValue) {
+        return true;
+    }
+    int rotationSize = 0;
+    if(!readPositiveNumber(m_args.rotateSize, rotationSize)) {
+        return false;
+    }
+    m_eventRecorder.reset(new EventRecorder(fromNativeFileName(recordArgValue), static_cast<qint64>(rotationSize) * 1024 * 1024));
+    if(!m_eventRecorder->open()) {
+        cerr << "Error: Unable to open \"" << recordArgValue << "\": " << m_eventRecorder->errorString().toLocal8Bit().data() << endl;
+        return false;
+    }
+    return true;
+}
+
+int Application::printEventStatistics()
+{
+    const char *const statsArgValue = m_args.stats.firstValue();
+    EventStatistics statistics;
+    QString errorMessage;
+    if(!statistics.read(fromNativeFileName(statsArgValue), errorMessage)) {
+        cerr << "Error: Unable to read \"" << statsArgValue << "\": " << errorMessage.toLocal8Bit().data() << endl;
+        return 1;
+    }
+    if(m_args.json.isPresent()) {
+        JsonWriter writer(cout);
+        statistics.print(writer);
+    } else {
+        statistics.print(cout);
+    }
+    return 0;
+}
+
+void Application::runBenchmark(const ArgumentOccurrence &)
+{
+    cerr << "Benchmarking " << m_settings.syncthingUrl.toLocal8Bit().data() << " ..." << endl;
+    m_benchmark->start();
+}
+
+void Application::printBenchmarkResults()
+{
+    if(m_args.json.isPresent()) {
+        JsonWriter writer(cout);
+        m_benchmark->printResults(writer);
+    } else {
+        m_benchmark->printResults(cout);
     }
     QCoreApplication::exit();
 }
 
+void Application::printEvents(const QJsonArray &events)
+{
+    JsonWriter writer(cout);
+    if(m_args.json.isPresent()) {
+        for(const QJsonValue &event : events) {
+            writer.value(event);
+            writer.endLine();
+        }
+        return;
+    }
+    for(const QJsonValue &eventVal : events) {
+        const QJsonObject event(eventVal.toObject());
+        cout << event.value(QStringLiteral("time")).toString().toLocal8Bit().data() << ' '
+             << event.value(QStringLiteral("type")).toString().toLocal8Bit().data()
+             << " (" << event.value(QStringLiteral("id")).toInt() << "): ";
+        writer.value(event.value(QStringLiteral("data")));
+        writer.endLine();
+    }
+}
+
 } // namespace Cli
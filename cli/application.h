@@ -2,12 +2,19 @@
 #define CLI_APPLICATION_H
 
 #include "./args.h"
+#include "./benchmark.h"
+#include "./dashboard.h"
+#include "./eventrecorder.h"
+#include "./instancerunner.h"
 
 #include "../connector/syncthingconnection.h"
 #include "../connector/syncthingconnectionsettings.h"
 
 #include <QObject>
+#include <QRegularExpression>
+#include <QTimer>
 
+#include <memory>
 #include <tuple>
 
 namespace Cli {
@@ -27,21 +34,41 @@ private slots:
     void handleResponse();
     void handleError(const QString &message);
     void findRelevantDirsAndDevs();
+    void waitForIdle();
+    void handleWaitForIdleTimeout();
+    void printEvents(const QJsonArray &events);
+    void requestNewLogEntries();
+    void printBenchmarkResults();
 
 private:
+    bool readInstanceTargets(std::vector<InstanceTarget> &targets);
+    int runOnMultipleInstances(int argc, const char *const *argv);
+    int serveMetrics();
+    bool delegateToTray(int &exitCode);
+    bool initLogFilters();
+    bool initBenchmark();
+    bool initEventRecording();
+    int printEventStatistics();
     void requestLog(const ArgumentOccurrence &);
     void requestShutdown(const ArgumentOccurrence &);
     void requestRestart(const ArgumentOccurrence &);
+    bool isRescanningPaths() const;
     void requestRescan(const ArgumentOccurrence &occurrence);
+    void requestRescanPath(const char *path);
     void requestRescanAll(const ArgumentOccurrence &);
     void requestPause(const ArgumentOccurrence &occurrence);
     void requestPauseAll(const ArgumentOccurrence &);
     void requestResume(const ArgumentOccurrence &);
     void requestResumeAll(const ArgumentOccurrence &);
     void printStatus(const ArgumentOccurrence &);
+    void printStatusAsJson();
     void printLog(const std::vector<Data::SyncthingLogEntry> &logEntries);
+    bool initWaitForIdleTimers();
     void initWaitForIdle(const ArgumentOccurrence &);
-    void waitForIdle();
+    QString busyDirsAndDevs() const;
+    void initEvents(const ArgumentOccurrence &);
+    void initWatch(const ArgumentOccurrence &);
+    void runBenchmark(const ArgumentOccurrence &);
 
     Args m_args;
     Data::SyncthingConnectionSettings m_settings;
@@ -49,7 +76,18 @@ private:
     size_t m_expectedResponse;
     std::vector<const Data::SyncthingDir *> m_relevantDirs;
     std::vector<const Data::SyncthingDev *> m_relevantDevs;
-
+    QTimer m_idleTimer;
+    QTimer m_waitTimeoutTimer;
+    QString m_lastWaitProgress;
+    std::unique_ptr<Dashboard> m_dashboard;
+    QString m_logSince;
+    int m_minLogLevel;
+    QRegularExpression m_logFilter;
+    QTimer m_logPollTimer;
+    bool m_followingLog;
+    std::unique_ptr<Benchmark> m_benchmark;
+    std::unique_ptr<EventRecorder> m_eventRecorder;
+    int m_eventsDuration;
 };
 
 } // namespace Cli
@@ -8,24 +8,57 @@ Args::Args() :
     log("log", 'l', "shows the Syncthing log"),
     stop("stop", '\0', "stops Syncthing"),
     restart("restart", '\0', "restarts Syncthing"),
-    rescan("rescan", 'r', "rescans the specified directories"),
+    rescan("rescan", 'r', "rescans the specified directories (values like \".\" or \"./file\" are treated as paths, see --path)"),
     rescanAll("rescan-all", '\0', "rescans all directories"),
     pause("pause", '\0', "pauses the specified devices"),
     pauseAll("pause-all", '\0', "pauses all devices"),
     resume("resume", '\0', "resumes the specified devices"),
     resumeAll("resume-all", '\0', "resumes all devices"),
     waitForIdle("wait-for-idle", 'w', "waits until the specified dirs/devs are idling"),
+    events("events", '\0', "prints Syncthing events as they occur until interrupted"),
+    watch("watch", '\0', "shows a live overview of all dirs and devs until interrupted"),
+    bench("bench", '\0', "measures the latency of REST API requests"),
+    serveMetrics("serve-metrics", '\0', "serves metrics about the Syncthing instance(s) in the Prometheus text format until interrupted"),
     dir("dir", 'd', "specifies the directory to display status info for (default is all dirs)", {"ID"}),
     dev("dev", '\0', "specifies the device to display status info for (default is all devs)", {"ID"}),
+    path("path", '\0', "specifies local files or directories to rescan; the containing directories are looked up by path and only the specified paths are rescanned", {"path"}),
+    timeout("timeout", '\0', "specifies how long to wait at most (including establishing the connection), default is no timeout", {"ms"}),
+    idleDuration("idle-duration", '\0', "specifies how long the dirs/devs need to be idling without interruption, default is 0", {"ms"}),
+    follow("follow", '\0', "keeps printing new log entries as they are logged until interrupted"),
+    since("since", '\0', "only shows log entries logged after the specified time (ISO 8601) or within the specified duration (eg. 30s, 10m, 2h or 1d)", {"time"}),
+    level("level", '\0', "only shows log entries with at least the specified level (debug, verbose, info or warning)", {"level"}),
+    filter("filter", '\0', "only shows log entries with a message matching the specified regular expression", {"regex"}),
+    endpoints("endpoints", '\0', "specifies the REST API paths to request (eg. system/status or db/status?folder=ID), default is the requests made when connecting", {"path"}),
+    iterations("iterations", '\0', "specifies the number of requests per endpoint, default is 100", {"number"}),
+    duration("duration", '\0', "specifies for how long requests are sent (instead of a fixed number of requests) or events are received", {"ms"}),
+    concurrency("concurrency", '\0', "specifies the number of requests pending at the same time, default is 4", {"number"}),
+    listen("listen", '\0', "specifies the address to serve metrics on, default is 127.0.0.1:9494", {"address:port"}),
+    record("record", '\0', "appends the events to the specified file (as newline-delimited JSON) instead of printing them", {"path"}),
+    stats("stats", '\0', "prints statistics about the events recorded in the specified file (see --record)", {"path"}),
+    types("types", '\0', "specifies the types of events to receive (default is all types)", {"type"}),
+    rotateSize("rotate-size", '\0', "starts a new file when the recorded file exceeds the specified size, the previous 5 files are kept", {"MiB"}),
     configFile("config-file", 'f', "specifies the Syncthing config file", {"path"}),
     apiKey("api-key", 'k', "specifies the API key", {"key"}),
-    url("url", 'u', "specifies the Syncthing URL, default is http://localhost:8080", {"URL"}),
+    url("url", 'u', "specifies the Syncthing URL (can be specified multiple times to run the command against multiple instances), use unix:///path/to/socket for a GUI listening on a Unix domain socket; default is http://localhost:8080", {"URL"}),
     credentials("credentials", 'c', "specifies user name and password", {"user name", "password"}),
-    certificate("cert", '\0', "specifies the certificate used by the Syncthing instance", {"path"})
+    certificate("cert", '\0', "specifies the certificate used by the Syncthing instance", {"path"}),
+    noTray("no-tray", '\0', "always uses the REST API instead of querying a running Syncthing Tray instance first"),
+    json("json", '\0', "prints JSON (status) or newline-delimited JSON (log, events) instead of human-readable text"),
+    inventory("inventory", '\0', "runs the command against all instances listed in the specified file (one \"URL [API key [cert path]]\" per line)", {"path"}),
+    maxParallel("max-parallel", '\0', "specifies how many instances are queried at the same time when running against multiple instances, default is 16", {"number"})
 {
     dir.setConstraints(0, -1), dev.setConstraints(0, -1);
+    url.setConstraints(0, -1);
+    path.setRequiredValueCount(-1);
     status.setSubArguments({&dir, &dev});
-    waitForIdle.setSubArguments({&dir, &dev});
+    log.setSubArguments({&follow, &since, &level, &filter});
+    rescan.setSubArguments({&path});
+    endpoints.setRequiredValueCount(-1);
+    bench.setSubArguments({&endpoints, &iterations, &duration, &concurrency});
+    serveMetrics.setSubArguments({&listen});
+    types.setRequiredValueCount(-1);
+    events.setSubArguments({&record, &stats, &types, &duration, &rotateSize});
+    waitForIdle.setSubArguments({&dir, &dev, &timeout, &idleDuration});
 
     rescan.setValueNames({"dir ID"});
     rescan.setRequiredValueCount(-1);
@@ -35,7 +68,7 @@ Args::Args() :
     resume.setRequiredValueCount(-1);
 
     parser.setMainArguments({&status, &log, &stop, &restart, &rescan, &rescanAll, &pause, &pauseAll, &resume, &resumeAll,
-                             &waitForIdle, &configFile, &apiKey, &url, &credentials, &certificate, &help});
+                             &waitForIdle, &events, &watch, &bench, &serveMetrics, &configFile, &apiKey, &url, &credentials, &certificate, &noTray, &json, &inventory, &maxParallel, &help});
 
     // allow setting default values via environment
     configFile.setEnvironmentVariable("SYNCTHING_CTL_CONFIG_FILE");
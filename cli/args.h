@@ -12,9 +12,9 @@ struct Args
     Args();
     ArgumentParser parser;
     HelpArgument help;
-    OperationArgument status, log, stop, restart, rescan, rescanAll, pause, pauseAll, resume, resumeAll, waitForIdle;
-    ConfigValueArgument dir, dev;
-    ConfigValueArgument configFile, apiKey, url, credentials, certificate;
+    OperationArgument status, log, stop, restart, rescan, rescanAll, pause, pauseAll, resume, resumeAll, waitForIdle, events, watch, bench, serveMetrics;
+    ConfigValueArgument dir, dev, path, timeout, idleDuration, follow, since, level, filter, endpoints, iterations, duration, concurrency, listen, record, stats, types, rotateSize;
+    ConfigValueArgument configFile, apiKey, url, credentials, certificate, noTray, json, inventory, maxParallel;
 };
 
 } // namespace Cli
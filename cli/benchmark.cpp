@@ -0,0 +1,198 @@
+#include "./benchmark.h"
+#include "./jsonwriter.h"
+
+#include "../connector/syncthingconnection.h"
+
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QNetworkReply>
+#include <QUrlQuery>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace Data;
+
+namespace Cli {
+
+/*!
+ * \class Benchmark
+ * \brief The Benchmark class measures the latency of REST API requests (used by syncthingctl bench).
+ *
+ * Requests to the specified endpoints are sent in turns using the same code path as the connector uses internally.
+ * The specified number of requests is kept pending at the same time. The time until a reply has been received and
+ * the time required to parse it are recorded per endpoint.
+ */
+
+Benchmark::Benchmark(SyncthingConnection &connection, const QStringList &endpoints, QObject *parent) :
+    QObject(parent),
+    m_connection(connection),
+    m_wallTime(0),
+    m_iterations(100),
+    m_duration(0),
+    m_concurrency(4),
+    m_sent(0),
+    m_pending(0)
+{
+    m_endpoints.reserve(static_cast<size_t>(endpoints.size()));
+    for(const QString &endpoint : endpoints) {
+        m_endpoints.emplace_back();
+        EndpointStats &stats = m_endpoints.back();
+        const int querySeparator = endpoint.indexOf(QChar('?'));
+        stats.path = endpoint.mid(0, querySeparator);
+        if(querySeparator >= 0) {
+            stats.query = endpoint.mid(querySeparator + 1);
+        }
+    }
+}
+
+/*!
+ * \brief Starts sending requests.
+ * \remarks The finished() signal is emitted when all requests have been sent and all replies have been received.
+ */
+void Benchmark::start()
+{
+    m_clock.start();
+    for(int i = 0; i < m_concurrency && !isDone(); ++i) {
+        sendRequest();
+    }
+}
+
+bool Benchmark::isDone() const
+{
+    if(m_endpoints.empty()) {
+        return true;
+    }
+    return m_duration > 0 ? m_clock.elapsed() >= m_duration : m_sent >= m_iterations * static_cast<int>(m_endpoints.size());
+}
+
+void Benchmark::sendRequest()
+{
+    const size_t endpointIndex = static_cast<size_t>(m_sent++) % m_endpoints.size();
+    const EndpointStats &stats = m_endpoints[endpointIndex];
+    QNetworkReply *const reply = m_connection.requestRestData(stats.path, QUrlQuery(stats.query));
+    reply->setProperty("endpoint", static_cast<qulonglong>(endpointIndex));
+    reply->setProperty("start", m_clock.nsecsElapsed());
+    connect(reply, &QNetworkReply::finished, this, &Benchmark::readReply);
+    ++m_pending;
+}
+
+void Benchmark::readReply()
+{
+    auto *const reply = static_cast<QNetworkReply *>(sender());
+    const int64 latency = (m_clock.nsecsElapsed() - reply->property("start").toLongLong()) / 1000;
+    reply->deleteLater();
+    --m_pending;
+
+    EndpointStats &stats = m_endpoints[static_cast<size_t>(reply->property("endpoint").toULongLong())];
+    ++stats.requests;
+    if(reply->error() == QNetworkReply::NoError) {
+        const QByteArray response(reply->readAll());
+        QElapsedTimer parseTimer;
+        parseTimer.start();
+        QJsonParseError jsonError;
+        QJsonDocument::fromJson(response, &jsonError);
+        stats.parseTime += parseTimer.nsecsElapsed() / 1000;
+        stats.bytes += static_cast<uint64>(response.size());
+        if(jsonError.error == QJsonParseError::NoError) {
+            stats.latencies.emplace_back(latency);
+        } else {
+            ++stats.errors;
+        }
+    } else {
+        ++stats.errors;
+    }
+
+    if(!isDone()) {
+        sendRequest();
+    } else if(!m_pending) {
+        m_wallTime = m_clock.nsecsElapsed() / 1000;
+        for(EndpointStats &endpoint : m_endpoints) {
+            sort(endpoint.latencies.begin(), endpoint.latencies.end());
+        }
+        emit finished();
+    }
+}
+
+/*!
+ * \brief Returns the latency in milliseconds below which the specified \a percent of the latencies are.
+ */
+double Benchmark::percentile(const std::vector<int64> &sortedLatencies, int percent)
+{
+    if(sortedLatencies.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<size_t>(ceil(percent / 100.0 * static_cast<double>(sortedLatencies.size())));
+    return static_cast<double>(sortedLatencies[rank ? rank - 1 : 0]) / 1000.0;
+}
+
+/*!
+ * \brief Prints the results as table.
+ */
+void Benchmark::printResults(ostream &out) const
+{
+    const double wallTime = static_cast<double>(m_wallTime) / 1000000.0;
+    out << left << setw(28) << "Endpoint" << right << setw(9) << "Requests" << setw(8) << "Errors"
+        << setw(10) << "p50 ms" << setw(10) << "p90 ms" << setw(10) << "p99 ms" << setw(10) << "Req/s"
+        << setw(12) << "Bytes/req" << setw(10) << "Parse ms" << '\n';
+    out << fixed << setprecision(2);
+    for(const EndpointStats &stats : m_endpoints) {
+        const auto successful = stats.requests - stats.errors;
+        QString endpoint(stats.path);
+        if(!stats.query.isEmpty()) {
+            endpoint += QChar('?');
+            endpoint += stats.query;
+        }
+        out << left << setw(28) << endpoint.toLocal8Bit().data()
+            << right << setw(9) << stats.requests << setw(8) << stats.errors
+            << setw(10) << percentile(stats.latencies, 50) << setw(10) << percentile(stats.latencies, 90) << setw(10) << percentile(stats.latencies, 99)
+            << setw(10) << (wallTime > 0.0 ? stats.requests / wallTime : 0.0)
+            << setw(12) << (successful > 0 ? stats.bytes / static_cast<uint64>(successful) : 0)
+            << setw(10) << (successful > 0 ? static_cast<double>(stats.parseTime) / successful / 1000.0 : 0.0) << '\n';
+    }
+    out << "Total time: " << wallTime << " s, concurrency: " << m_concurrency << '\n';
+    out.flush();
+}
+
+/*!
+ * \brief Prints the results as JSON object.
+ * \remarks Latencies and parse times are in milliseconds, the throughput is in requests per second.
+ */
+void Benchmark::printResults(JsonWriter &writer) const
+{
+    const double wallTime = static_cast<double>(m_wallTime) / 1000000.0;
+    writer.beginObject();
+    writer.property("url", m_connection.syncthingUrl());
+    writer.property("concurrency", m_concurrency);
+    writer.property("totalTime", wallTime);
+    writer.key("endpoints").beginArray();
+    for(const EndpointStats &stats : m_endpoints) {
+        const auto successful = stats.requests - stats.errors;
+        writer.beginObject();
+        writer.property("path", stats.path);
+        writer.property("query", stats.query);
+        writer.property("requests", stats.requests);
+        writer.property("errors", stats.errors);
+        writer.property("throughput", wallTime > 0.0 ? stats.requests / wallTime : 0.0);
+        writer.property("bytes", stats.bytes);
+        writer.key("latency").beginObject();
+        writer.property("p50", percentile(stats.latencies, 50));
+        writer.property("p90", percentile(stats.latencies, 90));
+        writer.property("p99", percentile(stats.latencies, 99));
+        writer.property("max", stats.latencies.empty() ? 0.0 : static_cast<double>(stats.latencies.back()) / 1000.0);
+        writer.endObject();
+        writer.key("parseTime").beginObject();
+        writer.property("total", static_cast<double>(stats.parseTime) / 1000.0);
+        writer.property("mean", successful > 0 ? static_cast<double>(stats.parseTime) / successful / 1000.0 : 0.0);
+        writer.endObject();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+    writer.endLine();
+}
+
+} // namespace Cli
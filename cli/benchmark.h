@@ -0,0 +1,95 @@
+#ifndef SYNCTHINGCTL_BENCHMARK_H
+#define SYNCTHINGCTL_BENCHMARK_H
+
+#include <c++utilities/conversion/types.h>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+
+#include <iosfwd>
+#include <vector>
+
+namespace Data {
+class SyncthingConnection;
+}
+
+namespace Cli {
+
+class JsonWriter;
+
+class Benchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    Benchmark(Data::SyncthingConnection &connection, const QStringList &endpoints, QObject *parent = nullptr);
+
+    void setIterations(int iterations);
+    void setDuration(int duration);
+    void setConcurrency(int concurrency);
+    void start();
+    void printResults(std::ostream &out) const;
+    void printResults(JsonWriter &writer) const;
+
+signals:
+    void finished();
+
+private slots:
+    void readReply();
+
+private:
+    struct EndpointStats
+    {
+        QString path;
+        QString query;
+        std::vector<int64> latencies;
+        int64 parseTime = 0;
+        uint64 bytes = 0;
+        int requests = 0;
+        int errors = 0;
+    };
+
+    bool isDone() const;
+    void sendRequest();
+    static double percentile(const std::vector<int64> &sortedLatencies, int percent);
+
+    Data::SyncthingConnection &m_connection;
+    std::vector<EndpointStats> m_endpoints;
+    QElapsedTimer m_clock;
+    int64 m_wallTime;
+    int m_iterations;
+    int m_duration;
+    int m_concurrency;
+    int m_sent;
+    int m_pending;
+};
+
+/*!
+ * \brief Sets the number of requests to be sent per endpoint.
+ * \remarks Ignored if a duration has been set.
+ */
+inline void Benchmark::setIterations(int iterations)
+{
+    m_iterations = iterations;
+}
+
+/*!
+ * \brief Sets for how long (in milliseconds) requests are sent.
+ */
+inline void Benchmark::setDuration(int duration)
+{
+    m_duration = duration;
+}
+
+/*!
+ * \brief Sets how many requests are pending at the same time.
+ */
+inline void Benchmark::setConcurrency(int concurrency)
+{
+    m_concurrency = concurrency;
+}
+
+} // namespace Cli
+
+#endif // SYNCTHINGCTL_BENCHMARK_H
@@ -0,0 +1,463 @@
+#include "./dashboard.h"
+#include "./helper.h"
+
+#include "../connector/syncthingconnection.h"
+
+#include <c++utilities/conversion/stringconversion.h>
+
+#include <QCoreApplication>
+#include <QSocketNotifier>
+
+#include <algorithm>
+#include <iostream>
+
+#ifndef PLATFORM_WINDOWS
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace ConversionUtilities;
+using namespace Data;
+
+namespace Cli {
+
+/*!
+ * \class Dashboard
+ * \brief The Dashboard class shows a live, scrollable table of dirs and devs (used by syncthingctl watch).
+ *
+ * The terminal is only updated when the connection signals a change. Redraws are coalesced and only the cells which
+ * actually changed since the last redraw are written. Only the visible lines are formatted so the dashboard stays
+ * responsive with thousands of directories.
+ */
+
+namespace {
+
+constexpr int redrawDelay = 100;
+constexpr int statusColumnWidth = 14;
+constexpr int progressColumnWidth = 9;
+constexpr int neededColumnWidth = 11;
+constexpr int extraColumnWidth = 12;
+
+/*!
+ * \brief Returns a number which is the lower the more attention a dir with the specified \a status needs.
+ */
+int statusOrder(SyncthingDirStatus status)
+{
+    switch(status) {
+    case SyncthingDirStatus::OutOfSync:
+        return 0;
+    case SyncthingDirStatus::Synchronizing:
+        return 1;
+    case SyncthingDirStatus::Scanning:
+        return 2;
+    case SyncthingDirStatus::Paused:
+        return 3;
+    default:
+        return 4;
+    }
+}
+
+/*!
+ * \brief Returns a number which is the lower the more attention a dev with the specified \a status needs.
+ */
+int statusOrder(const SyncthingDev &dev)
+{
+    if(dev.paused) {
+        return 4;
+    }
+    switch(dev.status) {
+    case SyncthingDevStatus::Rejected:
+    case SyncthingDevStatus::OutOfSync:
+        return 0;
+    case SyncthingDevStatus::Synchronizing:
+        return 1;
+    case SyncthingDevStatus::Idle:
+        return 2;
+    case SyncthingDevStatus::OwnDevice:
+        return 3;
+    default:
+        return 5;
+    }
+}
+
+/*!
+ * \brief Appends the specified \a text to \a out truncating and padding it to the specified \a width.
+ */
+void appendPadded(string &out, const QString &text, int width)
+{
+    if(width <= 0) {
+        return;
+    }
+    const int size = text.size();
+    if(size > width) {
+        out.append(text.left(width - 1).toUtf8().data());
+        out += '~';
+    } else {
+        out.append(text.toUtf8().data());
+        out.append(static_cast<size_t>(width - size), ' ');
+    }
+}
+
+void appendCursorPosition(string &out, int row, int column)
+{
+    out += "\033[";
+    out += numberToString(row + 1);
+    out += ';';
+    out += numberToString(column + 1);
+    out += 'H';
+}
+
+}
+
+Dashboard::Dashboard(const SyncthingConnection &connection, QObject *parent) :
+    QObject(parent),
+    m_connection(connection),
+    m_inputNotifier(nullptr),
+    m_width(0),
+    m_height(0),
+    m_scrollOffset(0),
+    m_contentLines(0),
+    m_sortByName(false),
+    m_active(false)
+#ifndef PLATFORM_WINDOWS
+    , m_rawMode(false)
+#endif
+{
+    m_redrawTimer.setSingleShot(true);
+    m_redrawTimer.setInterval(redrawDelay);
+    connect(&m_redrawTimer, &QTimer::timeout, this, &Dashboard::redraw);
+    connect(&m_connection, &SyncthingConnection::newDirs, this, &Dashboard::scheduleRedraw);
+    connect(&m_connection, &SyncthingConnection::newDevices, this, &Dashboard::scheduleRedraw);
+    connect(&m_connection, &SyncthingConnection::dirStatusChanged, this, &Dashboard::scheduleRedraw);
+    connect(&m_connection, &SyncthingConnection::devStatusChanged, this, &Dashboard::scheduleRedraw);
+    connect(&m_connection, &SyncthingConnection::downloadProgressChanged, this, &Dashboard::scheduleRedraw);
+    connect(&m_connection, &SyncthingConnection::trafficChanged, this, &Dashboard::scheduleRedraw);
+    connect(&m_connection, &SyncthingConnection::statusChanged, this, &Dashboard::scheduleRedraw);
+}
+
+Dashboard::~Dashboard()
+{
+    stop();
+}
+
+void Dashboard::start()
+{
+    if(m_active) {
+        return;
+    }
+    m_active = true;
+
+#ifndef PLATFORM_WINDOWS
+    // read keys immediately and without echo; handle Ctrl+C as key to be able to restore the terminal
+    if(isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &m_originalTerminalAttributes) == 0) {
+        termios attributes = m_originalTerminalAttributes;
+        attributes.c_lflag &= static_cast<tcflag_t>(~(ICANON | ECHO | ISIG));
+        attributes.c_cc[VMIN] = 1;
+        attributes.c_cc[VTIME] = 0;
+        m_rawMode = tcsetattr(STDIN_FILENO, TCSANOW, &attributes) == 0;
+    }
+    m_inputNotifier = new QSocketNotifier(STDIN_FILENO, QSocketNotifier::Read, this);
+    connect(m_inputNotifier, &QSocketNotifier::activated, this, &Dashboard::readInput);
+#endif
+
+    // use alternate screen and hide cursor
+    cout << "\033[?1049h\033[?25l\033[2J";
+    cout.flush();
+    redraw();
+}
+
+void Dashboard::stop()
+{
+    if(!m_active) {
+        return;
+    }
+    m_active = false;
+    m_redrawTimer.stop();
+    delete m_inputNotifier;
+    m_inputNotifier = nullptr;
+#ifndef PLATFORM_WINDOWS
+    if(m_rawMode) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &m_originalTerminalAttributes);
+        m_rawMode = false;
+    }
+#endif
+    cout << "\033[?25h\033[?1049l";
+    cout.flush();
+}
+
+void Dashboard::scheduleRedraw()
+{
+    if(m_active && !m_redrawTimer.isActive()) {
+        m_redrawTimer.start();
+    }
+}
+
+void Dashboard::updateTerminalSize()
+{
+    int width = 80, height = 24;
+#ifndef PLATFORM_WINDOWS
+    winsize size;
+    if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col && size.ws_row) {
+        width = size.ws_col, height = size.ws_row;
+    }
+#endif
+    if(width == m_width && height == m_height) {
+        return;
+    }
+    m_width = width, m_height = height;
+    const int nameColumnWidth = max(10, m_width - statusColumnWidth - progressColumnWidth - neededColumnWidth - extraColumnWidth - 4);
+    m_columnWidths = { nameColumnWidth, statusColumnWidth, progressColumnWidth, neededColumnWidth, extraColumnWidth };
+    // everything needs to be written again
+    m_screen.clear();
+}
+
+void Dashboard::scroll(int lines)
+{
+    const int visibleLines = max(1, m_height - 2);
+    const int newOffset = max(0, min(m_scrollOffset + lines, m_contentLines - visibleLines));
+    if(newOffset != m_scrollOffset) {
+        m_scrollOffset = newOffset;
+        redraw();
+    }
+}
+
+void Dashboard::makeDirLine(Line &line, const SyncthingDir &dir) const
+{
+    line.resize(m_columnWidths.size());
+    line[0] = dir.displayName();
+    line[1] = QString::fromLatin1(dirStatusString(dir));
+    switch(dir.status) {
+    case SyncthingDirStatus::Scanning:
+    case SyncthingDirStatus::Synchronizing:
+        line[2] = dir.progressPercentage > 0 ? QStringLiteral("%1 %").arg(dir.progressPercentage) : QString();
+        break;
+    default:
+        line[2].clear();
+    }
+    line[3] = dir.neededByted > 0 ? QString::fromUtf8(dataSizeToString(dir.neededByted).data()) : QString();
+    line[4] = dir.neededFiles > 0 ? QStringLiteral("%1 files").arg(dir.neededFiles) : QString();
+}
+
+void Dashboard::makeDevLine(Line &line, const SyncthingDev &dev) const
+{
+    line.resize(m_columnWidths.size());
+    line[0] = dev.name.isEmpty() ? dev.id : dev.name;
+    line[1] = QString::fromLatin1(devStatusString(dev));
+    line[2] = dev.status == SyncthingDevStatus::Synchronizing && dev.progressPercentage > 0 ? QStringLiteral("%1 %").arg(dev.progressPercentage) : QString();
+    line[3] = dev.totalIncomingTraffic ? QString::fromUtf8(dataSizeToString(dev.totalIncomingTraffic).data()) : QString();
+    line[4] = dev.totalOutgoingTraffic ? QString::fromUtf8(dataSizeToString(dev.totalOutgoingTraffic).data()) : QString();
+}
+
+void Dashboard::redraw()
+{
+    if(!m_active) {
+        return;
+    }
+    m_redrawTimer.stop();
+    string out;
+    updateTerminalSize();
+    if(m_screen.empty()) {
+        out += "\033[2J";
+    }
+
+    // determine the order of dirs and devs
+    const auto &dirs = m_connection.dirInfo();
+    const auto &devs = m_connection.devInfo();
+    vector<const SyncthingDir *> sortedDirs;
+    sortedDirs.reserve(dirs.size());
+    for(const SyncthingDir &dir : dirs) {
+        sortedDirs.emplace_back(&dir);
+    }
+    vector<const SyncthingDev *> sortedDevs;
+    sortedDevs.reserve(devs.size());
+    for(const SyncthingDev &dev : devs) {
+        sortedDevs.emplace_back(&dev);
+    }
+    const bool sortByName = m_sortByName;
+    stable_sort(sortedDirs.begin(), sortedDirs.end(), [sortByName] (const SyncthingDir *lhs, const SyncthingDir *rhs) {
+        if(!sortByName) {
+            const int lhsOrder = statusOrder(lhs->status), rhsOrder = statusOrder(rhs->status);
+            if(lhsOrder != rhsOrder) {
+                return lhsOrder < rhsOrder;
+            }
+        }
+        return lhs->displayName().compare(rhs->displayName(), Qt::CaseInsensitive) < 0;
+    });
+    stable_sort(sortedDevs.begin(), sortedDevs.end(), [sortByName] (const SyncthingDev *lhs, const SyncthingDev *rhs) {
+        if(!sortByName) {
+            const int lhsOrder = statusOrder(*lhs), rhsOrder = statusOrder(*rhs);
+            if(lhsOrder != rhsOrder) {
+                return lhsOrder < rhsOrder;
+            }
+        }
+        return lhs->name.compare(rhs->name, Qt::CaseInsensitive) < 0;
+    });
+
+    // content: folders heading, dirs, empty line, devices heading, devs
+    const int dirCount = static_cast<int>(sortedDirs.size()), devCount = static_cast<int>(sortedDevs.size());
+    m_contentLines = dirCount + devCount + 3;
+    const int visibleLines = max(1, m_height - 2);
+    m_scrollOffset = max(0, min(m_scrollOffset, m_contentLines - visibleLines));
+
+    // compose the visible lines
+    vector<Line> screen(static_cast<size_t>(m_height));
+    screen[0].emplace_back(QStringLiteral("Syncthing at %1: %2 | in: %3, out: %4 | %5 folders, %6 devices").arg(
+                               m_connection.syncthingUrl(), m_connection.statusText(),
+                               QString::fromUtf8(bitrateToString(m_connection.totalIncomingRate(), true).data()),
+                               QString::fromUtf8(bitrateToString(m_connection.totalOutgoingRate(), true).data()))
+                           .arg(dirCount).arg(devCount));
+    for(int row = 1; row <= visibleLines && row < m_height; ++row) {
+        Line &line = screen[static_cast<size_t>(row)];
+        const int index = m_scrollOffset + row - 1;
+        if(index == 0) {
+            line = { QStringLiteral("FOLDER"), QStringLiteral("STATUS"), QStringLiteral("PROGRESS"), QStringLiteral("NEEDED"), QStringLiteral("FILES") };
+        } else if(index <= dirCount) {
+            makeDirLine(line, *sortedDirs[static_cast<size_t>(index - 1)]);
+        } else if(index == dirCount + 1) {
+            line.emplace_back();
+        } else if(index == dirCount + 2) {
+            line = { QStringLiteral("DEVICE"), QStringLiteral("STATUS"), QStringLiteral("PROGRESS"), QStringLiteral("INCOMING"), QStringLiteral("OUTGOING") };
+        } else if(index < m_contentLines) {
+            makeDevLine(line, *sortedDevs[static_cast<size_t>(index - dirCount - 3)]);
+        } else {
+            line.emplace_back();
+        }
+    }
+    if(m_height > 1) {
+        screen.back().emplace_back(QStringLiteral("Up/Down/PgUp/PgDown: scroll | s: sort by %1 | q: quit | lines %2-%3 of %4").arg(
+                                       m_sortByName ? QStringLiteral("status") : QStringLiteral("name"))
+                                   .arg(m_scrollOffset + 1).arg(min(m_scrollOffset + visibleLines, m_contentLines)).arg(m_contentLines));
+    }
+
+    // write only what has changed
+    for(int row = 0; row != m_height; ++row) {
+        const Line &line = screen[static_cast<size_t>(row)];
+        if(static_cast<size_t>(row) >= m_screen.size() || m_screen[static_cast<size_t>(row)].size() != line.size()) {
+            writeLine(out, row, line);
+            continue;
+        }
+        const Line &previousLine = m_screen[static_cast<size_t>(row)];
+        for(size_t cellIndex = 0; cellIndex != line.size(); ++cellIndex) {
+            if(previousLine[cellIndex] != line[cellIndex]) {
+                writeCell(out, row, cellIndex, line);
+            }
+        }
+    }
+    m_screen.swap(screen);
+    if(!out.empty()) {
+        cout << out;
+        cout.flush();
+    }
+}
+
+void Dashboard::writeLine(string &out, int row, const Line &line)
+{
+    appendCursorPosition(out, row, 0);
+    for(size_t cellIndex = 0; cellIndex != line.size(); ++cellIndex) {
+        writeCell(out, row, cellIndex, line);
+    }
+    out += "\033[K";
+}
+
+void Dashboard::writeCell(string &out, int row, size_t cellIndex, const Line &line)
+{
+    // lines with only one cell span the whole width, the first and the last line are highlighted
+    const bool banner = row == 0 || row == m_height - 1;
+    int column = 0, width = m_width;
+    if(line.size() > 1) {
+        for(size_t i = 0; i != cellIndex; ++i) {
+            column += m_columnWidths[i] + 1;
+        }
+        width = m_columnWidths[cellIndex];
+    }
+    appendCursorPosition(out, row, column);
+    if(banner) {
+        out += "\033[7m";
+    }
+    appendPadded(out, line[cellIndex], width);
+    if(banner) {
+        out += "\033[0m";
+    }
+}
+
+void Dashboard::readInput()
+{
+#ifndef PLATFORM_WINDOWS
+    char buffer[64];
+    const auto size = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    if(size <= 0) {
+        // stdin has been closed
+        delete m_inputNotifier;
+        m_inputNotifier = nullptr;
+        return;
+    }
+    const int page = max(1, m_height - 3);
+    for(ssize_t i = 0; i < size; ++i) {
+        switch(buffer[i]) {
+        case 'q':
+        case 'Q':
+        case 3: // Ctrl+C
+        case 4: // Ctrl+D
+            stop();
+            QCoreApplication::quit();
+            return;
+        case 'j':
+            scroll(1);
+            break;
+        case 'k':
+            scroll(-1);
+            break;
+        case ' ':
+            scroll(page);
+            break;
+        case 'g':
+            scroll(-m_contentLines);
+            break;
+        case 'G':
+            scroll(m_contentLines);
+            break;
+        case 's':
+        case 'S':
+            m_sortByName = !m_sortByName;
+            redraw();
+            break;
+        case '\033':
+            // handle escape sequences for cursor keys, page up/down, home and end
+            if(i + 2 < size && buffer[i + 1] == '[') {
+                switch(buffer[i + 2]) {
+                case 'A':
+                    scroll(-1);
+                    break;
+                case 'B':
+                    scroll(1);
+                    break;
+                case 'H':
+                    scroll(-m_contentLines);
+                    break;
+                case 'F':
+                    scroll(m_contentLines);
+                    break;
+                case '5':
+                    scroll(-page);
+                    break;
+                case '6':
+                    scroll(page);
+                    break;
+                default:
+                    ;
+                }
+                i += 2;
+                if(i + 1 < size && buffer[i + 1] == '~') {
+                    ++i;
+                }
+            }
+            break;
+        default:
+            ;
+        }
+    }
+#endif
+}
+
+} // namespace Cli
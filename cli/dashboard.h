@@ -0,0 +1,72 @@
+#ifndef SYNCTHINGCTL_DASHBOARD_H
+#define SYNCTHINGCTL_DASHBOARD_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <string>
+#include <vector>
+
+#ifndef PLATFORM_WINDOWS
+#include <termios.h>
+#endif
+
+QT_FORWARD_DECLARE_CLASS(QSocketNotifier)
+
+namespace Data {
+class SyncthingConnection;
+struct SyncthingDir;
+struct SyncthingDev;
+}
+
+namespace Cli {
+
+class Dashboard : public QObject
+{
+    Q_OBJECT
+
+public:
+    Dashboard(const Data::SyncthingConnection &connection, QObject *parent = nullptr);
+    ~Dashboard();
+
+    void start();
+    void stop();
+
+public slots:
+    void scheduleRedraw();
+
+private slots:
+    void redraw();
+    void readInput();
+
+private:
+    typedef std::vector<QString> Line;
+
+    void updateTerminalSize();
+    void scroll(int lines);
+    void makeDirLine(Line &line, const Data::SyncthingDir &dir) const;
+    void makeDevLine(Line &line, const Data::SyncthingDev &dev) const;
+    void writeLine(std::string &out, int row, const Line &line);
+    void writeCell(std::string &out, int row, std::size_t cellIndex, const Line &line);
+
+    const Data::SyncthingConnection &m_connection;
+    QTimer m_redrawTimer;
+    QSocketNotifier *m_inputNotifier;
+    std::vector<Line> m_screen;
+    std::vector<int> m_columnWidths;
+    int m_width;
+    int m_height;
+    int m_scrollOffset;
+    int m_contentLines;
+    bool m_sortByName;
+    bool m_active;
+#ifndef PLATFORM_WINDOWS
+    termios m_originalTerminalAttributes;
+    bool m_rawMode;
+#endif
+};
+
+} // namespace Cli
+
+#endif // SYNCTHINGCTL_DASHBOARD_H
@@ -0,0 +1,295 @@
+#include "./eventrecorder.h"
+#include "./jsonwriter.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringBuilder>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace ChronoUtilities;
+
+namespace Cli {
+
+/*!
+ * \brief The number of rotated files which are kept (named like the file with an additional suffix ".1", ".2", ...).
+ */
+constexpr int rotatedFileCount = 5;
+
+/*!
+ * \brief The interval in which recorded events are flushed to disk in milliseconds.
+ */
+constexpr int flushInterval = 1000;
+
+/*!
+ * \class EventRecorder
+ * \brief The EventRecorder class appends events to a file (used by syncthingctl events --record).
+ *
+ * Events are written as newline-delimited JSON, one compact JSON object per event as received from Syncthing. Writes
+ * are buffered and flushed periodically. When the file exceeds the rotation size it is renamed and a new file is
+ * started. The size is tracked while writing so checking it does not flush the buffer.
+ *
+ * If writing or rotating fails, the file is closed, an error is printed and failed() is emitted; later events are not
+ * recorded anymore.
+ */
+
+EventRecorder::EventRecorder(const QString &path, qint64 rotationSize, QObject *parent) :
+    QObject(parent),
+    m_file(path),
+    m_rotationSize(rotationSize),
+    m_fileSize(0)
+{
+    m_flushTimer.setInterval(flushInterval);
+    connect(&m_flushTimer, &QTimer::timeout, this, &EventRecorder::flush);
+}
+
+EventRecorder::~EventRecorder()
+{
+    flush();
+}
+
+/*!
+ * \brief Opens the file for appending events.
+ */
+bool EventRecorder::open()
+{
+    if(!m_file.open(QFile::WriteOnly | QFile::Append)) {
+        return false;
+    }
+    m_fileSize = m_file.size();
+    m_flushTimer.start();
+    return true;
+}
+
+/*!
+ * \brief Appends the specified \a events.
+ */
+void EventRecorder::record(const QJsonArray &events)
+{
+    if(!m_file.isOpen()) {
+        return;
+    }
+    for(const QJsonValue &event : events) {
+        QByteArray line(QJsonDocument(event.toObject()).toJson(QJsonDocument::Compact));
+        line.append('\n');
+        if(m_file.write(line) != line.size()) {
+            fail("write to");
+            return;
+        }
+        m_fileSize += line.size();
+    }
+    if(m_rotationSize > 0 && m_fileSize >= m_rotationSize && !rotate()) {
+        fail("rotate");
+    }
+}
+
+/*!
+ * \brief Writes buffered events to disk.
+ */
+void EventRecorder::flush()
+{
+    if(m_file.isOpen()) {
+        m_file.flush();
+    }
+}
+
+/*!
+ * \brief Renames the current file (shifting previously rotated files) and starts a new file.
+ */
+bool EventRecorder::rotate()
+{
+    const QString path(m_file.fileName());
+    m_file.close();
+    QFile::remove(path % QChar('.') % QString::number(rotatedFileCount));
+    for(int i = rotatedFileCount - 1; i > 0; --i) {
+        QFile::rename(path % QChar('.') % QString::number(i), path % QChar('.') % QString::number(i + 1));
+    }
+    QFile::rename(path, path + QStringLiteral(".1"));
+    m_fileSize = 0;
+    return m_file.open(QFile::WriteOnly | QFile::Append);
+}
+
+/*!
+ * \brief Prints an error message mentioning the failed \a action, closes the file and emits failed().
+ */
+void EventRecorder::fail(const char *action)
+{
+    cerr << "Error: Unable to " << action << " \"" << m_file.fileName().toLocal8Bit().data() << "\": " << m_file.errorString().toLocal8Bit().data() << endl;
+    m_flushTimer.stop();
+    m_file.close();
+    emit failed();
+}
+
+/*!
+ * \class EventStatistics
+ * \brief The EventStatistics class computes statistics about recorded events (used by syncthingctl events --stats).
+ *
+ * The events are read sequentially so only the statistics are kept in memory. Besides the number and rate of the
+ * events per type, a histogram of the number of events per second (for seconds with at least one event) is computed
+ * to show how bursty the event load is. The histogram uses power-of-two bins.
+ */
+
+EventStatistics::EventStatistics() :
+    m_count(0),
+    m_invalidLines(0),
+    m_currentSecondCount(0),
+    m_currentSecond(0)
+{}
+
+/*!
+ * \brief Reads the events recorded in the file with the specified \a path.
+ */
+bool EventStatistics::read(const QString &path, QString &errorMessage)
+{
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+    while(!file.atEnd()) {
+        const QByteArray line(file.readLine());
+        if(line.trimmed().isEmpty()) {
+            continue;
+        }
+        const QJsonObject event(QJsonDocument::fromJson(line).object());
+        const QString type(event.value(QStringLiteral("type")).toString());
+        const QString time(event.value(QStringLiteral("time")).toString());
+        if(type.isEmpty() || time.isEmpty()) {
+            ++m_invalidLines;
+            continue;
+        }
+        try {
+            add(type, DateTime::fromIsoStringGmt(time.toLocal8Bit().data()));
+        } catch(...) {
+            ++m_invalidLines;
+        }
+    }
+    concludeSecond();
+    return true;
+}
+
+void EventStatistics::add(const QString &type, DateTime time)
+{
+    if(!m_count++) {
+        m_firstTime = time;
+    }
+    m_lastTime = time;
+
+    const auto second = static_cast<int64>(time.totalTicks() / TimeSpan::ticksPerSecond);
+    if(second != m_currentSecond) {
+        concludeSecond();
+        m_currentSecond = second;
+    }
+    ++m_currentSecondCount;
+
+    TypeStats &typeStats = m_types[type];
+    ++typeStats.count;
+    if(second != typeStats.currentSecond) {
+        typeStats.peak = max(typeStats.peak, typeStats.currentSecondCount);
+        typeStats.currentSecond = second;
+        typeStats.currentSecondCount = 0;
+    }
+    ++typeStats.currentSecondCount;
+}
+
+/*!
+ * \brief Adds the number of events of the current second to the histogram.
+ */
+void EventStatistics::concludeSecond()
+{
+    if(!m_currentSecondCount) {
+        return;
+    }
+    size_t bin = 0;
+    for(uint64 count = m_currentSecondCount; count > 1; count >>= 1) {
+        ++bin;
+    }
+    if(bin >= m_burstHistogram.size()) {
+        m_burstHistogram.resize(bin + 1, 0);
+    }
+    ++m_burstHistogram[bin];
+    m_currentSecondCount = 0;
+}
+
+/*!
+ * \brief Returns the time between the first and the last event in seconds.
+ */
+double EventStatistics::duration() const
+{
+    return m_count > 1 ? (m_lastTime - m_firstTime).totalSeconds() : 0.0;
+}
+
+/*!
+ * \brief Prints the statistics in a human-readable form.
+ * \remarks The table is formatted within a separate stream so the formatting flags of \a stream are not altered.
+ */
+void EventStatistics::print(ostream &stream) const
+{
+    const double seconds = duration();
+    ostringstream out;
+    out << fixed << setprecision(2);
+    out << m_count << " events within " << seconds << " s";
+    if(seconds > 0.0) {
+        out << " (" << m_count / seconds << " events/s)";
+    }
+    if(m_invalidLines) {
+        out << ", " << m_invalidLines << " invalid lines skipped";
+    }
+    out << "\n\n" << left << setw(28) << "Type" << right << setw(10) << "Count" << setw(12) << "Events/s" << setw(10) << "Peak/s" << '\n';
+    for(const auto &type : m_types) {
+        const TypeStats &stats = type.second;
+        out << left << setw(28) << type.first.toLocal8Bit().data() << right << setw(10) << stats.count
+            << setw(12) << (seconds > 0.0 ? stats.count / seconds : 0.0) << setw(10) << max(stats.peak, stats.currentSecondCount) << '\n';
+    }
+    out << '\n' << left << setw(28) << "Events per second" << right << setw(10) << "Seconds" << '\n';
+    for(size_t bin = 0; bin != m_burstHistogram.size(); ++bin) {
+        const uint64 lower = uint64(1) << bin, upper = (uint64(1) << (bin + 1)) - 1;
+        out << left << setw(28) << (lower == upper ? to_string(lower) : to_string(lower) + '-' + to_string(upper)) << right << setw(10) << m_burstHistogram[bin] << '\n';
+    }
+    stream << out.str();
+    stream.flush();
+}
+
+/*!
+ * \brief Prints the statistics as JSON object.
+ */
+void EventStatistics::print(JsonWriter &writer) const
+{
+    const double seconds = duration();
+    writer.beginObject();
+    writer.property("events", m_count);
+    writer.property("invalidLines", m_invalidLines);
+    writer.property("firstTime", m_firstTime);
+    writer.property("lastTime", m_lastTime);
+    writer.property("duration", seconds);
+    writer.property("rate", seconds > 0.0 ? m_count / seconds : 0.0);
+    writer.key("types").beginArray();
+    for(const auto &type : m_types) {
+        const TypeStats &stats = type.second;
+        writer.beginObject();
+        writer.property("type", type.first);
+        writer.property("count", stats.count);
+        writer.property("rate", seconds > 0.0 ? stats.count / seconds : 0.0);
+        writer.property("peak", max(stats.peak, stats.currentSecondCount));
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.key("burstHistogram").beginArray();
+    for(size_t bin = 0; bin != m_burstHistogram.size(); ++bin) {
+        writer.beginObject();
+        writer.property("min", uint64(1) << bin);
+        writer.property("max", (uint64(1) << (bin + 1)) - 1);
+        writer.property("seconds", m_burstHistogram[bin]);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+    writer.endLine();
+}
+
+} // namespace Cli
@@ -0,0 +1,91 @@
+#ifndef SYNCTHINGCTL_EVENTRECORDER_H
+#define SYNCTHINGCTL_EVENTRECORDER_H
+
+#include <c++utilities/chrono/datetime.h>
+#include <c++utilities/conversion/types.h>
+
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+QT_FORWARD_DECLARE_CLASS(QJsonArray)
+
+namespace Cli {
+
+class JsonWriter;
+
+class EventRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    EventRecorder(const QString &path, qint64 rotationSize, QObject *parent = nullptr);
+    ~EventRecorder();
+
+    bool open();
+    QString errorString() const;
+
+public slots:
+    void record(const QJsonArray &events);
+    void flush();
+
+signals:
+    void failed();
+
+private:
+    bool rotate();
+    void fail(const char *action);
+
+    QFile m_file;
+    QTimer m_flushTimer;
+    const qint64 m_rotationSize;
+    qint64 m_fileSize;
+};
+
+/*!
+ * \brief Returns a human-readable description of the last error.
+ */
+inline QString EventRecorder::errorString() const
+{
+    return m_file.errorString();
+}
+
+class EventStatistics
+{
+public:
+    EventStatistics();
+
+    bool read(const QString &path, QString &errorMessage);
+    void print(std::ostream &stream) const;
+    void print(JsonWriter &writer) const;
+
+private:
+    struct TypeStats
+    {
+        uint64 count = 0;
+        uint64 peak = 0;
+        uint64 currentSecondCount = 0;
+        int64 currentSecond = 0;
+    };
+
+    void add(const QString &type, ChronoUtilities::DateTime time);
+    void concludeSecond();
+    double duration() const;
+
+    std::map<QString, TypeStats> m_types;
+    std::vector<uint64> m_burstHistogram;
+    ChronoUtilities::DateTime m_firstTime;
+    ChronoUtilities::DateTime m_lastTime;
+    uint64 m_count;
+    uint64 m_invalidLines;
+    uint64 m_currentSecondCount;
+    int64 m_currentSecond;
+};
+
+} // namespace Cli
+
+#endif // SYNCTHINGCTL_EVENTRECORDER_H
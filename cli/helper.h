@@ -1,6 +1,9 @@
 #ifndef SYNCTHINGCTL_HELPER
 #define SYNCTHINGCTL_HELPER
 
+#include "../connector/syncthingdir.h"
+#include "../connector/syncthingdev.h"
+
 #include <c++utilities/application/commandlineutils.h>
 #include <c++utilities/chrono/datetime.h>
 #include <c++utilities/chrono/timespan.h>
@@ -65,6 +68,49 @@ inline void printProperty(const char *propName, const intType value, const char
     }
 }
 
+inline const char *dirStatusString(const Data::SyncthingDir &dir)
+{
+    switch(dir.status) {
+    case Data::SyncthingDirStatus::Idle:
+        return "idle";
+    case Data::SyncthingDirStatus::Unshared:
+        return "unshared";
+    case Data::SyncthingDirStatus::Scanning:
+        return "scanning";
+    case Data::SyncthingDirStatus::Synchronizing:
+        return "synchronizing";
+    case Data::SyncthingDirStatus::Paused:
+        return "paused";
+    case Data::SyncthingDirStatus::OutOfSync:
+        return "out of sync";
+    default:
+        return "unknown";
+    }
+}
+
+inline const char *devStatusString(const Data::SyncthingDev &dev)
+{
+    if(dev.paused) {
+        return "paused";
+    }
+    switch(dev.status) {
+    case Data::SyncthingDevStatus::Disconnected:
+        return "disconnected";
+    case Data::SyncthingDevStatus::OwnDevice:
+        return "own device";
+    case Data::SyncthingDevStatus::Idle:
+        return "idle";
+    case Data::SyncthingDevStatus::Synchronizing:
+        return "synchronizing";
+    case Data::SyncthingDevStatus::OutOfSync:
+        return "out of sync";
+    case Data::SyncthingDevStatus::Rejected:
+        return "rejected";
+    default:
+        return "unknown";
+    }
+}
+
 }
 
 #endif // SYNCTHINGCTL_HELPER
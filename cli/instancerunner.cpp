@@ -0,0 +1,175 @@
+#include "./instancerunner.h"
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <iostream>
+
+using namespace std;
+
+namespace Cli {
+
+/*!
+ * \class InstanceRunner
+ * \brief The InstanceRunner class runs a syncthingctl command against multiple Syncthing instances concurrently.
+ *
+ * For each target a syncthingctl process is started with the common arguments and the URL, API key and certificate
+ * of the target. The processes are started with "--no-tray" so they never delegate to a running Syncthing Tray. The
+ * API key is passed via the environment variable SYNCTHING_CTL_API_KEY so it does not show up in the process list.
+ * At most the specified number of processes run at the same time; all of them are driven by the event loop of the
+ * calling process. The output of each process is printed as a whole when the process has finished so the output of
+ * different targets is not mixed up.
+ */
+
+InstanceRunner::InstanceRunner(const QString &program, const QStringList &commonArgs, std::vector<InstanceTarget> &&targets, QObject *parent) :
+    QObject(parent),
+    m_program(program),
+    m_commonArgs(commonArgs),
+    m_targets(move(targets)),
+    m_exitCodes(m_targets.size(), 0),
+    m_next(0),
+    m_finished(0),
+    m_running(0),
+    m_maxParallel(1)
+{}
+
+/*!
+ * \brief Starts running the command against the targets, at most \a maxParallel at the same time.
+ * \remarks Emits finished() when the command has been run against all targets.
+ */
+void InstanceRunner::start(int maxParallel)
+{
+    m_maxParallel = max(1, maxParallel);
+    if(m_targets.empty()) {
+        emit finished(0);
+        return;
+    }
+    while(m_running < m_maxParallel && m_next < m_targets.size()) {
+        startNext();
+    }
+}
+
+/*!
+ * \brief Reads targets from the inventory file with the specified \a path.
+ *
+ * Each line contains the URL optionally followed by the API key and the path of the certificate, separated by
+ * whitespaces. Empty lines and lines starting with '#' are ignored.
+ */
+bool InstanceRunner::readInventory(const QString &path, std::vector<InstanceTarget> &targets, QString &errorMessage)
+{
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly | QFile::Text)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+    QTextStream stream(&file);
+    const QRegularExpression separator(QStringLiteral("\\s+"));
+    for(int lineNumber = 1; !stream.atEnd(); ++lineNumber) {
+        const QString line(stream.readLine().trimmed());
+        if(line.isEmpty() || line.startsWith(QChar('#'))) {
+            continue;
+        }
+        const QStringList fields(line.split(separator, QString::SkipEmptyParts));
+        if(fields.size() > 3) {
+            errorMessage = QStringLiteral("line %1 has more than 3 fields").arg(lineNumber);
+            return false;
+        }
+        targets.emplace_back();
+        InstanceTarget &target = targets.back();
+        target.url = fields[0];
+        if(fields.size() > 1) {
+            target.apiKey = fields[1];
+        }
+        if(fields.size() > 2) {
+            target.certificate = fields[2];
+        }
+    }
+    return true;
+}
+
+void InstanceRunner::startNext()
+{
+    const InstanceTarget &target = m_targets[m_next];
+    QStringList args(m_commonArgs);
+    args << QStringLiteral("--url") << target.url;
+    if(!target.certificate.isEmpty()) {
+        args << QStringLiteral("--cert") << target.certificate;
+    }
+    // talk to each instance directly; a running tray is only connected to one of them
+    if(!args.contains(QStringLiteral("--no-tray"))) {
+        args << QStringLiteral("--no-tray");
+    }
+
+    // pass the API key via the environment because the arguments are visible to other users (eg. via ps)
+    QProcessEnvironment environment(QProcessEnvironment::systemEnvironment());
+    if(target.apiKey.isEmpty()) {
+        environment.remove(QStringLiteral("SYNCTHING_CTL_API_KEY"));
+    } else {
+        environment.insert(QStringLiteral("SYNCTHING_CTL_API_KEY"), target.apiKey);
+    }
+
+    auto *const process = new QProcess(this);
+    process->setProcessEnvironment(environment);
+    process->setProperty("targetIndex", static_cast<qulonglong>(m_next));
+    connect(process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &InstanceRunner::handleProcessFinished);
+    connect(process, &QProcess::errorOccurred, this, &InstanceRunner::handleProcessError);
+    ++m_next, ++m_running;
+    process->start(m_program, args, QIODevice::ReadOnly);
+}
+
+void InstanceRunner::handleProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto *const process = static_cast<QProcess *>(sender());
+    concludeProcess(process, exitStatus == QProcess::NormalExit ? exitCode : -6);
+}
+
+void InstanceRunner::handleProcessError(QProcess::ProcessError error)
+{
+    // other errors are followed by the finished() signal
+    if(error == QProcess::FailedToStart) {
+        auto *const process = static_cast<QProcess *>(sender());
+        cerr << "Error: Unable to start " << m_program.toLocal8Bit().data() << ": " << process->errorString().toLocal8Bit().data() << endl;
+        concludeProcess(process, -6);
+    }
+}
+
+void InstanceRunner::concludeProcess(QProcess *process, int exitCode)
+{
+    const auto targetIndex = static_cast<size_t>(process->property("targetIndex").toULongLong());
+    m_exitCodes[targetIndex] = exitCode;
+
+    // print output of the target as a whole
+    cerr << "==> " << m_targets[targetIndex].url.toLocal8Bit().data() << " (exit code " << exitCode << ")" << endl;
+    const QByteArray errorOutput(process->readAllStandardError());
+    cerr.write(errorOutput.data(), errorOutput.size());
+    cerr.flush();
+    const QByteArray output(process->readAllStandardOutput());
+    cout.write(output.data(), output.size());
+    cout.flush();
+    process->deleteLater();
+
+    --m_running, ++m_finished;
+    if(m_next < m_targets.size()) {
+        startNext();
+        return;
+    }
+    if(m_finished < m_targets.size()) {
+        return;
+    }
+
+    // aggregate the results: the exit code of the first failing target (in the specified order) is used
+    size_t failed = 0;
+    int aggregatedExitCode = 0;
+    for(const int exitCode : m_exitCodes) {
+        if(exitCode) {
+            if(!failed++) {
+                aggregatedExitCode = exitCode;
+            }
+        }
+    }
+    cerr << (m_targets.size() - failed) << " of " << m_targets.size() << " instances succeeded" << endl;
+    emit finished(aggregatedExitCode);
+}
+
+} // namespace Cli
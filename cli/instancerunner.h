@@ -0,0 +1,52 @@
+#ifndef SYNCTHINGCTL_INSTANCERUNNER_H
+#define SYNCTHINGCTL_INSTANCERUNNER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <vector>
+
+namespace Cli {
+
+struct InstanceTarget
+{
+    QString url;
+    QString apiKey;
+    QString certificate;
+};
+
+class InstanceRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    InstanceRunner(const QString &program, const QStringList &commonArgs, std::vector<InstanceTarget> &&targets, QObject *parent = nullptr);
+
+    void start(int maxParallel);
+    static bool readInventory(const QString &path, std::vector<InstanceTarget> &targets, QString &errorMessage);
+
+signals:
+    void finished(int exitCode);
+
+private slots:
+    void handleProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void handleProcessError(QProcess::ProcessError error);
+
+private:
+    void startNext();
+    void concludeProcess(QProcess *process, int exitCode);
+
+    const QString m_program;
+    const QStringList m_commonArgs;
+    const std::vector<InstanceTarget> m_targets;
+    std::vector<int> m_exitCodes;
+    std::size_t m_next;
+    std::size_t m_finished;
+    int m_running;
+    int m_maxParallel;
+};
+
+} // namespace Cli
+
+#endif // SYNCTHINGCTL_INSTANCERUNNER_H
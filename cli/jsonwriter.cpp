@@ -0,0 +1,255 @@
+#include "./jsonwriter.h"
+
+#include <QString>
+#include <QStringList>
+#include <QJsonValue>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+using namespace ChronoUtilities;
+
+namespace Cli {
+
+/*!
+ * \class JsonWriter
+ * \brief The JsonWriter class writes JSON directly to an output stream.
+ *
+ * In contrast to building a QJsonDocument first, only the nesting of the current position is kept in memory. So
+ * arbitrarily large output can be produced with constant memory.
+ */
+
+JsonWriter::JsonWriter(ostream &out) :
+    m_out(out),
+    m_previousPrecision(out.precision(numeric_limits<double>::digits10)),
+    m_afterKey(false)
+{}
+
+/*!
+ * \brief Restores the precision the stream had before constructing the writer.
+ */
+JsonWriter::~JsonWriter()
+{
+    m_out.precision(m_previousPrecision);
+}
+
+JsonWriter &JsonWriter::beginObject()
+{
+    beginValue();
+    m_out << '{';
+    m_empty.push_back(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject()
+{
+    m_empty.pop_back();
+    m_out << '}';
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray()
+{
+    beginValue();
+    m_out << '[';
+    m_empty.push_back(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray()
+{
+    m_empty.pop_back();
+    m_out << ']';
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(const char *key)
+{
+    beginValue();
+    writeString(key, strlen(key));
+    m_out << ':';
+    m_afterKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::null()
+{
+    beginValue();
+    m_out << "null";
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const char *value)
+{
+    if(!value) {
+        return null();
+    }
+    beginValue();
+    writeString(value, strlen(value));
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const QString &value)
+{
+    beginValue();
+    const QByteArray utf8(value.toUtf8());
+    writeString(utf8.data(), static_cast<size_t>(utf8.size()));
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const QStringList &value)
+{
+    beginArray();
+    for(const QString &str : value) {
+        this->value(str);
+    }
+    return endArray();
+}
+
+JsonWriter &JsonWriter::value(bool value)
+{
+    beginValue();
+    m_out << (value ? "true" : "false");
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(int value)
+{
+    beginValue();
+    m_out << value;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(int64 value)
+{
+    beginValue();
+    m_out << value;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(uint64 value)
+{
+    beginValue();
+    m_out << value;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(double value)
+{
+    if(!std::isfinite(value)) {
+        return null();
+    }
+    beginValue();
+    m_out << value;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(DateTime value)
+{
+    if(value.isNull()) {
+        return null();
+    }
+    beginValue();
+    const string iso(value.toIsoString());
+    writeString(iso.data(), iso.size());
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const QJsonValue &value)
+{
+    switch(value.type()) {
+    case QJsonValue::Bool:
+        return this->value(value.toBool());
+    case QJsonValue::Double: {
+        const double number = value.toDouble();
+        if(number == std::floor(number) && std::fabs(number) < 9007199254740992.0) {
+            return this->value(static_cast<int64>(number));
+        }
+        return this->value(number);
+    }
+    case QJsonValue::String:
+        return this->value(value.toString());
+    case QJsonValue::Array:
+        beginArray();
+        for(const QJsonValue &element : value.toArray()) {
+            this->value(element);
+        }
+        return endArray();
+    case QJsonValue::Object: {
+        beginObject();
+        const QJsonObject object(value.toObject());
+        for(auto i = object.constBegin(), end = object.constEnd(); i != end; ++i) {
+            key(i.key().toUtf8().data()).value(i.value());
+        }
+        return endObject();
+    }
+    default:
+        return null();
+    }
+}
+
+/*!
+ * \brief Terminates the current top-level value with a new line and flushes the stream.
+ * \remarks Used to write newline-delimited JSON.
+ */
+void JsonWriter::endLine()
+{
+    m_out << '\n';
+    m_out.flush();
+}
+
+void JsonWriter::beginValue()
+{
+    if(m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+    if(m_empty.empty()) {
+        return;
+    }
+    if(m_empty.back()) {
+        m_empty.back() = false;
+    } else {
+        m_out << ',';
+    }
+}
+
+void JsonWriter::writeString(const char *data, size_t size)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    m_out << '"';
+    for(const char *end = data + size; data != end; ++data) {
+        const auto c = static_cast<unsigned char>(*data);
+        switch(c) {
+        case '"':
+            m_out << "\\\"";
+            break;
+        case '\\':
+            m_out << "\\\\";
+            break;
+        case '\n':
+            m_out << "\\n";
+            break;
+        case '\r':
+            m_out << "\\r";
+            break;
+        case '\t':
+            m_out << "\\t";
+            break;
+        default:
+            if(c < 0x20) {
+                m_out << "\\u00" << hexDigits[c >> 4] << hexDigits[c & 0xF];
+            } else {
+                m_out << *data;
+            }
+        }
+    }
+    m_out << '"';
+}
+
+} // namespace Cli
@@ -0,0 +1,60 @@
+#ifndef SYNCTHINGCTL_JSONWRITER_H
+#define SYNCTHINGCTL_JSONWRITER_H
+
+#include <c++utilities/chrono/datetime.h>
+#include <c++utilities/conversion/types.h>
+
+#include <QtGlobal>
+
+#include <ios>
+#include <vector>
+
+QT_FORWARD_DECLARE_CLASS(QString)
+QT_FORWARD_DECLARE_CLASS(QStringList)
+QT_FORWARD_DECLARE_CLASS(QJsonValue)
+
+namespace Cli {
+
+class JsonWriter
+{
+public:
+    JsonWriter(std::ostream &out);
+    ~JsonWriter();
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray();
+    JsonWriter &endArray();
+    JsonWriter &key(const char *key);
+    JsonWriter &null();
+    JsonWriter &value(const char *value);
+    JsonWriter &value(const QString &value);
+    JsonWriter &value(const QStringList &value);
+    JsonWriter &value(bool value);
+    JsonWriter &value(int value);
+    JsonWriter &value(int64 value);
+    JsonWriter &value(uint64 value);
+    JsonWriter &value(double value);
+    JsonWriter &value(ChronoUtilities::DateTime value);
+    JsonWriter &value(const QJsonValue &value);
+    template<typename ValueType> JsonWriter &property(const char *key, const ValueType &value);
+    void endLine();
+
+private:
+    void beginValue();
+    void writeString(const char *data, std::size_t size);
+
+    std::ostream &m_out;
+    std::vector<bool> m_empty;
+    const std::streamsize m_previousPrecision;
+    bool m_afterKey;
+};
+
+template<typename ValueType> inline JsonWriter &JsonWriter::property(const char *key, const ValueType &value)
+{
+    return this->key(key).value(value);
+}
+
+} // namespace Cli
+
+#endif // SYNCTHINGCTL_JSONWRITER_H
@@ -0,0 +1,331 @@
+#include "./metricsexporter.h"
+#include "./helper.h"
+
+#include "../connector/syncthingconnection.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QTcpSocket>
+
+using namespace std;
+using namespace Data;
+
+namespace Cli {
+
+/*!
+ * \class MetricsExporter
+ * \brief The MetricsExporter class serves metrics about Syncthing instances in the Prometheus text exposition format
+ *        (used by syncthingctl serve-metrics).
+ *
+ * One connection is kept per target. It is updated by the Syncthing events like any other connection so scrapes are
+ * answered from the state of the connections without making any requests to Syncthing. The metrics are rendered
+ * into a buffer which is reused for all scrapes.
+ */
+
+/*!
+ * \brief The initial capacity of the buffer the metrics are rendered into.
+ */
+constexpr int initialBufferCapacity = 64 * 1024;
+
+/*!
+ * \brief The max. size of a HTTP request header which is accepted.
+ */
+constexpr int maxRequestSize = 8 * 1024;
+
+MetricsExporter::MetricsExporter(QObject *parent) :
+    QObject(parent),
+    m_scrapes(0),
+    m_lastRenderTime(0)
+{
+    // note: QByteArray only keeps its capacity when being resized to zero if the capacity has been reserved explicitely
+    m_buffer.reserve(initialBufferCapacity);
+    m_labels.reserve(1024);
+    connect(&m_server, &QTcpServer::newConnection, this, &MetricsExporter::acceptConnection);
+}
+
+MetricsExporter::~MetricsExporter()
+{}
+
+/*!
+ * \brief Adds a target using the specified \a settings and connects to it.
+ * \remarks The connection is re-established automatically when lost (if \a settings has no reconnect interval,
+ *          a default of 10 seconds is used).
+ */
+void MetricsExporter::addTarget(const SyncthingConnectionSettings &settings)
+{
+    m_targets.emplace_back(new Target);
+    Target &target = *m_targets.back();
+    target.settings = settings;
+    if(target.settings.reconnectInterval <= 0) {
+        target.settings.reconnectInterval = 10000;
+    }
+    target.connection.reset(new SyncthingConnection);
+    appendLabel(target.instanceLabel, "instance", settings.syncthingUrl);
+    target.instanceLabel.remove(0, 1); // remove leading separator
+    Target *const targetPtr = &target;
+    connect(target.connection.get(), &SyncthingConnection::newEvents, this, [targetPtr] (const QJsonArray &events) {
+        targetPtr->events += static_cast<uint64>(events.size());
+    });
+    connect(target.connection.get(), &SyncthingConnection::error, this, [targetPtr] {
+        ++targetPtr->errors;
+    });
+    target.connection->reconnect(target.settings);
+}
+
+/*!
+ * \brief Starts listening for scrapes on the specified \a address and \a port.
+ */
+bool MetricsExporter::listen(const QHostAddress &address, quint16 port)
+{
+    return m_server.listen(address, port);
+}
+
+void MetricsExporter::acceptConnection()
+{
+    while(QTcpSocket *const socket = m_server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, &MetricsExporter::readRequest);
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MetricsExporter::readRequest()
+{
+    auto *const socket = static_cast<QTcpSocket *>(sender());
+    if(socket->property("responded").toBool()) {
+        socket->readAll();
+        return;
+    }
+
+    // wait until the request header is complete
+    const QByteArray request(socket->peek(maxRequestSize));
+    if(!request.contains("\r\n\r\n") && !request.contains("\n\n")) {
+        if(request.size() >= maxRequestSize) {
+            socket->write("HTTP/1.0 431 Request Header Fields Too Large\r\nConnection: close\r\n\r\n");
+            socket->disconnectFromHost();
+        }
+        return;
+    }
+    socket->readAll();
+    socket->setProperty("responded", true);
+
+    // serve metrics on GET /metrics (and /)
+    const int pathEnd = request.indexOf(' ', 4);
+    const QByteArray path(request.startsWith("GET ") && pathEnd > 4 ? request.mid(4, pathEnd - 4) : QByteArray());
+    if(path == "/metrics" || path == "/") {
+        const QByteArray &metrics = render();
+        socket->write("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nConnection: close\r\nContent-Length: ");
+        socket->write(QByteArray::number(metrics.size()));
+        socket->write("\r\n\r\n");
+        socket->write(metrics);
+    } else {
+        socket->write("HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\nConnection: close\r\nContent-Length: 10\r\n\r\nNot found\n");
+    }
+    socket->disconnectFromHost();
+}
+
+/*!
+ * \brief Renders the metrics of all targets from their current state.
+ * \remarks The returned buffer is reused by the next call.
+ */
+const QByteArray &MetricsExporter::render()
+{
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+    m_buffer.resize(0);
+    ++m_scrapes;
+
+    beginFamily("syncthing_up", "gauge", "Whether the connection to the Syncthing instance is established.");
+    for(const auto &target : m_targets) {
+        appendSample("syncthing_up", target->instanceLabel, target->connection->isConnected() ? 1.0 : 0.0);
+    }
+    beginFamily("syncthing_traffic_bytes_total", "counter", "Total number of bytes transferred.");
+    for(const auto &target : m_targets) {
+        resetLabels(target->instanceLabel) += ",direction=\"in\"";
+        appendSample("syncthing_traffic_bytes_total", m_labels, target->connection->totalIncomingTraffic());
+        resetLabels(target->instanceLabel) += ",direction=\"out\"";
+        appendSample("syncthing_traffic_bytes_total", m_labels, target->connection->totalOutgoingTraffic());
+    }
+    beginFamily("syncthing_traffic_rate_kbits", "gauge", "Current transfer rate in kbit/s.");
+    for(const auto &target : m_targets) {
+        resetLabels(target->instanceLabel) += ",direction=\"in\"";
+        appendSample("syncthing_traffic_rate_kbits", m_labels, target->connection->totalIncomingRate());
+        resetLabels(target->instanceLabel) += ",direction=\"out\"";
+        appendSample("syncthing_traffic_rate_kbits", m_labels, target->connection->totalOutgoingRate());
+    }
+
+    // folder metrics
+    beginFamily("syncthing_folder_status", "gauge", "The current status of the folder (always 1).");
+    for(const auto &target : m_targets) {
+        for(const SyncthingDir &dir : target->connection->dirInfo()) {
+            resetLabels(target->instanceLabel);
+            appendLabel(m_labels, "folder", dir.id);
+            appendLabel(m_labels, "label", dir.label);
+            m_labels += ",status=\"";
+            m_labels += dirStatusString(dir);
+            m_labels += '\"';
+            appendSample("syncthing_folder_status", m_labels, 1.0);
+        }
+    }
+    struct DirMetric
+    {
+        const char *name;
+        const char *help;
+        double (*value)(const SyncthingDir &dir);
+    };
+    static const DirMetric dirMetrics[] = {
+        { "syncthing_folder_progress_percent", "Progress of scanning or synchronizing the folder.", [] (const SyncthingDir &dir) { return static_cast<double>(dir.progressPercentage); } },
+        { "syncthing_folder_need_bytes", "Number of bytes to be synchronized.", [] (const SyncthingDir &dir) { return static_cast<double>(dir.neededByted); } },
+        { "syncthing_folder_need_files", "Number of files to be synchronized.", [] (const SyncthingDir &dir) { return static_cast<double>(dir.neededFiles); } },
+        { "syncthing_folder_global_bytes", "Number of bytes in the global state.", [] (const SyncthingDir &dir) { return static_cast<double>(dir.globalBytes); } },
+        { "syncthing_folder_local_bytes", "Number of bytes in the local state.", [] (const SyncthingDir &dir) { return static_cast<double>(dir.localBytes); } },
+    };
+    for(const DirMetric &metric : dirMetrics) {
+        beginFamily(metric.name, "gauge", metric.help);
+        for(const auto &target : m_targets) {
+            for(const SyncthingDir &dir : target->connection->dirInfo()) {
+                resetLabels(target->instanceLabel);
+                appendLabel(m_labels, "folder", dir.id);
+                appendSample(metric.name, m_labels, metric.value(dir));
+            }
+        }
+    }
+    beginFamily("syncthing_folder_errors", "gauge", "Number of items which could not be synchronized.");
+    for(const auto &target : m_targets) {
+        for(const SyncthingDir &dir : target->connection->dirInfo()) {
+            resetLabels(target->instanceLabel);
+            appendLabel(m_labels, "folder", dir.id);
+            appendSample("syncthing_folder_errors", m_labels, static_cast<double>(dir.errors.size()));
+        }
+    }
+
+    // device metrics
+    beginFamily("syncthing_device_status", "gauge", "The current status of the device (always 1).");
+    for(const auto &target : m_targets) {
+        for(const SyncthingDev &dev : target->connection->devInfo()) {
+            resetLabels(target->instanceLabel);
+            appendLabel(m_labels, "device", dev.id);
+            appendLabel(m_labels, "name", dev.name);
+            m_labels += ",status=\"";
+            m_labels += devStatusString(dev);
+            m_labels += '\"';
+            appendSample("syncthing_device_status", m_labels, 1.0);
+        }
+    }
+    beginFamily("syncthing_device_traffic_bytes_total", "counter", "Total number of bytes transferred from/to the device.");
+    for(const auto &target : m_targets) {
+        for(const SyncthingDev &dev : target->connection->devInfo()) {
+            resetLabels(target->instanceLabel);
+            appendLabel(m_labels, "device", dev.id);
+            const int size = m_labels.size();
+            m_labels += ",direction=\"in\"";
+            appendSample("syncthing_device_traffic_bytes_total", m_labels, dev.totalIncomingTraffic);
+            m_labels.resize(size);
+            m_labels += ",direction=\"out\"";
+            appendSample("syncthing_device_traffic_bytes_total", m_labels, dev.totalOutgoingTraffic);
+        }
+    }
+
+    // instrumentation of the exporter itself
+    beginFamily("syncthingctl_events_received_total", "counter", "Number of Syncthing events received.");
+    for(const auto &target : m_targets) {
+        appendSample("syncthingctl_events_received_total", target->instanceLabel, target->events);
+    }
+    beginFamily("syncthingctl_connection_errors_total", "counter", "Number of errors occurred on the connection to Syncthing.");
+    for(const auto &target : m_targets) {
+        appendSample("syncthingctl_connection_errors_total", target->instanceLabel, target->errors);
+    }
+    beginFamily("syncthingctl_requests_aborted_total", "counter", "Number of requests aborted because their deadline has been exceeded.");
+    for(const auto &target : m_targets) {
+        appendSample("syncthingctl_requests_aborted_total", target->instanceLabel, target->connection->abortedRequests());
+    }
+    beginFamily("syncthingctl_scrapes_total", "counter", "Number of scrapes served.");
+    appendSample("syncthingctl_scrapes_total", QByteArray(), m_scrapes);
+    beginFamily("syncthingctl_render_seconds", "gauge", "Time it took to render the metrics of the previous scrape.");
+    appendSample("syncthingctl_render_seconds", QByteArray(), static_cast<double>(m_lastRenderTime) / 1e9);
+
+    // keep a buffer which is large enough for the next time
+    if(m_buffer.capacity() < m_buffer.size() + m_buffer.size() / 4) {
+        m_buffer.reserve(m_buffer.size() + m_buffer.size() / 4);
+    }
+    m_lastRenderTime = renderTimer.nsecsElapsed();
+    return m_buffer;
+}
+
+void MetricsExporter::beginFamily(const char *name, const char *type, const char *help)
+{
+    m_buffer += "# HELP ";
+    m_buffer += name;
+    m_buffer += ' ';
+    m_buffer += help;
+    m_buffer += "\n# TYPE ";
+    m_buffer += name;
+    m_buffer += ' ';
+    m_buffer += type;
+    m_buffer += '\n';
+}
+
+void MetricsExporter::appendSample(const char *name, const QByteArray &labels, double value)
+{
+    m_buffer += name;
+    if(!labels.isEmpty()) {
+        m_buffer += '{';
+        m_buffer += labels;
+        m_buffer += '}';
+    }
+    m_buffer += ' ';
+    m_buffer += QByteArray::number(value, 'g', 15);
+    m_buffer += '\n';
+}
+
+void MetricsExporter::appendSample(const char *name, const QByteArray &labels, uint64 value)
+{
+    m_buffer += name;
+    if(!labels.isEmpty()) {
+        m_buffer += '{';
+        m_buffer += labels;
+        m_buffer += '}';
+    }
+    m_buffer += ' ';
+    m_buffer += QByteArray::number(static_cast<qulonglong>(value));
+    m_buffer += '\n';
+}
+
+/*!
+ * \brief Sets the labels of the next sample to the specified \a instanceLabel and returns them.
+ * \remarks The label is copied into the reserved buffer. Assigning it would share the data of \a instanceLabel
+ *          instead so a new buffer would be allocated when appending further labels.
+ */
+QByteArray &MetricsExporter::resetLabels(const QByteArray &instanceLabel)
+{
+    m_labels.truncate(0);
+    m_labels.append(instanceLabel.constData(), instanceLabel.size());
+    return m_labels;
+}
+
+/*!
+ * \brief Appends a label with the specified \a name and \a value (preceded by a comma) to \a labels.
+ */
+void MetricsExporter::appendLabel(QByteArray &labels, const char *name, const QString &value)
+{
+    labels += ',';
+    labels += name;
+    labels += "=\"";
+    for(const char c : value.toUtf8()) {
+        switch(c) {
+        case '\\':
+            labels += "\\\\";
+            break;
+        case '\"':
+            labels += "\\\"";
+            break;
+        case '\n':
+            labels += "\\n";
+            break;
+        default:
+            labels += c;
+        }
+    }
+    labels += '\"';
+}
+
+} // namespace Cli
@@ -0,0 +1,74 @@
+#ifndef SYNCTHINGCTL_METRICSEXPORTER_H
+#define SYNCTHINGCTL_METRICSEXPORTER_H
+
+#include "../connector/syncthingconnectionsettings.h"
+
+#include <c++utilities/conversion/types.h>
+
+#include <QByteArray>
+#include <QObject>
+#include <QTcpServer>
+
+#include <memory>
+#include <vector>
+
+QT_FORWARD_DECLARE_CLASS(QTcpSocket)
+
+namespace Data {
+class SyncthingConnection;
+}
+
+namespace Cli {
+
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    MetricsExporter(QObject *parent = nullptr);
+    ~MetricsExporter();
+
+    void addTarget(const Data::SyncthingConnectionSettings &settings);
+    bool listen(const QHostAddress &address, quint16 port);
+    QString errorString() const;
+    const QByteArray &render();
+
+private slots:
+    void acceptConnection();
+    void readRequest();
+
+private:
+    struct Target
+    {
+        Data::SyncthingConnectionSettings settings;
+        std::unique_ptr<Data::SyncthingConnection> connection;
+        QByteArray instanceLabel;
+        uint64 events = 0;
+        uint64 errors = 0;
+    };
+
+    void beginFamily(const char *name, const char *type, const char *help);
+    void appendSample(const char *name, const QByteArray &labels, double value);
+    void appendSample(const char *name, const QByteArray &labels, uint64 value);
+    void appendLabel(QByteArray &labels, const char *name, const QString &value);
+    QByteArray &resetLabels(const QByteArray &instanceLabel);
+
+    QTcpServer m_server;
+    std::vector<std::unique_ptr<Target>> m_targets;
+    QByteArray m_buffer;
+    QByteArray m_labels;
+    uint64 m_scrapes;
+    int64 m_lastRenderTime;
+};
+
+/*!
+ * \brief Returns a human-readable description of the last error of the server.
+ */
+inline QString MetricsExporter::errorString() const
+{
+    return m_server.errorString();
+}
+
+} // namespace Cli
+
+#endif // SYNCTHINGCTL_METRICSEXPORTER_H
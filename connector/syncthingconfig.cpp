@@ -1,5 +1,6 @@
 #include "syncthingconfig.h"
 
+#include <QHostAddress>
 #include <QStandardPaths>
 #include <QXmlStreamReader>
 #include <QFile>
@@ -67,4 +68,27 @@ bool SyncthingConfig::restore(const QString &configFilePath)
     return ok;
 }
 
+/*!
+ * \brief Returns whether the GUI is served on a Unix domain socket, eg. "unix:///run/syncthing/gui.sock".
+ * \remarks Syncthing also treats addresses which are absolute paths as socket addresses.
+ */
+bool SyncthingConfig::isGuiOnLocalSocket() const
+{
+    return guiAddress.startsWith(QLatin1String("unix://")) || guiAddress.startsWith(QChar('/'));
+}
+
+/*!
+ * \brief Returns the URL to connect to the GUI/REST API; see SyncthingConnection::setSyncthingUrl().
+ *
+ * A socket address is turned into a "unix://" URL. Otherwise HTTPS is used if the GUI enforces secure connections
+ * or is not listening on a loopback address.
+ */
+QString SyncthingConfig::syncthingUrl() const
+{
+    if(isGuiOnLocalSocket()) {
+        return guiAddress.startsWith(QChar('/')) ? (QStringLiteral("unix://") + guiAddress) : guiAddress;
+    }
+    return ((guiEnforcesSecureConnection || !QHostAddress(guiAddress.mid(0, guiAddress.indexOf(QChar(':')))).isLoopback()) ? QStringLiteral("https://") : QStringLiteral("http://")) + guiAddress;
+}
+
 } // namespace Data
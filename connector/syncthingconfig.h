@@ -20,6 +20,8 @@ struct LIB_SYNCTHING_CONNECTOR_EXPORT SyncthingConfig
     static QString locateConfigFile();
     static QString locateHttpsCertificate();
     bool restore(const QString &configFilePath);
+    bool isGuiOnLocalSocket() const;
+    QString syncthingUrl() const;
 };
 
 
@@ -1,6 +1,7 @@
 #include "./syncthingconnection.h"
 #include "./syncthingconfig.h"
 #include "./syncthingconnectionsettings.h"
+#include "./syncthinglocalsocketreply.h"
 #include "./utils.h"
 
 #include <c++utilities/conversion/conversionexception.h>
@@ -19,6 +20,7 @@
 #include <QHostAddress>
 #include <QNetworkInterface>
 
+#include <algorithm>
 #include <utility>
 #include <iostream>
 
@@ -29,14 +31,54 @@ using namespace ConversionUtilities;
 namespace Data {
 
 /*!
- * \brief Returns the QNetworkAccessManager instance used by SyncthingConnection instances.
+ * \brief The interval for polling events in standby mode (see SyncthingConnection::setStandby()).
  */
-QNetworkAccessManager &networkAccessManager()
+constexpr int standbyEventsPollInterval = 60000;
+
+/*!
+ * \enum SyncthingNetworkLane
+ * \brief The SyncthingNetworkLane enum specifies a group of requests which is sent via its own QNetworkAccessManager.
+ *
+ * Qt limits the number of concurrent connections per host and QNetworkAccessManager instance. Using a separate instance
+ * per lane ensures that the permanently pending events long-poll, periodic polling and asset loads of the web view do
+ * not delay commands triggered by the user. Connections are kept alive and reused within each lane.
+ *
+ * \var SyncthingNetworkLane::Commands
+ * Requests triggered by the user, eg. pausing, rescanning or restarting; sent with high priority.
+ * \var SyncthingNetworkLane::Polling
+ * Requests for configuration, status, statistics and periodic polling; sent with low priority.
+ * \var SyncthingNetworkLane::Events
+ * The events long-poll.
+ * \var SyncthingNetworkLane::WebView
+ * Requests of the web view.
+ */
+
+constexpr auto networkLaneCount = static_cast<size_t>(SyncthingNetworkLane::WebView) + 1;
+
+/*!
+ * \brief Returns the QNetworkAccessManager instance used for the specified \a lane.
+ */
+QNetworkAccessManager &networkAccessManager(SyncthingNetworkLane lane)
 {
-    static auto networkAccessManager = new QNetworkAccessManager;
+    static QNetworkAccessManager *networkAccessManagers[networkLaneCount] = {};
+    QNetworkAccessManager *&networkAccessManager = networkAccessManagers[static_cast<size_t>(lane)];
+    if(!networkAccessManager) {
+        networkAccessManager = new QNetworkAccessManager;
+    }
     return *networkAccessManager;
 }
 
+/*!
+ * \brief Sets the parent of the QNetworkAccessManager instances of all lanes to the specified \a parent.
+ * \remarks This allows the application to take ownership over the instances which are otherwise never destroyed.
+ */
+void setNetworkAccessManagerParent(QObject *parent)
+{
+    for(size_t lane = 0; lane != networkLaneCount; ++lane) {
+        networkAccessManager(static_cast<SyncthingNetworkLane>(lane)).setParent(parent);
+    }
+}
+
 /*!
  * \class SyncthingConnection
  * \brief The SyncthingConnection class allows Qt applications to access Syncthing.
@@ -56,6 +98,9 @@ SyncthingConnection::SyncthingConnection(const QString &syncthingUrl, const QByt
     m_lastEventId(0),
     m_trafficPollInterval(2000),
     m_devStatsPollInterval(60000),
+    m_requestTimeout(60000),
+    m_longPollingTimeout(60000),
+    m_abortedRequests(0),
     m_autoReconnectTimer(),
     m_autoReconnectTries(0),
     m_totalIncomingTraffic(0),
@@ -67,13 +112,27 @@ SyncthingConnection::SyncthingConnection(const QString &syncthingUrl, const QByt
     m_connectionsReply(nullptr),
     m_errorsReply(nullptr),
     m_eventsReply(nullptr),
+    m_connectProfile(SyncthingConnectProfile::Full),
+    m_requestingDirStatusOnConnect(false),
+    m_initialRequestFailed(false),
     m_unreadNotifications(false),
     m_hasConfig(false),
     m_hasStatus(false),
+    m_standby(false),
     m_lastFileDeleted(false)
 {
     m_autoReconnectTimer.setTimerType(Qt::VeryCoarseTimer);
     QObject::connect(&m_autoReconnectTimer, &QTimer::timeout, this, &SyncthingConnection::autoReconnect);
+
+    // setup timers for polling data there are no events for
+    for(QTimer *timer : {&m_trafficPollTimer, &m_devStatsPollTimer, &m_errorsPollTimer, &m_eventsPollTimer}) {
+        timer->setTimerType(Qt::VeryCoarseTimer);
+        timer->setSingleShot(true);
+    }
+    QObject::connect(&m_trafficPollTimer, &QTimer::timeout, this, &SyncthingConnection::requestConnections);
+    QObject::connect(&m_devStatsPollTimer, &QTimer::timeout, this, &SyncthingConnection::requestDeviceStatistics);
+    QObject::connect(&m_errorsPollTimer, &QTimer::timeout, this, &SyncthingConnection::requestErrors);
+    QObject::connect(&m_eventsPollTimer, &QTimer::timeout, this, &SyncthingConnection::requestEvents);
 }
 
 /*!
@@ -133,7 +192,11 @@ void SyncthingConnection::connect()
             return;
         }
         requestConfig();
-        requestStatus();
+        if(m_connectProfile & SyncthingConnectProfile::Status) {
+            requestStatus();
+        } else {
+            m_hasStatus = true;
+        }
         m_keepPolling = true;
     }
 }
@@ -157,7 +220,12 @@ void SyncthingConnection::disconnect()
 {
     m_reconnecting = m_hasConfig = m_hasStatus = false;
     m_autoReconnectTries = 0;
+    // the status is usually set when the events request is aborted
+    const bool pollingEvents = m_eventsReply;
     abortAllRequests();
+    if(!pollingEvents) {
+        setStatus(SyncthingStatus::Disconnected);
+    }
 }
 
 /*!
@@ -173,7 +241,12 @@ void SyncthingConnection::reconnect()
     if(isConnected()) {
         m_reconnecting = true;
         m_hasConfig = m_hasStatus = false;
+        // reconnecting usually continues when the events request is aborted
+        const bool pollingEvents = m_eventsReply;
         abortAllRequests();
+        if(!pollingEvents) {
+            continueReconnecting();
+        }
     } else {
         continueReconnecting();
     }
@@ -208,7 +281,11 @@ void SyncthingConnection::continueReconnecting()
     m_unreadNotifications = false;
     m_hasConfig = false;
     m_hasStatus = false;
+    m_rawConfig = QJsonObject();
+    abortInitialDirStatusRequests();
+    m_initialReplies.clear();
     m_dirs.clear();
+    m_dirPathIndex.clear();
     m_devs.clear();
     m_lastConnectionsUpdate = DateTime();
     m_lastFileTime = DateTime();
@@ -220,7 +297,11 @@ void SyncthingConnection::continueReconnecting()
         return;
     }
     requestConfig();
-    requestStatus();
+    if(m_connectProfile & SyncthingConnectProfile::Status) {
+        requestStatus();
+    } else {
+        m_hasStatus = true;
+    }
 }
 
 void SyncthingConnection::autoReconnect()
@@ -230,12 +311,220 @@ void SyncthingConnection::autoReconnect()
     m_autoReconnectTries = tmp + 1;
 }
 
+/*!
+ * \brief Sets whether the connection is in standby mode.
+ *
+ * In standby mode the connection is kept established but only events are polled (and only once per minute). Traffic,
+ * device statistics and errors are not polled at all. So the connection keeps an up-to-date picture of the directories
+ * and devices at low cost and can quickly be used again via swapState().
+ *
+ * When leaving standby mode, polling is resumed immediately.
+ */
+void SyncthingConnection::setStandby(bool standby)
+{
+    if(m_standby == standby) {
+        return;
+    }
+    if((m_standby = standby)) {
+        stopPollTimers();
+    } else {
+        continuePolling();
+    }
+}
+
+/*!
+ * \brief Swaps the settings and the entire state (config, directories, devices, status, ...) with the \a other connection.
+ *
+ * This allows switching between Syncthing instances without reconnecting. Objects connected to the signals of one
+ * connection (eg. models) see the state of the other connection afterwards. Therefore newConfig(), newDirs() and
+ * newDevices() as well as statusChanged() are emitted for both connections. The standby mode is not swapped.
+ *
+ * \remarks Pending requests for the state (see discardPendingReplies()) are aborted without emitting any signals.
+ *          Polling is continued immediately afterwards. Events are not lost as the last event ID is part of the
+ *          swapped state.
+ */
+void SyncthingConnection::swapState(SyncthingConnection &other)
+{
+    if(&other == this) {
+        return;
+    }
+
+    // abort pending requests silently so responses of one instance are not read into the state of the other, stop polling
+    for(SyncthingConnection *connection : {this, &other}) {
+        connection->abortInitialDirStatusRequests();
+        connection->discardPendingReplies();
+        connection->m_initialReplies.clear();
+        connection->stopPollTimers();
+        connection->m_autoReconnectTimer.stop();
+        connection->m_reconnecting = false;
+    }
+
+    // the config is about to change
+    emit newConfig(other.m_rawConfig);
+    emit other.newConfig(m_rawConfig);
+
+    // swap settings
+    m_syncthingUrl.swap(other.m_syncthingUrl);
+    m_apiKey.swap(other.m_apiKey);
+    m_user.swap(other.m_user);
+    m_password.swap(other.m_password);
+    m_restRequestTemplates.clear();
+    other.m_restRequestTemplates.clear();
+    m_responseCache.clear();
+    other.m_responseCache.clear();
+    m_expectedSslErrors.swap(other.m_expectedSslErrors);
+    swap(m_trafficPollInterval, other.m_trafficPollInterval);
+    swap(m_devStatsPollInterval, other.m_devStatsPollInterval);
+    swap(m_requestTimeout, other.m_requestTimeout);
+    swap(m_longPollingTimeout, other.m_longPollingTimeout);
+    swap(m_connectProfile, other.m_connectProfile);
+    const int autoReconnectInterval = m_autoReconnectTimer.interval();
+    m_autoReconnectTimer.setInterval(other.m_autoReconnectTimer.interval());
+    other.m_autoReconnectTimer.setInterval(autoReconnectInterval);
+
+    // swap state
+    swap(m_status, other.m_status);
+    swap(m_keepPolling, other.m_keepPolling);
+    swap(m_lastEventId, other.m_lastEventId);
+    swap(m_autoReconnectTries, other.m_autoReconnectTries);
+    m_configDir.swap(other.m_configDir);
+    m_myId.swap(other.m_myId);
+    swap(m_totalIncomingTraffic, other.m_totalIncomingTraffic);
+    swap(m_totalOutgoingTraffic, other.m_totalOutgoingTraffic);
+    swap(m_totalIncomingRate, other.m_totalIncomingRate);
+    swap(m_totalOutgoingRate, other.m_totalOutgoingRate);
+    swap(m_unreadNotifications, other.m_unreadNotifications);
+    swap(m_hasConfig, other.m_hasConfig);
+    swap(m_hasStatus, other.m_hasStatus);
+    m_rawConfig.swap(other.m_rawConfig);
+    m_dirs.swap(other.m_dirs);
+    m_dirPathIndex.clear();
+    other.m_dirPathIndex.clear();
+    m_syncedDirs.swap(other.m_syncedDirs);
+    m_completedDirs.swap(other.m_completedDirs);
+    m_devs.swap(other.m_devs);
+    swap(m_lastConnectionsUpdate, other.m_lastConnectionsUpdate);
+    swap(m_lastFileTime, other.m_lastFileTime);
+    swap(m_lastErrorTime, other.m_lastErrorTime);
+    m_lastFileName.swap(other.m_lastFileName);
+    swap(m_lastFileDeleted, other.m_lastFileDeleted);
+
+    // notify about the new state and continue polling
+    for(SyncthingConnection *connection : {this, &other}) {
+        emit connection->newDirs(connection->m_dirs);
+        emit connection->newDevices(connection->m_devs);
+        emit connection->configDirChanged(connection->m_configDir);
+        emit connection->myIdChanged(connection->m_myId);
+        emit connection->trafficChanged(connection->m_totalIncomingTraffic, connection->m_totalOutgoingTraffic);
+        emit connection->statusChanged(connection->m_status);
+        connection->continuePolling();
+    }
+}
+
+/*!
+ * \brief Sets which data is requested when connecting (and polled afterwards).
+ *
+ * By default, everything is requested (SyncthingConnectProfile::Full). Short-living clients (eg. syncthingctl) should
+ * only request what they actually need. If events are not requested, the connection is considered established
+ * (status is not SyncthingStatus::Disconnected or SyncthingStatus::Reconnecting anymore) when all requested data has
+ * been read. Otherwise the connection is considered established when the first events have been read.
+ *
+ * \remarks
+ * - Takes only effect when connecting the next time.
+ * - SyncthingConnectProfile::Config is added implicitly because the config is always requested.
+ */
+void SyncthingConnection::setConnectProfile(SyncthingConnectProfile connectProfile)
+{
+    m_connectProfile = connectProfile | SyncthingConnectProfile::Config;
+}
+
+/*!
+ * \brief Sets whether the status of directories is requested via "db/status" when connecting.
+ *
+ * The status of directories is usually only determined by "StateChanged" events. Hence directories are considered
+ * idling after connecting until the first event for them occurs. When enabled, the status of the directories is
+ * requested as one batch of (pipelined) requests before events are requested. So once the connection is considered
+ * established (status is not SyncthingStatus::Disconnected or SyncthingStatus::Reconnecting anymore), the status
+ * of the directories reflects the state at the time of connecting.
+ *
+ * The status is only requested for directories with the specified \a dirIds or for all directories if \a dirIds
+ * is empty.
+ *
+ * \remarks Takes only effect when connecting the next time.
+ */
+void SyncthingConnection::setRequestingDirStatusOnConnect(bool requestingDirStatus, const QStringList &dirIds)
+{
+    m_requestingDirStatusOnConnect = requestingDirStatus;
+    m_dirStatusOnConnectIds = dirIds;
+}
+
+/*!
+ * \brief Stops the timers used to poll data there are no events for.
+ */
+void SyncthingConnection::stopPollTimers()
+{
+    m_trafficPollTimer.stop();
+    m_devStatsPollTimer.stop();
+    m_errorsPollTimer.stop();
+    m_eventsPollTimer.stop();
+}
+
+/*!
+ * \brief Continues polling after leaving the standby mode or swapping the state; considers the standby mode.
+ */
+void SyncthingConnection::continuePolling()
+{
+    if(!m_keepPolling) {
+        return;
+    }
+    switch(m_status) {
+    case SyncthingStatus::Disconnected:
+        if(m_autoReconnectTimer.interval()) {
+            m_autoReconnectTimer.start();
+        }
+        return;
+    case SyncthingStatus::Reconnecting:
+        // the connection has not been established completely; just start over
+        m_hasConfig = false;
+        m_hasStatus = !(m_connectProfile & SyncthingConnectProfile::Status);
+        requestConfig();
+        if(!m_hasStatus) {
+            requestStatus();
+        }
+        return;
+    default:
+        ;
+    }
+    if(!m_standby) {
+        m_trafficPollTimer.stop();
+        if(!m_connectionsReply && (m_connectProfile & SyncthingConnectProfile::Connections)) {
+            requestConnections();
+        }
+        m_devStatsPollTimer.stop();
+        if((m_connectProfile & SyncthingConnectProfile::DevStatistics) && !readCachedResponse(QStringLiteral("stats/device"), &SyncthingConnection::parseDeviceStatistics)) {
+            requestDeviceStatistics();
+        }
+        if((m_connectProfile & SyncthingConnectProfile::DirStatistics) && !readCachedResponse(QStringLiteral("stats/folder"), &SyncthingConnection::parseDirStatistics)) {
+            requestDirStatistics();
+        }
+        m_errorsPollTimer.stop();
+        if(!m_errorsReply && (m_connectProfile & SyncthingConnectProfile::Errors)) {
+            requestErrors();
+        }
+    }
+    m_eventsPollTimer.stop();
+    if(!m_eventsReply && (m_connectProfile & SyncthingConnectProfile::Events)) {
+        requestEvents();
+    }
+}
+
 /*!
  * \brief Requests pausing the device with the specified ID.
  *
- * The signal error() is emitted when the request was not successful.
+ * The signal error() is emitted when the request was not successful. The returned reply is deleted after its
+ * finished() signal has been emitted; connect to it to be notified about the outcome of this particular request.
  */
-void SyncthingConnection::pause(const QString &devId)
+QNetworkReply *SyncthingConnection::pause(const QString &devId)
 {
     QUrlQuery query;
     query.addQueryItem(QStringLiteral("device"), devId);
@@ -243,6 +532,7 @@ void SyncthingConnection::pause(const QString &devId)
     reply->setProperty("devId", devId);
     reply->setProperty("resume", false);
     QObject::connect(reply, &QNetworkReply::finished, this, &SyncthingConnection::readPauseResume);
+    return reply;
 }
 
 /*!
@@ -260,9 +550,10 @@ void SyncthingConnection::pauseAllDevs()
 /*!
  * \brief Requests resuming the device with the specified ID.
  *
- * The signal error() is emitted when the request was not successful.
+ * The signal error() is emitted when the request was not successful. The returned reply is deleted after its
+ * finished() signal has been emitted; connect to it to be notified about the outcome of this particular request.
  */
-void SyncthingConnection::resume(const QString &devId)
+QNetworkReply *SyncthingConnection::resume(const QString &devId)
 {
     QUrlQuery query;
     query.addQueryItem(QStringLiteral("device"), devId);
@@ -270,6 +561,7 @@ void SyncthingConnection::resume(const QString &devId)
     reply->setProperty("devId", devId);
     reply->setProperty("resume", true);
     QObject::connect(reply, &QNetworkReply::finished, this, &SyncthingConnection::readPauseResume);
+    return reply;
 }
 
 /*!
@@ -286,16 +578,22 @@ void SyncthingConnection::resumeAllDevs()
 
 /*!
  * \brief Requests rescanning the directory with the specified ID.
+ * \param relpath Specifies a path relative to the directory to rescan only that file or sub directory.
  *
- * The signal error() is emitted when the request was not successful.
+ * The signal error() is emitted when the request was not successful. The returned reply is deleted after its
+ * finished() signal has been emitted; connect to it to be notified about the outcome of this particular request.
  */
-void SyncthingConnection::rescan(const QString &dirId)
+QNetworkReply *SyncthingConnection::rescan(const QString &dirId, const QString &relpath)
 {
     QUrlQuery query;
     query.addQueryItem(QStringLiteral("folder"), dirId);
+    if(!relpath.isEmpty()) {
+        query.addQueryItem(QStringLiteral("sub"), relpath);
+    }
     QNetworkReply *reply = postData(QStringLiteral("db/scan"), query);
     reply->setProperty("dirId", dirId);
     QObject::connect(reply, &QNetworkReply::finished, this, &SyncthingConnection::readRescan);
+    return reply;
 }
 
 /*!
@@ -310,6 +608,16 @@ void SyncthingConnection::rescanAllDirs()
     }
 }
 
+/*!
+ * \brief Requests the status of the directory with the specified ID via "db/status".
+ *
+ * The signal dirStatusChanged() is emitted on success; otherwise error() is emitted.
+ */
+void SyncthingConnection::requestDirStatus(const QString &dirId)
+{
+    QObject::connect(sendDirStatusRequest(dirId), &QNetworkReply::finished, this, &SyncthingConnection::readDirStatus);
+}
+
 /*!
  * \brief Requests Syncthing to restart.
  *
@@ -331,15 +639,16 @@ void SyncthingConnection::shutdown()
 }
 
 /*!
- * \brief Prepares a request for the specified \a path and \a query.
+ * \brief Returns a request for the specified \a path (relative to the Syncthing URL) containing the credentials and
+ *        headers but no query.
  */
-QNetworkRequest SyncthingConnection::prepareRequest(const QString &path, const QUrlQuery &query, bool rest)
+QNetworkRequest SyncthingConnection::makeRequestTemplate(const QString &path) const
 {
-    QUrl url(m_syncthingUrl);
-    url.setPath(rest ? (url.path() % QStringLiteral("/rest/") % path) : (url.path() + path));
+    // the host does not matter when using a local socket; only the path and query are sent
+    QUrl url(isUsingLocalSocket() ? QStringLiteral("http://localhost") : m_syncthingUrl);
+    url.setPath(url.path() + path);
     url.setUserName(user());
     url.setPassword(password());
-    url.setQuery(query);
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArray("application/x-www-form-urlencoded"));
     request.setRawHeader("X-API-Key", m_apiKey);
@@ -347,23 +656,269 @@ QNetworkRequest SyncthingConnection::prepareRequest(const QString &path, const Q
 }
 
 /*!
- * \brief Requests asynchronously data using the rest API.
+ * \brief Returns the request template for the REST API endpoint with the specified \a path.
+ *
+ * Templates are created on first use and kept until the URL, the API key or the credentials change so parsing the
+ * URL and setting the headers is not repeated for every request, eg. when polling.
+ */
+const QNetworkRequest &SyncthingConnection::restRequestTemplate(const QString &path)
+{
+    auto i = m_restRequestTemplates.find(path);
+    if(i == m_restRequestTemplates.end()) {
+        i = m_restRequestTemplates.insert(path, makeRequestTemplate(QStringLiteral("/rest/") + path));
+    }
+    return i.value();
+}
+
+/*!
+ * \brief Prepares a request for the specified \a path and \a query.
+ * \remarks Only the query is attached to the cached template if \a rest is true (see restRequestTemplate()).
+ */
+QNetworkRequest SyncthingConnection::prepareRequest(const QString &path, const QUrlQuery &query, bool rest)
+{
+    QNetworkRequest request(rest ? restRequestTemplate(path) : makeRequestTemplate(path));
+    if(!query.isEmpty()) {
+        QUrl url(request.url());
+        url.setQuery(query);
+        request.setUrl(url);
+    }
+    return request;
+}
+
+/*!
+ * \brief Sends the specified \a request using the transport for the current Syncthing URL.
+ *
+ * Requests are sent via the local socket if the Syncthing URL is a "unix://" URL (see SyncthingLocalSocketReply);
+ * otherwise they are sent via the networkAccessManager() of the specified \a lane. The reply is aborted when it has
+ * not finished within the specified \a deadline (see watchReply()).
  */
-QNetworkReply *SyncthingConnection::requestData(const QString &path, const QUrlQuery &query, bool rest)
+QNetworkReply *SyncthingConnection::sendRequest(SyncthingNetworkLane lane, QNetworkAccessManager::Operation operation, QNetworkRequest request, int deadline, const QByteArray &data)
 {
-    auto *reply = networkAccessManager().get(prepareRequest(path, query, rest));
-    reply->ignoreSslErrors(m_expectedSslErrors);
+    switch(lane) {
+    case SyncthingNetworkLane::Commands:
+        request.setPriority(QNetworkRequest::HighPriority);
+        break;
+    case SyncthingNetworkLane::Polling:
+        request.setPriority(QNetworkRequest::LowPriority);
+        break;
+    default:;
+    }
+    QNetworkReply *reply;
+    if(isUsingLocalSocket()) {
+        reply = new SyncthingLocalSocketReply(localSocketPath(), operation, request, data);
+    } else {
+        switch(operation) {
+        case QNetworkAccessManager::PostOperation:
+            reply = networkAccessManager(lane).post(request, data);
+            break;
+        default:
+            reply = networkAccessManager(lane).get(request);
+        }
+        reply->ignoreSslErrors(m_expectedSslErrors);
+    }
+    watchReply(reply, deadline);
+    // track requests for the state of the connection so they can be discarded (see discardPendingReplies())
+    if(lane == SyncthingNetworkLane::Polling) {
+        m_pollingReplies << reply;
+        QObject::connect(reply, &QNetworkReply::finished, this, [this, reply] {
+            m_pollingReplies.removeOne(reply);
+        });
+    }
     return reply;
 }
 
+/*!
+ * \brief Returns the deadline for requests to the endpoint with the specified \a path in milliseconds.
+ * \remarks
+ * - Syncthing only responds to "db/scan" when the scan has finished which takes arbitrarily long for big
+ *   directories. Hence those requests have no deadline.
+ * - The deadline of the long-poll is derived from the requested timeout in requestEvents().
+ */
+int SyncthingConnection::requestDeadline(const QString &path, SyncthingNetworkLane lane) const
+{
+    if(lane == SyncthingNetworkLane::Events || path == QLatin1String("db/scan")) {
+        return 0;
+    }
+    return m_requestTimeout;
+}
+
+/*!
+ * \enum SyncthingCachePolicy
+ * \brief The SyncthingCachePolicy enum specifies whether a response cached by SyncthingConnection might be used.
+ * \var SyncthingCachePolicy::Fresh
+ * The data is always requested from Syncthing; the response is cached nevertheless.
+ * \var SyncthingCachePolicy::CachedOrFresh
+ * A cached response is used if present and not expired; otherwise the data is requested from Syncthing.
+ */
+
+/*!
+ * \brief Returns how long responses of the endpoint with the specified \a path are cached in milliseconds.
+ * \remarks Responses of endpoints not listed here are not cached.
+ */
+static int responseCacheTtl(const QString &path)
+{
+    if(path == QLatin1String("/qr/")) {
+        return 24 * 60 * 60 * 1000; // the QR code only depends on the query
+    } else if(path.startsWith(QLatin1String("stats/"))) {
+        return 10 * 1000; // invalidated when related events are received
+    }
+    return 0;
+}
+
+/*!
+ * \brief Returns the key for caching the response for the specified \a path and \a query.
+ */
+static QString responseCacheKey(const QString &path, const QUrlQuery &query)
+{
+    return path % QChar('?') % query.query(QUrl::FullyEncoded);
+}
+
+/*!
+ * \brief Returns whether the specified \a reply has been aborted by the watchdog (and not intentionally).
+ */
+static bool isTimedOut(const QNetworkReply *reply)
+{
+    return reply->property("timedOut").toBool();
+}
+
+/*!
+ * \brief Returns a human-readable description of the error of the specified \a reply.
+ * \remarks Unlike QNetworkReply::errorString() this does not report aborts by the watchdog as cancellation.
+ */
+static QString replyErrorString(const QNetworkReply *reply)
+{
+    if(isTimedOut(reply)) {
+        return SyncthingConnection::tr("Request timed out (Syncthing did not respond within %1 seconds)").arg(reply->property("deadline").toInt() / 1000);
+    }
+    return reply->errorString();
+}
+
+/*!
+ * \brief Aborts the specified \a reply if it has not been finished within the specified \a deadline (in milliseconds).
+ *
+ * The reply is marked so the functions reading it can distinguish the abort from intentional aborts (see isTimedOut())
+ * and reissue the request. Does nothing if \a deadline is not positive.
+ */
+void SyncthingConnection::watchReply(QNetworkReply *reply, int deadline)
+{
+    if(deadline <= 0) {
+        return;
+    }
+    auto *const watchdog = new QTimer(reply);
+    watchdog->setSingleShot(true);
+    QObject::connect(reply, &QNetworkReply::finished, watchdog, &QTimer::stop);
+    QObject::connect(watchdog, &QTimer::timeout, this, [this, reply, deadline] {
+        if(reply->isFinished()) {
+            return;
+        }
+        ++m_abortedRequests;
+        reply->setProperty("timedOut", true);
+        reply->setProperty("deadline", deadline);
+        reply->abort();
+    });
+    watchdog->start(deadline);
+}
+
+/*!
+ * \brief Requests asynchronously data using the rest API.
+ * \remarks Requests are sent via the polling lane by default.
+ */
+QNetworkReply *SyncthingConnection::requestData(const QString &path, const QUrlQuery &query, bool rest, SyncthingNetworkLane lane)
+{
+    return sendRequest(lane, QNetworkAccessManager::GetOperation, prepareRequest(path, query, rest), requestDeadline(path, lane));
+}
+
+/*!
+ * \brief Requests asynchronously data from the specified \a path of the REST API.
+ * \remarks
+ * - Uses the same request as used internally so the overhead of the connector is taken into account, eg. when
+ *   measuring latency via syncthingctl bench.
+ * - The caller takes ownership over the returned reply.
+ */
+QNetworkReply *SyncthingConnection::requestRestData(const QString &path, const QUrlQuery &query)
+{
+    return requestData(path, query, true, SyncthingNetworkLane::Commands);
+}
+
+/*!
+ * \brief Requests asynchronously data from the specified \a path of the REST API, possibly served from the response
+ *        cache.
+ *
+ * The specified \a callback is called with the response on success; otherwise error() is emitted.
+ *
+ * \remarks
+ * - Responses of the statistics endpoints ("stats/folder" and "stats/device") are cached for an
+ *   endpoint-specific time. If \a cachePolicy is SyncthingCachePolicy::CachedOrFresh and a cached response is
+ *   present, \a callback is called immediately and an invalid connection is returned.
+ * - The returned connection can be used to disconnect \a callback before the response has been received.
+ */
+QMetaObject::Connection SyncthingConnection::requestRestData(const QString &path, const QUrlQuery &query, std::function<void(const QByteArray &)> callback, SyncthingCachePolicy cachePolicy)
+{
+    return requestCacheableData(path, query, true, cachePolicy, tr("Unable to request %1: ").arg(path), callback);
+}
+
+/*!
+ * \brief Calls \a callback with the cached response for \a path and \a query or requests the data and caches the
+ *        response; emits error() with the specified \a errorMessage on failure.
+ */
+QMetaObject::Connection SyncthingConnection::requestCacheableData(const QString &path, const QUrlQuery &query, bool rest, SyncthingCachePolicy cachePolicy, const QString &errorMessage, std::function<void (const QByteArray &)> callback)
+{
+    const QString cacheKey(responseCacheKey(path, query));
+    if(cachePolicy == SyncthingCachePolicy::CachedOrFresh) {
+        if(const QByteArray *const cachedResponse = m_responseCache.find(cacheKey)) {
+            callback(QByteArray(*cachedResponse));
+            return QMetaObject::Connection();
+        }
+    }
+    QNetworkReply *reply = requestData(path, query, rest, SyncthingNetworkLane::Commands);
+    const int ttl = responseCacheTtl(path);
+    return QObject::connect(reply, &QNetworkReply::finished, [this, reply, callback, cacheKey, ttl, errorMessage] {
+        reply->deleteLater();
+        switch(reply->error()) {
+        case QNetworkReply::NoError: {
+            const QByteArray response(reply->readAll());
+            m_responseCache.insert(cacheKey, response, ttl);
+            callback(response);
+            break;
+        } default:
+            emit error(errorMessage + replyErrorString(reply), SyncthingErrorCategory::SpecificRequest);
+        }
+    });
+}
+
+/*!
+ * \brief Passes the cached response for the endpoint with the specified \a path (and no query) to \a parse.
+ * \returns Returns whether a cached response was present.
+ */
+bool SyncthingConnection::readCachedResponse(const QString &path, void (SyncthingConnection::*parse)(const QByteArray &))
+{
+    const QByteArray *const cachedResponse = m_responseCache.find(responseCacheKey(path, QUrlQuery()));
+    if(!cachedResponse) {
+        return false;
+    }
+    (this->*parse)(QByteArray(*cachedResponse));
+    return true;
+}
+
 /*!
  * \brief Posts asynchronously data using the rest API.
+ * \remarks Posts are commands and hence sent via the command lane.
  */
 QNetworkReply *SyncthingConnection::postData(const QString &path, const QUrlQuery &query, const QByteArray &data)
 {
-    auto *reply = networkAccessManager().post(prepareRequest(path, query), data);
-    reply->ignoreSslErrors(m_expectedSslErrors);
-    return reply;
+    return sendRequest(SyncthingNetworkLane::Commands, QNetworkAccessManager::PostOperation, prepareRequest(path, query), requestDeadline(path, SyncthingNetworkLane::Commands), data);
+}
+
+/*!
+ * \brief Requests the status of the directory with the specified ID; HTTP pipelining is allowed for those requests.
+ */
+QNetworkReply *SyncthingConnection::sendDirStatusRequest(const QString &dirId)
+{
+    QUrlQuery query;
+    query.addQueryItem(QStringLiteral("folder"), dirId);
+    QNetworkRequest request(prepareRequest(QStringLiteral("db/status"), query));
+    request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+    return sendRequest(SyncthingNetworkLane::Polling, QNetworkAccessManager::GetOperation, request, m_requestTimeout);
 }
 
 /*!
@@ -383,6 +938,25 @@ SyncthingDir *SyncthingConnection::findDirInfo(const QString &dirId, int &row)
     return nullptr; // TODO: dir is unknown, trigger refreshing the config
 }
 
+/*!
+ * \brief Returns the directory info object for the innermost directory containing the specified local \a path.
+ * \param relativePath Is set to \a path relative to the directory.
+ * \returns Returns a pointer to the object or nullptr if \a path is not within any directory.
+ * \remarks
+ * - \a path is expected to be absolute.
+ * - An index over the directory paths is built on the first call after the directories have changed so the lookup
+ *   does not depend on the number of directories.
+ * - The returned object becomes invalid when the newDirs() signal is emitted or the connection is destroyed.
+ */
+SyncthingDir *SyncthingConnection::findDirInfoByPath(const QString &path, QString &relativePath, int &row)
+{
+    if(m_dirPathIndex.isEmpty()) {
+        m_dirPathIndex.build(m_dirs);
+    }
+    row = m_dirPathIndex.find(path, &relativePath);
+    return row >= 0 ? &m_dirs[static_cast<size_t>(row)] : nullptr;
+}
+
 /*!
  * \brief Appends a directory info object with the specified \a dirId to \a dirs.
  *
@@ -467,13 +1041,99 @@ SyncthingDev *SyncthingConnection::addDevInfo(std::vector<SyncthingDev> &devs, c
 void SyncthingConnection::continueConnecting()
 {
     if(m_keepPolling && m_hasConfig && m_hasStatus) {
-        requestConnections();
-        requestDirStatistics();
-        requestDeviceStatistics();
-        requestErrors();
-        // since config and status could be read successfully, let's poll for events
-        m_lastEventId = 0;
-        requestEvents();
+        // request only the data required according to the connect profile
+        m_initialReplies.clear();
+        m_initialRequestFailed = false;
+        if(m_connectProfile & SyncthingConnectProfile::Connections) {
+            trackInitialRequest(requestConnections());
+        }
+        // statistics rarely change so cached statistics are used when reconnecting
+        if((m_connectProfile & SyncthingConnectProfile::DirStatistics) && !readCachedResponse(QStringLiteral("stats/folder"), &SyncthingConnection::parseDirStatistics)) {
+            trackInitialRequest(requestDirStatistics());
+        }
+        if((m_connectProfile & SyncthingConnectProfile::DevStatistics) && !readCachedResponse(QStringLiteral("stats/device"), &SyncthingConnection::parseDeviceStatistics)) {
+            trackInitialRequest(requestDeviceStatistics());
+        }
+        if(m_connectProfile & SyncthingConnectProfile::Errors) {
+            trackInitialRequest(requestErrors());
+        }
+        // the current status of directories might be requested first; events are requested when it has been read
+        const bool requestingDirStatus = m_requestingDirStatusOnConnect && requestInitialDirStatus();
+        if(m_connectProfile & SyncthingConnectProfile::Events) {
+            // since config and status could be read successfully, let's poll for events
+            // -> the connection is considered established when the first events have been read
+            m_lastEventId = 0;
+            if(!requestingDirStatus) {
+                requestEvents();
+            }
+        } else if(!requestingDirStatus && m_initialReplies.isEmpty()) {
+            // without events the connection is considered established when all requested data has been read
+            setStatus(SyncthingStatus::Idle);
+        }
+    }
+}
+
+/*!
+ * \brief Ensures the connection is considered established when the specified \a reply and all other replies requested
+ *        when connecting have been read.
+ * \remarks Does nothing if events are part of the connect profile because then the connection is considered
+ *          established when the first events have been read.
+ * \remarks Must be called after connecting the slot which actually reads the reply.
+ */
+void SyncthingConnection::trackInitialRequest(QNetworkReply *reply)
+{
+    if(m_connectProfile & SyncthingConnectProfile::Events) {
+        return;
+    }
+    m_initialReplies << reply;
+    QObject::connect(reply, &QNetworkReply::finished, this, &SyncthingConnection::concludeInitialRequest);
+}
+
+/*!
+ * \brief Tracks the specified \a reply as initial request if it reissues \a timedOutReply which has been tracked as
+ *        initial request.
+ */
+void SyncthingConnection::trackReissuedRequest(QNetworkReply *timedOutReply, QNetworkReply *reply)
+{
+    if(m_initialReplies.contains(timedOutReply)) {
+        trackInitialRequest(reply);
+    }
+}
+
+/*!
+ * \brief Considers the connection established if all replies requested when connecting have been read successfully.
+ *
+ * If one of those replies could not be read, the connection is considered disconnected instead and auto-reconnect is
+ * scheduled (if enabled). The reader slot has already emitted error() in that case.
+ *
+ * \sa trackInitialRequest()
+ */
+void SyncthingConnection::concludeInitialRequest()
+{
+    auto *reply = static_cast<QNetworkReply *>(sender());
+    if(!m_initialReplies.removeOne(reply)) {
+        return;
+    }
+    switch(reply->error()) {
+    case QNetworkReply::NoError:
+        break;
+    case QNetworkReply::OperationCanceledError:
+        // aborted intentionally or reissued because the deadline has been exceeded
+        return;
+    default:
+        m_initialRequestFailed = true;
+    }
+    if(m_initialRequestFailed) {
+        m_initialReplies.clear();
+        m_initialRequestFailed = false;
+        setStatus(SyncthingStatus::Disconnected);
+        if(m_autoReconnectTimer.interval()) {
+            m_autoReconnectTimer.start();
+        }
+        return;
+    }
+    if(m_initialReplies.isEmpty() && m_keepPolling && m_hasConfig && !isConnected()) {
+        setStatus(SyncthingStatus::Idle);
     }
 }
 
@@ -482,6 +1142,9 @@ void SyncthingConnection::continueConnecting()
  */
 void SyncthingConnection::abortAllRequests()
 {
+    stopPollTimers();
+    abortInitialDirStatusRequests();
+    m_initialReplies.clear();
     if(m_configReply) {
         m_configReply->abort();
     }
@@ -499,6 +1162,26 @@ void SyncthingConnection::abortAllRequests()
     }
 }
 
+/*!
+ * \brief Aborts all pending requests for the state of the connection (everything polled and the events) without
+ *        reading the responses.
+ * \remarks Commands are not aborted; their outcome is still reported.
+ */
+void SyncthingConnection::discardPendingReplies()
+{
+    QList<QNetworkReply *> replies;
+    replies.swap(m_pollingReplies);
+    if(m_eventsReply) {
+        replies << m_eventsReply;
+    }
+    m_configReply = m_statusReply = m_connectionsReply = m_errorsReply = m_eventsReply = nullptr;
+    for(QNetworkReply *reply : replies) {
+        QObject::disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
 /*!
  * \brief Requests the Syncthing configuration asynchronously.
  *
@@ -524,9 +1207,10 @@ void SyncthingConnection::requestStatus()
  *
  * The signal devStatusChanged() is emitted for each device where the connection status has changed; error() is emitted in the error case.
  */
-void SyncthingConnection::requestConnections()
+QNetworkReply *SyncthingConnection::requestConnections()
 {
     QObject::connect(m_connectionsReply = requestData(QStringLiteral("system/connections"), QUrlQuery()), &QNetworkReply::finished, this, &SyncthingConnection::readConnections);
+    return m_connectionsReply;
 }
 
 /*!
@@ -534,25 +1218,30 @@ void SyncthingConnection::requestConnections()
  *
  * The signal newNotification() is emitted on success; error() is emitted in the error case.
  */
-void SyncthingConnection::requestErrors()
+QNetworkReply *SyncthingConnection::requestErrors()
 {
     QObject::connect(m_errorsReply = requestData(QStringLiteral("system/error"), QUrlQuery()), &QNetworkReply::finished, this, &SyncthingConnection::readErrors);
+    return m_errorsReply;
 }
 
 /*!
  * \brief Requests directory statistics asynchronously.
  */
-void SyncthingConnection::requestDirStatistics()
+QNetworkReply *SyncthingConnection::requestDirStatistics()
 {
-    QObject::connect(requestData(QStringLiteral("stats/folder"), QUrlQuery()), &QNetworkReply::finished, this, &SyncthingConnection::readDirStatistics);
+    QNetworkReply *const reply = requestData(QStringLiteral("stats/folder"), QUrlQuery());
+    QObject::connect(reply, &QNetworkReply::finished, this, &SyncthingConnection::readDirStatistics);
+    return reply;
 }
 
 /*!
  * \brief Requests device statistics asynchronously.
  */
-void SyncthingConnection::requestDeviceStatistics()
+QNetworkReply *SyncthingConnection::requestDeviceStatistics()
 {
-    QObject::connect(requestData(QStringLiteral("stats/device"), QUrlQuery()), &QNetworkReply::finished, this, &SyncthingConnection::readDeviceStatistics);
+    QNetworkReply *const reply = requestData(QStringLiteral("stats/device"), QUrlQuery());
+    QObject::connect(reply, &QNetworkReply::finished, this, &SyncthingConnection::readDeviceStatistics);
+    return reply;
 }
 
 /*!
@@ -566,39 +1255,81 @@ void SyncthingConnection::requestEvents()
     if(m_lastEventId) {
         query.addQueryItem(QStringLiteral("since"), QString::number(m_lastEventId));
     }
-    QObject::connect(m_eventsReply = requestData(QStringLiteral("events"), query), &QNetworkReply::finished, this, &SyncthingConnection::readEvents);
+    if(!m_eventTypes.isEmpty()) {
+        query.addQueryItem(QStringLiteral("events"), m_eventTypes.join(QChar(',')));
+    }
+    if(m_longPollingTimeout > 0) {
+        query.addQueryItem(QStringLiteral("timeout"), QString::number((m_longPollingTimeout + 999) / 1000));
+    }
+    QObject::connect(m_eventsReply = requestData(QStringLiteral("events"), query, true, SyncthingNetworkLane::Events), &QNetworkReply::finished, this, &SyncthingConnection::readEvents);
+    if(m_requestTimeout > 0) {
+        watchReply(m_eventsReply, max(m_longPollingTimeout, 0) + m_requestTimeout);
+    }
+}
+
+/*!
+ * \brief Requests the status of all relevant directories at once; called by continueConnecting().
+ * \returns Returns whether at least one request has been made. If so, requestEvents() is called by readDirStatus()
+ *          when all replies have been read.
+ */
+bool SyncthingConnection::requestInitialDirStatus()
+{
+    abortInitialDirStatusRequests();
+    for(const SyncthingDir &dir : m_dirs) {
+        if(m_dirStatusOnConnectIds.isEmpty() || m_dirStatusOnConnectIds.contains(dir.id)) {
+            QNetworkReply *const reply = sendDirStatusRequest(dir.id);
+            m_initialDirStatusReplies << reply;
+            QObject::connect(reply, &QNetworkReply::finished, this, &SyncthingConnection::readDirStatus);
+            trackInitialRequest(reply);
+        }
+    }
+    return !m_initialDirStatusReplies.isEmpty();
+}
+
+/*!
+ * \brief Aborts pending requests made by requestInitialDirStatus() without handling their replies.
+ */
+void SyncthingConnection::abortInitialDirStatusRequests()
+{
+    const QList<QNetworkReply *> replies(m_initialDirStatusReplies);
+    m_initialDirStatusReplies.clear();
+    for(QNetworkReply *reply : replies) {
+        QObject::disconnect(reply, nullptr, this, nullptr);
+        m_pollingReplies.removeOne(reply);
+        reply->abort();
+        reply->deleteLater();
+    }
 }
 
 /*!
  * \brief Requests a QR code for the specified \a text.
  *
  * The specified \a callback is called on success; otherwise error() is emitted.
+ *
+ * \remarks QR codes are cached; see requestRestData() for the semantics of \a cachePolicy.
  */
-QMetaObject::Connection SyncthingConnection::requestQrCode(const QString &text, std::function<void(const QByteArray &)> callback)
+QMetaObject::Connection SyncthingConnection::requestQrCode(const QString &text, std::function<void(const QByteArray &)> callback, SyncthingCachePolicy cachePolicy)
 {
     QUrlQuery query;
     query.addQueryItem(QStringLiteral("text"), text);
-    QNetworkReply *reply = requestData(QStringLiteral("/qr/"), query, false);
-    return QObject::connect(reply, &QNetworkReply::finished, [this, reply, callback] {
-        reply->deleteLater();
-        switch(reply->error()) {
-        case QNetworkReply::NoError:
-            callback(reply->readAll());
-            break;
-        default:
-            emit error(tr("Unable to request QR-Code: ") + reply->errorString(), SyncthingErrorCategory::SpecificRequest);
-        }
-    });
+    return requestCacheableData(QStringLiteral("/qr/"), query, false, cachePolicy, tr("Unable to request QR-Code: "), callback);
 }
 
 /*!
  * \brief Requests the Syncthing log.
+ * \param since Specifies a time (RFC 3339) to request only entries logged after that time; the "when" value of the
+ *        last entry received so far can be passed to poll for new entries.
  *
  * The specified \a callback is called on success; otherwise error() is emitted.
  */
-QMetaObject::Connection SyncthingConnection::requestLog(std::function<void (const std::vector<SyncthingLogEntry> &)> callback)
+QMetaObject::Connection SyncthingConnection::requestLog(std::function<void (const std::vector<SyncthingLogEntry> &)> callback, const QString &since)
 {
-    QNetworkReply *reply = requestData(QStringLiteral("system/log"), QUrlQuery());
+    QUrlQuery query;
+    if(!since.isEmpty()) {
+        // QUrlQuery does not encode '+' (which would be read as space) so it needs to be encoded explicitly
+        query.addQueryItem(QStringLiteral("since"), QString(since).replace(QChar('+'), QLatin1String("%2B")));
+    }
+    QNetworkReply *reply = requestData(QStringLiteral("system/log"), query, true, SyncthingNetworkLane::Commands);
     return QObject::connect(reply, &QNetworkReply::finished, [this, reply, callback] {
         reply->deleteLater();
         switch(reply->error()) {
@@ -611,7 +1342,7 @@ QMetaObject::Connection SyncthingConnection::requestLog(std::function<void (cons
                 logEntries.reserve(log.size());
                 for(const QJsonValue &logVal : log) {
                     const QJsonObject logObj(logVal.toObject());
-                    logEntries.emplace_back(logObj.value(QStringLiteral("when")).toString(), logObj.value(QStringLiteral("message")).toString());
+                    logEntries.emplace_back(logObj.value(QStringLiteral("when")).toString(), logObj.value(QStringLiteral("message")).toString(), logObj.value(QStringLiteral("level")).toInt(-1));
                 }
                 callback(logEntries);
             } else {
@@ -619,11 +1350,204 @@ QMetaObject::Connection SyncthingConnection::requestLog(std::function<void (cons
             }
             break;
         } default:
-            emit error(tr("Unable to request system log: ") + reply->errorString(), SyncthingErrorCategory::SpecificRequest);
+            emit error(tr("Unable to request system log: ") + replyErrorString(reply), SyncthingErrorCategory::SpecificRequest);
         }
     });
 }
 
+/*!
+ * \brief Serializes the specified \a dateTime for snapshot().
+ * \remarks The ticks are stored as string because JSON numbers can not represent them precisely.
+ */
+inline QJsonValue dateTimeToJson(DateTime dateTime)
+{
+    return dateTime.isNull() ? QJsonValue() : QJsonValue(QString::number(dateTime.totalTicks()));
+}
+
+/*!
+ * \brief Deserializes a date time serialized via dateTimeToJson().
+ */
+inline DateTime dateTimeFromJson(const QJsonValue &value)
+{
+    return DateTime(value.toString().toULongLong());
+}
+
+/*!
+ * \brief Returns a snapshot of the directory and device information known by the connection.
+ *
+ * The snapshot can be passed to restoreSnapshot() of another connection (possibly in another process) to make that
+ * information available without querying Syncthing again.
+ *
+ * \remarks The download progress of individual items is not part of the snapshot.
+ */
+QJsonObject SyncthingConnection::snapshot() const
+{
+    QJsonArray dirs;
+    for(const SyncthingDir &dir : m_dirs) {
+        QJsonArray errors;
+        for(const SyncthingDirError &error : dir.errors) {
+            errors.append(QJsonObject{{QStringLiteral("message"), error.message}, {QStringLiteral("path"), error.path}});
+        }
+        QJsonObject dirObj;
+        dirObj.insert(QStringLiteral("id"), dir.id);
+        dirObj.insert(QStringLiteral("label"), dir.label);
+        dirObj.insert(QStringLiteral("path"), dir.path);
+        dirObj.insert(QStringLiteral("devices"), QJsonArray::fromStringList(dir.devices));
+        dirObj.insert(QStringLiteral("readOnly"), dir.readOnly);
+        dirObj.insert(QStringLiteral("ignorePermissions"), dir.ignorePermissions);
+        dirObj.insert(QStringLiteral("autoNormalize"), dir.autoNormalize);
+        dirObj.insert(QStringLiteral("rescanInterval"), dir.rescanInterval);
+        dirObj.insert(QStringLiteral("minDiskFreePercentage"), dir.minDiskFreePercentage);
+        dirObj.insert(QStringLiteral("status"), static_cast<int>(dir.status));
+        dirObj.insert(QStringLiteral("lastStatusUpdate"), dateTimeToJson(dir.lastStatusUpdate));
+        dirObj.insert(QStringLiteral("progressPercentage"), dir.progressPercentage);
+        dirObj.insert(QStringLiteral("progressRate"), dir.progressRate);
+        dirObj.insert(QStringLiteral("errors"), errors);
+        dirObj.insert(QStringLiteral("globalBytes"), static_cast<double>(dir.globalBytes));
+        dirObj.insert(QStringLiteral("globalDeleted"), dir.globalDeleted);
+        dirObj.insert(QStringLiteral("globalFiles"), dir.globalFiles);
+        dirObj.insert(QStringLiteral("localBytes"), static_cast<double>(dir.localBytes));
+        dirObj.insert(QStringLiteral("localDeleted"), dir.localDeleted);
+        dirObj.insert(QStringLiteral("localFiles"), dir.localFiles);
+        dirObj.insert(QStringLiteral("neededBytes"), static_cast<double>(dir.neededByted));
+        dirObj.insert(QStringLiteral("neededFiles"), dir.neededFiles);
+        dirObj.insert(QStringLiteral("lastScanTime"), dateTimeToJson(dir.lastScanTime));
+        dirObj.insert(QStringLiteral("lastFileTime"), dateTimeToJson(dir.lastFileTime));
+        dirObj.insert(QStringLiteral("lastFileName"), dir.lastFileName);
+        dirObj.insert(QStringLiteral("lastFileDeleted"), dir.lastFileDeleted);
+        dirObj.insert(QStringLiteral("blocksAlreadyDownloaded"), dir.blocksAlreadyDownloaded);
+        dirObj.insert(QStringLiteral("blocksToBeDownloaded"), dir.blocksToBeDownloaded);
+        dirObj.insert(QStringLiteral("downloadPercentage"), static_cast<int>(dir.downloadPercentage));
+        dirObj.insert(QStringLiteral("downloadLabel"), dir.downloadLabel);
+        dirs.append(dirObj);
+    }
+    QJsonArray devs;
+    for(const SyncthingDev &dev : m_devs) {
+        QJsonObject devObj;
+        devObj.insert(QStringLiteral("id"), dev.id);
+        devObj.insert(QStringLiteral("name"), dev.name);
+        devObj.insert(QStringLiteral("addresses"), QJsonArray::fromStringList(dev.addresses));
+        devObj.insert(QStringLiteral("compression"), dev.compression);
+        devObj.insert(QStringLiteral("certName"), dev.certName);
+        devObj.insert(QStringLiteral("status"), static_cast<int>(dev.status));
+        devObj.insert(QStringLiteral("progressPercentage"), dev.progressPercentage);
+        devObj.insert(QStringLiteral("progressRate"), dev.progressRate);
+        devObj.insert(QStringLiteral("introducer"), dev.introducer);
+        devObj.insert(QStringLiteral("paused"), dev.paused);
+        devObj.insert(QStringLiteral("totalIncomingTraffic"), static_cast<double>(dev.totalIncomingTraffic));
+        devObj.insert(QStringLiteral("totalOutgoingTraffic"), static_cast<double>(dev.totalOutgoingTraffic));
+        devObj.insert(QStringLiteral("connectionAddress"), dev.connectionAddress);
+        devObj.insert(QStringLiteral("connectionType"), dev.connectionType);
+        devObj.insert(QStringLiteral("clientVersion"), dev.clientVersion);
+        devObj.insert(QStringLiteral("lastSeen"), dateTimeToJson(dev.lastSeen));
+        devs.append(devObj);
+    }
+    QJsonObject snapshot;
+    snapshot.insert(QStringLiteral("configDir"), m_configDir);
+    snapshot.insert(QStringLiteral("myId"), m_myId);
+    snapshot.insert(QStringLiteral("totalIncomingTraffic"), static_cast<double>(m_totalIncomingTraffic));
+    snapshot.insert(QStringLiteral("totalOutgoingTraffic"), static_cast<double>(m_totalOutgoingTraffic));
+    snapshot.insert(QStringLiteral("dirs"), dirs);
+    snapshot.insert(QStringLiteral("devs"), devs);
+    return snapshot;
+}
+
+/*!
+ * \brief Restores the directory and device information from the specified \a snapshot.
+ *
+ * The signals newDirs() and newDevices() are emitted. The status of the connection itself is not altered.
+ *
+ * \returns Returns whether the snapshot could be restored; the current information is not touched otherwise.
+ * \sa snapshot()
+ */
+bool SyncthingConnection::restoreSnapshot(const QJsonObject &snapshot)
+{
+    const QJsonValue dirsVal(snapshot.value(QStringLiteral("dirs"))), devsVal(snapshot.value(QStringLiteral("devs")));
+    if(!dirsVal.isArray() || !devsVal.isArray()) {
+        return false;
+    }
+
+    const QJsonArray dirs(dirsVal.toArray());
+    vector<SyncthingDir> newDirs;
+    newDirs.reserve(static_cast<size_t>(dirs.size()));
+    for(const QJsonValue &dirVal : dirs) {
+        const QJsonObject dirObj(dirVal.toObject());
+        newDirs.emplace_back(dirObj.value(QStringLiteral("id")).toString(), dirObj.value(QStringLiteral("label")).toString(), dirObj.value(QStringLiteral("path")).toString());
+        SyncthingDir &dir = newDirs.back();
+        for(const QJsonValue &devVal : dirObj.value(QStringLiteral("devices")).toArray()) {
+            dir.devices << devVal.toString();
+        }
+        dir.readOnly = dirObj.value(QStringLiteral("readOnly")).toBool(false);
+        dir.ignorePermissions = dirObj.value(QStringLiteral("ignorePermissions")).toBool(false);
+        dir.autoNormalize = dirObj.value(QStringLiteral("autoNormalize")).toBool(false);
+        dir.rescanInterval = dirObj.value(QStringLiteral("rescanInterval")).toInt(-1);
+        dir.minDiskFreePercentage = dirObj.value(QStringLiteral("minDiskFreePercentage")).toInt(-1);
+        dir.status = static_cast<SyncthingDirStatus>(dirObj.value(QStringLiteral("status")).toInt(static_cast<int>(SyncthingDirStatus::Unknown)));
+        dir.lastStatusUpdate = dateTimeFromJson(dirObj.value(QStringLiteral("lastStatusUpdate")));
+        dir.progressPercentage = dirObj.value(QStringLiteral("progressPercentage")).toInt();
+        dir.progressRate = dirObj.value(QStringLiteral("progressRate")).toInt();
+        for(const QJsonValue &errorVal : dirObj.value(QStringLiteral("errors")).toArray()) {
+            const QJsonObject errorObj(errorVal.toObject());
+            dir.errors.emplace_back(errorObj.value(QStringLiteral("message")).toString(), errorObj.value(QStringLiteral("path")).toString());
+        }
+        dir.globalBytes = static_cast<uint64>(dirObj.value(QStringLiteral("globalBytes")).toDouble(0.0));
+        dir.globalDeleted = dirObj.value(QStringLiteral("globalDeleted")).toInt();
+        dir.globalFiles = dirObj.value(QStringLiteral("globalFiles")).toInt();
+        dir.localBytes = static_cast<uint64>(dirObj.value(QStringLiteral("localBytes")).toDouble(0.0));
+        dir.localDeleted = dirObj.value(QStringLiteral("localDeleted")).toInt();
+        dir.localFiles = dirObj.value(QStringLiteral("localFiles")).toInt();
+        dir.neededByted = static_cast<uint64>(dirObj.value(QStringLiteral("neededBytes")).toDouble(0.0));
+        dir.neededFiles = dirObj.value(QStringLiteral("neededFiles")).toInt();
+        dir.lastScanTime = dateTimeFromJson(dirObj.value(QStringLiteral("lastScanTime")));
+        dir.lastFileTime = dateTimeFromJson(dirObj.value(QStringLiteral("lastFileTime")));
+        dir.lastFileName = dirObj.value(QStringLiteral("lastFileName")).toString();
+        dir.lastFileDeleted = dirObj.value(QStringLiteral("lastFileDeleted")).toBool(false);
+        dir.blocksAlreadyDownloaded = dirObj.value(QStringLiteral("blocksAlreadyDownloaded")).toInt();
+        dir.blocksToBeDownloaded = dirObj.value(QStringLiteral("blocksToBeDownloaded")).toInt();
+        dir.downloadPercentage = static_cast<unsigned int>(dirObj.value(QStringLiteral("downloadPercentage")).toInt());
+        dir.downloadLabel = dirObj.value(QStringLiteral("downloadLabel")).toString();
+    }
+
+    const QJsonArray devs(devsVal.toArray());
+    vector<SyncthingDev> newDevs;
+    newDevs.reserve(static_cast<size_t>(devs.size()));
+    for(const QJsonValue &devVal : devs) {
+        const QJsonObject devObj(devVal.toObject());
+        newDevs.emplace_back(devObj.value(QStringLiteral("id")).toString(), devObj.value(QStringLiteral("name")).toString());
+        SyncthingDev &dev = newDevs.back();
+        for(const QJsonValue &addrVal : devObj.value(QStringLiteral("addresses")).toArray()) {
+            dev.addresses << addrVal.toString();
+        }
+        dev.compression = devObj.value(QStringLiteral("compression")).toString();
+        dev.certName = devObj.value(QStringLiteral("certName")).toString();
+        dev.status = static_cast<SyncthingDevStatus>(devObj.value(QStringLiteral("status")).toInt(static_cast<int>(SyncthingDevStatus::Unknown)));
+        dev.progressPercentage = devObj.value(QStringLiteral("progressPercentage")).toInt();
+        dev.progressRate = devObj.value(QStringLiteral("progressRate")).toInt();
+        dev.introducer = devObj.value(QStringLiteral("introducer")).toBool(false);
+        dev.paused = devObj.value(QStringLiteral("paused")).toBool(false);
+        dev.totalIncomingTraffic = static_cast<uint64>(devObj.value(QStringLiteral("totalIncomingTraffic")).toDouble(0.0));
+        dev.totalOutgoingTraffic = static_cast<uint64>(devObj.value(QStringLiteral("totalOutgoingTraffic")).toDouble(0.0));
+        dev.connectionAddress = devObj.value(QStringLiteral("connectionAddress")).toString();
+        dev.connectionType = devObj.value(QStringLiteral("connectionType")).toString();
+        dev.clientVersion = devObj.value(QStringLiteral("clientVersion")).toString();
+        dev.lastSeen = dateTimeFromJson(devObj.value(QStringLiteral("lastSeen")));
+    }
+
+    m_configDir = snapshot.value(QStringLiteral("configDir")).toString();
+    m_myId = snapshot.value(QStringLiteral("myId")).toString();
+    m_totalIncomingTraffic = static_cast<uint64>(snapshot.value(QStringLiteral("totalIncomingTraffic")).toDouble(0.0));
+    m_totalOutgoingTraffic = static_cast<uint64>(snapshot.value(QStringLiteral("totalOutgoingTraffic")).toDouble(0.0));
+    emit newConfig(QJsonObject()); // models expect newConfig() to be emitted before newDirs()/newDevices()
+    m_syncedDirs.clear();
+    m_completedDirs.clear();
+    m_dirs.swap(newDirs);
+    m_dirPathIndex.clear();
+    m_devs.swap(newDevs);
+    emit this->newDirs(m_dirs);
+    emit this->newDevices(m_devs);
+    return true;
+}
+
 /*!
  * \brief Locates and loads the (self-signed) certificate used by the Syncthing GUI.
  * \remarks
@@ -735,7 +1659,7 @@ void SyncthingConnection::readConfig()
         const QJsonDocument replyDoc = QJsonDocument::fromJson(reply->readAll(), &jsonError);
         if(jsonError.error == QJsonParseError::NoError) {
             const QJsonObject replyObj(replyDoc.object());
-            emit newConfig(replyObj);
+            emit newConfig(m_rawConfig = replyObj);
             readDirs(replyObj.value(QStringLiteral("folders")).toArray());
             readDevs(replyObj.value(QStringLiteral("devices")).toArray());
             m_hasConfig = true;
@@ -747,9 +1671,12 @@ void SyncthingConnection::readConfig()
         }
         break;
     } case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply) && m_keepPolling) {
+            requestConfig();
+        }
         return; // intended, not an error
     default:
-        emit error(tr("Unable to request Syncthing config: ") + reply->errorString(), SyncthingErrorCategory::OverallConnection);
+        emit error(tr("Unable to request Syncthing config: ") + replyErrorString(reply), SyncthingErrorCategory::OverallConnection);
         setStatus(SyncthingStatus::Disconnected);
         if(m_autoReconnectTimer.interval()) {
             m_autoReconnectTimer.start();
@@ -784,6 +1711,7 @@ void SyncthingConnection::readDirs(const QJsonArray &dirs)
         }
     }
     m_dirs.swap(newDirs);
+    m_dirPathIndex.clear();
     m_syncedDirs.reserve(m_dirs.size());
     emit this->newDirs(m_dirs);
 }
@@ -851,9 +1779,12 @@ void SyncthingConnection::readStatus()
         }
         break;
     } case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply) && m_keepPolling) {
+            requestStatus();
+        }
         return; // intended, not an error
     default:
-        emit error(tr("Unable to request Syncthing status: ") + reply->errorString(), SyncthingErrorCategory::OverallConnection);
+        emit error(tr("Unable to request Syncthing status: ") + replyErrorString(reply), SyncthingErrorCategory::OverallConnection);
     }
 }
 
@@ -924,17 +1855,21 @@ void SyncthingConnection::readConnections()
             m_lastConnectionsUpdate = DateTime::gmtNow();
 
             // since there seems no event for this data, just request every 2 seconds
-            if(m_keepPolling) {
-                QTimer::singleShot(m_trafficPollInterval, Qt::VeryCoarseTimer, this, &SyncthingConnection::requestConnections);
+            if(m_keepPolling && !m_standby) {
+                m_trafficPollTimer.start(m_trafficPollInterval);
             }
         } else {
             emit error(tr("Unable to parse connections: ") + jsonError.errorString(), SyncthingErrorCategory::Parsing);
+            m_initialRequestFailed = true;
         }
         break;
     } case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply) && m_keepPolling) {
+            trackReissuedRequest(reply, requestConnections());
+        }
         return; // intended, not an error
     default:
-        emit error(tr("Unable to request connections: ") + reply->errorString(), SyncthingErrorCategory::OverallConnection);
+        emit error(tr("Unable to request connections: ") + replyErrorString(reply), SyncthingErrorCategory::OverallConnection);
     }
 }
 
@@ -948,63 +1883,79 @@ void SyncthingConnection::readDirStatistics()
 
     switch(reply->error()) {
     case QNetworkReply::NoError: {
-        QJsonParseError jsonError;
-        const QJsonDocument replyDoc = QJsonDocument::fromJson(reply->readAll(), &jsonError);
-        if(jsonError.error == QJsonParseError::NoError) {
-            const QJsonObject replyObj(replyDoc.object());
-            int index = 0;
-            for(SyncthingDir &dirInfo : m_dirs) {
-                const QJsonObject dirObj(replyObj.value(dirInfo.id).toObject());
-                if(!dirObj.isEmpty()) {
-                    bool mod = false;
-                    try {
-                        dirInfo.lastScanTime = DateTime::fromIsoStringLocal(dirObj.value(QStringLiteral("lastScan")).toString().toUtf8().data());
-                        mod = true;
-                    } catch(const ConversionException &) {
-                        dirInfo.lastScanTime = DateTime();
-                    }
-                    const QJsonObject lastFileObj(dirObj.value(QStringLiteral("lastFile")).toObject());
-                    if(!lastFileObj.isEmpty()) {
-                        dirInfo.lastFileName = lastFileObj.value(QStringLiteral("filename")).toString();
-                        mod = true;
-                        if(!dirInfo.lastFileName.isEmpty()) {
-                            dirInfo.lastFileDeleted = lastFileObj.value(QStringLiteral("deleted")).toBool(false);
-                            try {
-                                dirInfo.lastFileTime = DateTime::fromIsoStringLocal(lastFileObj.value(QStringLiteral("at")).toString().toUtf8().data());
-                                if(dirInfo.lastFileTime > m_lastFileTime) {
-                                    m_lastFileTime = dirInfo.lastFileTime,
-                                    m_lastFileName = dirInfo.lastFileName,
-                                    m_lastFileDeleted = dirInfo.lastFileDeleted;
-                                }
-                            } catch(const ConversionException &) {
-                                dirInfo.lastFileTime = DateTime();
+        const QByteArray response(reply->readAll());
+        m_responseCache.insert(responseCacheKey(QStringLiteral("stats/folder"), QUrlQuery()), response, responseCacheTtl(QStringLiteral("stats/folder")));
+        parseDirStatistics(response);
+        break;
+    } case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply) && m_keepPolling) {
+            trackReissuedRequest(reply, requestDirStatistics());
+        }
+        return; // intended, not an error
+    default:
+        emit error(tr("Unable to request directory statistics: ") + replyErrorString(reply), SyncthingErrorCategory::OverallConnection);
+    }
+}
+
+/*!
+ * \brief Parses the directory statistics; called by readDirStatistics() and when cached statistics are used.
+ */
+void SyncthingConnection::parseDirStatistics(const QByteArray &response)
+{
+    QJsonParseError jsonError;
+    const QJsonDocument replyDoc = QJsonDocument::fromJson(response, &jsonError);
+    if(jsonError.error == QJsonParseError::NoError) {
+        const QJsonObject replyObj(replyDoc.object());
+        int index = 0;
+        for(SyncthingDir &dirInfo : m_dirs) {
+            const QJsonObject dirObj(replyObj.value(dirInfo.id).toObject());
+            if(!dirObj.isEmpty()) {
+                bool mod = false;
+                try {
+                    dirInfo.lastScanTime = DateTime::fromIsoStringLocal(dirObj.value(QStringLiteral("lastScan")).toString().toUtf8().data());
+                    mod = true;
+                } catch(const ConversionException &) {
+                    dirInfo.lastScanTime = DateTime();
+                }
+                const QJsonObject lastFileObj(dirObj.value(QStringLiteral("lastFile")).toObject());
+                if(!lastFileObj.isEmpty()) {
+                    dirInfo.lastFileName = lastFileObj.value(QStringLiteral("filename")).toString();
+                    mod = true;
+                    if(!dirInfo.lastFileName.isEmpty()) {
+                        dirInfo.lastFileDeleted = lastFileObj.value(QStringLiteral("deleted")).toBool(false);
+                        try {
+                            dirInfo.lastFileTime = DateTime::fromIsoStringLocal(lastFileObj.value(QStringLiteral("at")).toString().toUtf8().data());
+                            if(dirInfo.lastFileTime > m_lastFileTime) {
+                                m_lastFileTime = dirInfo.lastFileTime,
+                                m_lastFileName = dirInfo.lastFileName,
+                                m_lastFileDeleted = dirInfo.lastFileDeleted;
                             }
+                        } catch(const ConversionException &) {
+                            dirInfo.lastFileTime = DateTime();
                         }
                     }
-                    if(mod) {
-                        emit dirStatusChanged(dirInfo, index);
-                    }
                 }
-                ++index;
+                if(mod) {
+                    emit dirStatusChanged(dirInfo, index);
+                }
             }
-        } else {
-            emit error(tr("Unable to parse directory statistics: ") + jsonError.errorString(), SyncthingErrorCategory::Parsing);
+            ++index;
         }
-        break;
-    } case QNetworkReply::OperationCanceledError:
-        return; // intended, not an error
-    default:
-        emit error(tr("Unable to request directory statistics: ") + reply->errorString(), SyncthingErrorCategory::OverallConnection);
+    } else {
+        emit error(tr("Unable to parse directory statistics: ") + jsonError.errorString(), SyncthingErrorCategory::Parsing);
+        m_initialRequestFailed = true;
+        m_responseCache.invalidate(QStringLiteral("stats/folder"));
     }
 }
 
 /*!
- * \brief Reads results of requestDeviceStatistics().
+ * \brief Reads results of requestDirStatus() and requestInitialDirStatus().
  */
-void SyncthingConnection::readDeviceStatistics()
+void SyncthingConnection::readDirStatus()
 {
     auto *reply = static_cast<QNetworkReply *>(sender());
     reply->deleteLater();
+    const bool initial = m_initialDirStatusReplies.removeOne(reply);
 
     switch(reply->error()) {
     case QNetworkReply::NoError: {
@@ -1012,31 +1963,117 @@ void SyncthingConnection::readDeviceStatistics()
         const QJsonDocument replyDoc = QJsonDocument::fromJson(reply->readAll(), &jsonError);
         if(jsonError.error == QJsonParseError::NoError) {
             const QJsonObject replyObj(replyDoc.object());
-            int index = 0;
-            for(SyncthingDev &devInfo : m_devs) {
-                const QJsonObject devObj(replyObj.value(devInfo.id).toObject());
-                if(!devObj.isEmpty()) {
-                    try {
-                        devInfo.lastSeen = DateTime::fromIsoStringLocal(devObj.value(QStringLiteral("lastSeen")).toString().toUtf8().data());
-                        emit devStatusChanged(devInfo, index);
-                    } catch(const ConversionException &) {
-                        devInfo.lastSeen = DateTime();
-                    }
+            int index;
+            if(SyncthingDir *dirInfo = findDirInfo(QUrlQuery(reply->request().url()).queryItemValue(QStringLiteral("folder")), index)) {
+                readDirSummary(*dirInfo, replyObj);
+                // use the time of the last state change so only more recent "StateChanged" events take precedence
+                DateTime stateChanged;
+                try {
+                    stateChanged = DateTime::fromIsoStringGmt(replyObj.value(QStringLiteral("stateChanged")).toString().toUtf8().data());
+                } catch(const ConversionException &) {
+                    stateChanged = DateTime::gmtNow();
                 }
-                ++index;
-            }
-            // since there seems no event for this data, just request every minute
-            if(m_keepPolling) {
-                QTimer::singleShot(m_devStatsPollInterval, Qt::VeryCoarseTimer, this, &SyncthingConnection::requestDeviceStatistics);
+                dirInfo->assignStatus(replyObj.value(QStringLiteral("state")).toString(), stateChanged);
+                if(dirInfo->status == SyncthingDirStatus::Synchronizing && dirInfo->globalBytes > 0) {
+                    dirInfo->progressPercentage = dirInfo->globalBytes > dirInfo->neededByted ? static_cast<int>((dirInfo->globalBytes - dirInfo->neededByted) * 100 / dirInfo->globalBytes) : 0;
+                }
+                emit dirStatusChanged(*dirInfo, index);
             }
         } else {
-            emit error(tr("Unable to parse device statistics: ") + jsonError.errorString(), SyncthingErrorCategory::Parsing);
+            emit error(tr("Unable to parse status for directory: ") + jsonError.errorString(), SyncthingErrorCategory::Parsing);
+            m_initialRequestFailed = true;
+        }
+        break;
+    } case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply) && m_keepPolling) {
+            QNetworkReply *const newReply = sendDirStatusRequest(QUrlQuery(reply->request().url()).queryItemValue(QStringLiteral("folder")));
+            QObject::connect(newReply, &QNetworkReply::finished, this, &SyncthingConnection::readDirStatus);
+            if(initial) {
+                m_initialDirStatusReplies << newReply;
+            }
+            trackReissuedRequest(reply, newReply);
         }
+        return; // intended, not an error
+    default:
+        emit error(tr("Unable to request directory status: ") + replyErrorString(reply), SyncthingErrorCategory::SpecificRequest);
+    }
+
+    // continue connecting when the status of all directories has been read
+    if(initial && m_initialDirStatusReplies.isEmpty() && m_keepPolling && (m_connectProfile & SyncthingConnectProfile::Events)) {
+        requestEvents();
+    }
+}
+
+/*!
+ * \brief Reads the statistics of the specified \a summary (provided by "FolderSummary" events and "db/status").
+ */
+void SyncthingConnection::readDirSummary(SyncthingDir &dirInfo, const QJsonObject &summary)
+{
+    // note: sizes might exceed the range of int; QJsonValue stores all numbers as double (exact up to 2^53)
+    dirInfo.globalBytes = static_cast<uint64>(summary.value(QStringLiteral("globalBytes")).toDouble());
+    dirInfo.globalDeleted = summary.value(QStringLiteral("globalDeleted")).toInt();
+    dirInfo.globalFiles = summary.value(QStringLiteral("globalFiles")).toInt();
+    dirInfo.localBytes = static_cast<uint64>(summary.value(QStringLiteral("localBytes")).toDouble());
+    dirInfo.localDeleted = summary.value(QStringLiteral("localDeleted")).toInt();
+    dirInfo.localFiles = summary.value(QStringLiteral("localFiles")).toInt();
+    dirInfo.neededByted = static_cast<uint64>(summary.value(QStringLiteral("needBytes")).toDouble());
+    dirInfo.neededFiles = summary.value(QStringLiteral("needFiles")).toInt();
+}
+
+/*!
+ * \brief Reads results of requestDeviceStatistics().
+ */
+void SyncthingConnection::readDeviceStatistics()
+{
+    auto *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    switch(reply->error()) {
+    case QNetworkReply::NoError: {
+        const QByteArray response(reply->readAll());
+        m_responseCache.insert(responseCacheKey(QStringLiteral("stats/device"), QUrlQuery()), response, responseCacheTtl(QStringLiteral("stats/device")));
+        parseDeviceStatistics(response);
         break;
     } case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply) && m_keepPolling) {
+            trackReissuedRequest(reply, requestDeviceStatistics());
+        }
         return; // intended, not an error
     default:
-        emit error(tr("Unable to request device statistics: ") + reply->errorString(), SyncthingErrorCategory::OverallConnection);
+        emit error(tr("Unable to request device statistics: ") + replyErrorString(reply), SyncthingErrorCategory::OverallConnection);
+    }
+}
+
+/*!
+ * \brief Parses the device statistics; called by readDeviceStatistics() and when cached statistics are used.
+ */
+void SyncthingConnection::parseDeviceStatistics(const QByteArray &response)
+{
+    QJsonParseError jsonError;
+    const QJsonDocument replyDoc = QJsonDocument::fromJson(response, &jsonError);
+    if(jsonError.error == QJsonParseError::NoError) {
+        const QJsonObject replyObj(replyDoc.object());
+        int index = 0;
+        for(SyncthingDev &devInfo : m_devs) {
+            const QJsonObject devObj(replyObj.value(devInfo.id).toObject());
+            if(!devObj.isEmpty()) {
+                try {
+                    devInfo.lastSeen = DateTime::fromIsoStringLocal(devObj.value(QStringLiteral("lastSeen")).toString().toUtf8().data());
+                    emit devStatusChanged(devInfo, index);
+                } catch(const ConversionException &) {
+                    devInfo.lastSeen = DateTime();
+                }
+            }
+            ++index;
+        }
+        // since there seems no event for this data, just request every minute
+        if(m_keepPolling && !m_standby) {
+            m_devStatsPollTimer.start(m_devStatsPollInterval);
+        }
+    } else {
+        emit error(tr("Unable to parse device statistics: ") + jsonError.errorString(), SyncthingErrorCategory::Parsing);
+        m_initialRequestFailed = true;
+        m_responseCache.invalidate(QStringLiteral("stats/device"));
     }
 }
 
@@ -1075,17 +2112,21 @@ void SyncthingConnection::readErrors()
             }
         } else {
             emit error(tr("Unable to parse errors: ") + jsonError.errorString(), SyncthingErrorCategory::Parsing);
+            m_initialRequestFailed = true;
         }
 
         // since there seems no event for this data, just request every thirty seconds, FIXME: make interval configurable
-        if(m_keepPolling) {
-            QTimer::singleShot(30000, Qt::VeryCoarseTimer, this, SLOT(requestErrors()));
+        if(m_keepPolling && !m_standby) {
+            m_errorsPollTimer.start(30000);
         }
         break;
     } case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply) && m_keepPolling) {
+            trackReissuedRequest(reply, requestErrors());
+        }
         return; // intended, not an error
     default:
-        emit error(tr("Unable to request errors: ") + reply->errorString(), SyncthingErrorCategory::OverallConnection);
+        emit error(tr("Unable to request errors: ") + replyErrorString(reply), SyncthingErrorCategory::OverallConnection);
     }
 }
 
@@ -1126,15 +2167,20 @@ void SyncthingConnection::readEvents()
                 } else if(eventType == QLatin1String("DownloadProgress")) {
                     readDownloadProgressEvent(eventTime, eventData);
                 } else if(eventType.startsWith(QLatin1String("Folder"))) {
+                    m_responseCache.invalidate(QStringLiteral("stats/folder"));
                     readDirEvent(eventTime, eventType, eventData);
                 } else if(eventType.startsWith(QLatin1String("Device"))) {
+                    m_responseCache.invalidate(QStringLiteral("stats/device"));
                     readDeviceEvent(eventTime, eventType, eventData);
                 } else if(eventType == QLatin1String("ItemStarted")) {
                     readItemStarted(eventTime, eventData);
                 } else if(eventType == QLatin1String("ItemFinished")) {
+                    m_responseCache.invalidate(QStringLiteral("stats/folder"));
                     readItemFinished(eventTime, eventData);
                 } else if(eventType == QLatin1String("ConfigSaved")) {
-                    requestConfig(); // just consider current config as invalidated
+                    // just consider current config and data depending on it as invalidated
+                    m_responseCache.invalidate(QStringLiteral("stats/"));
+                    requestConfig();
                 }
             }
         } else {
@@ -1150,6 +2196,10 @@ void SyncthingConnection::readEvents()
         // no new events available, keep polling
         break;
     case QNetworkReply::OperationCanceledError:
+        if(isTimedOut(reply)) {
+            // aborted by the watchdog, the connection might be stuck so just issue a new request
+            break;
+        }
         // intended disconnect, not an error
         if(m_reconnecting) {
             // if reconnection flag is set, instantly etstablish a new connection ...
@@ -1160,7 +2210,7 @@ void SyncthingConnection::readEvents()
         }
         return;
     default:
-        emit error(tr("Unable to request Syncthing events: ") + reply->errorString(), SyncthingErrorCategory::OverallConnection);
+        emit error(tr("Unable to request Syncthing events: ") + replyErrorString(reply), SyncthingErrorCategory::OverallConnection);
         setStatus(SyncthingStatus::Disconnected);
         if(m_autoReconnectTimer.interval()) {
             m_autoReconnectTimer.start();
@@ -1169,7 +2219,12 @@ void SyncthingConnection::readEvents()
     }
 
     if(m_keepPolling) {
-        requestEvents();
+        if(m_standby) {
+            // no events get lost when polling only rarely because the next request asks for all events since the last one
+            m_eventsPollTimer.start(standbyEventsPollInterval);
+        } else {
+            requestEvents();
+        }
         setStatus(SyncthingStatus::Idle);
     } else {
         setStatus(SyncthingStatus::Disconnected);
@@ -1274,7 +2329,7 @@ void SyncthingConnection::readDirEvent(DateTime eventTime, const QString &eventT
                                 // emit newNotification() for new errors
                                 auto &previousErrors = dirInfo->previousErrors;
                                 if(find(previousErrors.cbegin(), previousErrors.cend(), dirInfo->errors.back()) == previousErrors.cend()) {
-                                    emitNotification(eventTime, dirInfo->errors.back().message);
+                                    emitNotification(eventTime, dirInfo->errors.back().message, dirInfo->id);
                                 }
                             }
                         }
@@ -1285,14 +2340,7 @@ void SyncthingConnection::readDirEvent(DateTime eventTime, const QString &eventT
                 // check for summary
                 const QJsonObject summary(eventData.value(QStringLiteral("summary")).toObject());
                 if(!summary.isEmpty()) {
-                    dirInfo->globalBytes = summary.value(QStringLiteral("globalBytes")).toInt();
-                    dirInfo->globalDeleted = summary.value(QStringLiteral("globalDeleted")).toInt();
-                    dirInfo->globalFiles = summary.value(QStringLiteral("globalFiles")).toInt();
-                    dirInfo->localBytes = summary.value(QStringLiteral("localBytes")).toInt();
-                    dirInfo->localDeleted = summary.value(QStringLiteral("localDeleted")).toInt();
-                    dirInfo->localFiles = summary.value(QStringLiteral("localFiles")).toInt();
-                    dirInfo->neededByted = summary.value(QStringLiteral("needByted")).toInt();
-                    dirInfo->neededFiles = summary.value(QStringLiteral("needFiles")).toInt();
+                    readDirSummary(*dirInfo, summary);
                     // FIXME: dirInfo->assignStatus(summary.value(QStringLiteral("state")).toString());
                     emit dirStatusChanged(*dirInfo, index);
                 }
@@ -1405,7 +2453,7 @@ void SyncthingConnection::readItemFinished(DateTime eventTime, const QJsonObject
                 dirInfo->errors.emplace_back(error, item);
                 dirInfo->status = SyncthingDirStatus::OutOfSync;
                 emit dirStatusChanged(*dirInfo, index);
-                emitNotification(eventTime, error);
+                emitNotification(eventTime, error, dirInfo->id);
             }
         }
     }
@@ -1423,7 +2471,7 @@ void SyncthingConnection::readRescan()
         emit rescanTriggered(reply->property("dirId").toString());
         break;
     default:
-        emit error(tr("Unable to request rescan: ") + reply->errorString(), SyncthingErrorCategory::SpecificRequest);
+        emit error(tr("Unable to request rescan: ") + replyErrorString(reply), SyncthingErrorCategory::SpecificRequest);
     }
 }
 
@@ -1443,7 +2491,7 @@ void SyncthingConnection::readPauseResume()
         }
         break;
     default:
-        emit error(tr("Unable to request pause/resume: ") + reply->errorString(), SyncthingErrorCategory::SpecificRequest);
+        emit error(tr("Unable to request pause/resume: ") + replyErrorString(reply), SyncthingErrorCategory::SpecificRequest);
     }
 }
 
@@ -1459,7 +2507,7 @@ void SyncthingConnection::readRestart()
         emit restartTriggered();
         break;
     default:
-        emit error(tr("Unable to request restart: ") + reply->errorString(), SyncthingErrorCategory::SpecificRequest);
+        emit error(tr("Unable to request restart: ") + replyErrorString(reply), SyncthingErrorCategory::SpecificRequest);
     }
 }
 
@@ -1475,7 +2523,7 @@ void SyncthingConnection::readShutdown()
         emit shutdownTriggered();
         break;
     default:
-        emit error(tr("Unable to request shutdown: ") + reply->errorString(), SyncthingErrorCategory::SpecificRequest);
+        emit error(tr("Unable to request shutdown: ") + replyErrorString(reply), SyncthingErrorCategory::SpecificRequest);
     }
 }
 
@@ -1547,11 +2595,11 @@ void SyncthingConnection::setStatus(SyncthingStatus status)
  * \brief Interanlly called to emit the notification with the specified \a message.
  * \remarks Ensures the status is updated and the unread notifications flag is set.
  */
-void SyncthingConnection::emitNotification(DateTime when, const QString &message)
+void SyncthingConnection::emitNotification(DateTime when, const QString &message, const QString &dirId)
 {
     m_unreadNotifications = true;
     setStatus(status());
-    emit newNotification(when, message);
+    emit newNotification(when, message, dirId);
 }
 
 /*!
@@ -1599,6 +2647,7 @@ void SyncthingConnection::emitNotification(DateTime when, const QString &message
 /*!
  * \fn SyncthingConnection::newNotification()
  * \brief Indicates a new Syncthing notification is available.
+ * \remarks The \a dirId is only set if the notification relates to a particular directory.
  */
 
 /*!
@@ -3,27 +3,46 @@
 
 #include "./syncthingdir.h"
 #include "./syncthingdev.h"
+#include "./syncthingdirpathindex.h"
+#include "./syncthingresponsecache.h"
 
+#include <QNetworkAccessManager>
 #include <QObject>
+#include <QJsonObject>
+#include <QHash>
+#include <QNetworkRequest>
 #include <QList>
+#include <QStringList>
 #include <QSslError>
 #include <QTimer>
 
 #include <functional>
 #include <vector>
 
-QT_FORWARD_DECLARE_CLASS(QNetworkAccessManager)
 QT_FORWARD_DECLARE_CLASS(QNetworkReply)
-QT_FORWARD_DECLARE_CLASS(QNetworkRequest)
 QT_FORWARD_DECLARE_CLASS(QUrlQuery)
-QT_FORWARD_DECLARE_CLASS(QJsonObject)
 QT_FORWARD_DECLARE_CLASS(QJsonArray)
 
 namespace Data {
 
 struct SyncthingConnectionSettings;
 
-QNetworkAccessManager LIB_SYNCTHING_CONNECTOR_EXPORT &networkAccessManager();
+enum class SyncthingNetworkLane
+{
+    Commands,
+    Polling,
+    Events,
+    WebView
+};
+
+enum class SyncthingCachePolicy
+{
+    Fresh,
+    CachedOrFresh
+};
+
+QNetworkAccessManager LIB_SYNCTHING_CONNECTOR_EXPORT &networkAccessManager(SyncthingNetworkLane lane = SyncthingNetworkLane::Commands);
+void LIB_SYNCTHING_CONNECTOR_EXPORT setNetworkAccessManagerParent(QObject *parent);
 
 enum class SyncthingStatus
 {
@@ -37,6 +56,33 @@ enum class SyncthingStatus
     BeingDestroyed
 };
 
+/*!
+ * \brief Specifies which data is requested when connecting (and polled afterwards).
+ * \remarks The config is always requested because it is required to know directories and devices at all. Hence
+ *          SyncthingConnection::setConnectProfile() always adds SyncthingConnectProfile::Config.
+ */
+enum class SyncthingConnectProfile
+{
+    Config = 0x1, /**< the config ("system/config"), always set */
+    Status = 0x2, /**< the status ("system/status", provides own device ID and config dir) */
+    Connections = 0x4, /**< connections and traffic ("system/connections"), polled */
+    DirStatistics = 0x8, /**< directory statistics ("stats/folder") */
+    DevStatistics = 0x10, /**< device statistics ("stats/device"), polled */
+    Errors = 0x20, /**< errors/notifications ("system/error"), polled */
+    Events = 0x40, /**< events ("events"), long-polled */
+    Full = Config | Status | Connections | DirStatistics | DevStatistics | Errors | Events /**< everything (the default) */
+};
+
+constexpr SyncthingConnectProfile operator|(SyncthingConnectProfile lhs, SyncthingConnectProfile rhs)
+{
+    return static_cast<SyncthingConnectProfile>(static_cast<int>(lhs) | static_cast<int>(rhs));
+}
+
+constexpr bool operator&(SyncthingConnectProfile lhs, SyncthingConnectProfile rhs)
+{
+    return static_cast<int>(lhs) & static_cast<int>(rhs);
+}
+
 enum class SyncthingErrorCategory
 {
     OverallConnection,
@@ -46,12 +92,14 @@ enum class SyncthingErrorCategory
 
 struct LIB_SYNCTHING_CONNECTOR_EXPORT SyncthingLogEntry
 {
-    SyncthingLogEntry(const QString &when, const QString &message) :
+    SyncthingLogEntry(const QString &when, const QString &message, int level = -1) :
         when(when),
-        message(message)
+        message(message),
+        level(level)
     {}
     QString when;
     QString message;
+    int level;
 };
 
 class LIB_SYNCTHING_CONNECTOR_EXPORT SyncthingConnection : public QObject
@@ -64,6 +112,8 @@ class LIB_SYNCTHING_CONNECTOR_EXPORT SyncthingConnection : public QObject
     Q_PROPERTY(bool hasOutOfSyncDirs READ hasOutOfSyncDirs)
     Q_PROPERTY(int trafficPollInterval READ trafficPollInterval WRITE setTrafficPollInterval)
     Q_PROPERTY(int devStatsPollInterval READ devStatsPollInterval WRITE setDevStatsPollInterval)
+    Q_PROPERTY(int requestTimeout READ requestTimeout WRITE setRequestTimeout)
+    Q_PROPERTY(int longPollingTimeout READ longPollingTimeout WRITE setLongPollingTimeout)
     Q_PROPERTY(QString configDir READ configDir NOTIFY configDirChanged)
     Q_PROPERTY(QString myId READ myId NOTIFY myIdChanged)
     Q_PROPERTY(int totalIncomingTraffic READ totalIncomingTraffic NOTIFY trafficChanged)
@@ -91,6 +141,11 @@ public:
     void setTrafficPollInterval(int trafficPollInterval);
     int devStatsPollInterval() const;
     void setDevStatsPollInterval(int devStatsPollInterval);
+    int requestTimeout() const;
+    void setRequestTimeout(int requestTimeout);
+    int longPollingTimeout() const;
+    void setLongPollingTimeout(int longPollingTimeout);
+    uint64 abortedRequests() const;
     int autoReconnectInterval() const;
     unsigned int autoReconnectTries() const;
     void setAutoReconnectInterval(int interval);
@@ -102,13 +157,28 @@ public:
     double totalOutgoingRate() const;
     const std::vector<SyncthingDir> &dirInfo() const;
     const std::vector<SyncthingDev> &devInfo() const;
-    QMetaObject::Connection requestQrCode(const QString &text, std::function<void (const QByteArray &)> callback);
-    QMetaObject::Connection requestLog(std::function<void (const std::vector<SyncthingLogEntry> &)> callback);
+    QMetaObject::Connection requestQrCode(const QString &text, std::function<void (const QByteArray &)> callback, SyncthingCachePolicy cachePolicy = SyncthingCachePolicy::CachedOrFresh);
+    QNetworkReply *requestRestData(const QString &path, const QUrlQuery &query);
+    QMetaObject::Connection requestRestData(const QString &path, const QUrlQuery &query, std::function<void (const QByteArray &)> callback, SyncthingCachePolicy cachePolicy = SyncthingCachePolicy::CachedOrFresh);
+    SyncthingResponseCache &responseCache();
+    QMetaObject::Connection requestLog(std::function<void (const std::vector<SyncthingLogEntry> &)> callback, const QString &since = QString());
     const QList<QSslError> &expectedSslErrors();
     SyncthingDir *findDirInfo(const QString &dirId, int &row);
+    SyncthingDir *findDirInfoByPath(const QString &path, QString &relativePath, int &row);
     SyncthingDev *findDevInfo(const QString &devId, int &row);
     SyncthingDev *findDevInfoByName(const QString &devName, int &row);
     const std::vector<SyncthingDir *> &completedDirs() const;
+    QJsonObject snapshot() const;
+    bool restoreSnapshot(const QJsonObject &snapshot);
+    bool isStandby() const;
+    void setStandby(bool standby);
+    void swapState(SyncthingConnection &other);
+    SyncthingConnectProfile connectProfile() const;
+    void setConnectProfile(SyncthingConnectProfile connectProfile);
+    bool isRequestingDirStatusOnConnect() const;
+    void setRequestingDirStatusOnConnect(bool requestingDirStatus, const QStringList &dirIds = QStringList());
+    const QStringList &eventTypes() const;
+    void setEventTypes(const QStringList &eventTypes);
 
 public Q_SLOTS:
     bool loadSelfSignedCertificate();
@@ -118,12 +188,13 @@ public Q_SLOTS:
     void disconnect();
     void reconnect();
     void reconnect(SyncthingConnectionSettings &connectionSettings);
-    void pause(const QString &devId);
+    QNetworkReply *pause(const QString &devId);
     void pauseAllDevs();
-    void resume(const QString &devId);
+    QNetworkReply *resume(const QString &devId);
     void resumeAllDevs();
-    void rescan(const QString &dirId);
+    QNetworkReply *rescan(const QString &dirId, const QString &relpath = QString());
     void rescanAllDirs();
+    void requestDirStatus(const QString &dirId);
     void restart();
     void shutdown();
     void considerAllNotificationsRead();
@@ -136,7 +207,7 @@ Q_SIGNALS:
     void dirStatusChanged(const SyncthingDir &dir, int index);
     void devStatusChanged(const SyncthingDev &dev, int index);
     void downloadProgressChanged();
-    void newNotification(ChronoUtilities::DateTime when, const QString &message);
+    void newNotification(ChronoUtilities::DateTime when, const QString &message, const QString &dirId);
     void error(const QString &errorMessage, SyncthingErrorCategory category);
     void statusChanged(SyncthingStatus newStatus);
     void configDirChanged(const QString &newConfigDir);
@@ -151,12 +222,15 @@ Q_SIGNALS:
 private Q_SLOTS:
     void requestConfig();
     void requestStatus();
-    void requestConnections();
-    void requestErrors();
-    void requestDirStatistics();
-    void requestDeviceStatistics();
+    QNetworkReply *requestConnections();
+    QNetworkReply *requestErrors();
+    QNetworkReply *requestDirStatistics();
+    QNetworkReply *requestDeviceStatistics();
     void requestEvents();
+    bool requestInitialDirStatus();
+    void abortInitialDirStatusRequests();
     void abortAllRequests();
+    void discardPendingReplies();
 
     void readConfig();
     void readDirs(const QJsonArray &dirs);
@@ -164,7 +238,11 @@ private Q_SLOTS:
     void readStatus();
     void readConnections();
     void readDirStatistics();
+    void parseDirStatistics(const QByteArray &response);
+    void readDirStatus();
+    void readDirSummary(SyncthingDir &dirInfo, const QJsonObject &summary);
     void readDeviceStatistics();
+    void parseDeviceStatistics(const QByteArray &response);
     void readErrors();
     void readEvents();
     void readStartingEvent(const QJsonObject &eventData);
@@ -180,15 +258,30 @@ private Q_SLOTS:
     void readShutdown();
 
     void continueConnecting();
+    void trackInitialRequest(QNetworkReply *reply);
+    void trackReissuedRequest(QNetworkReply *timedOutReply, QNetworkReply *reply);
+    void concludeInitialRequest();
     void continueReconnecting();
     void autoReconnect();
+    void stopPollTimers();
+    void continuePolling();
     void setStatus(SyncthingStatus status);
-    void emitNotification(ChronoUtilities::DateTime when, const QString &message);
+    void emitNotification(ChronoUtilities::DateTime when, const QString &message, const QString &dirId = QString());
 
 private:
+    bool isUsingLocalSocket() const;
+    QString localSocketPath() const;
+    QNetworkRequest makeRequestTemplate(const QString &path) const;
+    const QNetworkRequest &restRequestTemplate(const QString &path);
+    QMetaObject::Connection requestCacheableData(const QString &path, const QUrlQuery &query, bool rest, SyncthingCachePolicy cachePolicy, const QString &errorMessage, std::function<void (const QByteArray &)> callback);
+    bool readCachedResponse(const QString &path, void (SyncthingConnection::*parse)(const QByteArray &));
     QNetworkRequest prepareRequest(const QString &path, const QUrlQuery &query, bool rest = true);
-    QNetworkReply *requestData(const QString &path, const QUrlQuery &query, bool rest = true);
+    void watchReply(QNetworkReply *reply, int deadline);
+    QNetworkReply *sendRequest(SyncthingNetworkLane lane, QNetworkAccessManager::Operation operation, QNetworkRequest request, int deadline, const QByteArray &data = QByteArray());
+    int requestDeadline(const QString &path, SyncthingNetworkLane lane) const;
+    QNetworkReply *requestData(const QString &path, const QUrlQuery &query, bool rest = true, SyncthingNetworkLane lane = SyncthingNetworkLane::Polling);
     QNetworkReply *postData(const QString &path, const QUrlQuery &query, const QByteArray &data = QByteArray());
+    QNetworkReply *sendDirStatusRequest(const QString &dirId);
     SyncthingDir *addDirInfo(std::vector<SyncthingDir> &dirs, const QString &dirId);
     SyncthingDev *addDevInfo(std::vector<SyncthingDev> &devs, const QString &devId);
 
@@ -202,6 +295,9 @@ private:
     int m_lastEventId;
     int m_trafficPollInterval;
     int m_devStatsPollInterval;
+    int m_requestTimeout;
+    int m_longPollingTimeout;
+    uint64 m_abortedRequests;
     QTimer m_autoReconnectTimer;
     unsigned int m_autoReconnectTries;
     QString m_configDir;
@@ -215,10 +311,25 @@ private:
     QNetworkReply *m_connectionsReply;
     QNetworkReply *m_errorsReply;
     QNetworkReply *m_eventsReply;
+    QList<QNetworkReply *> m_initialDirStatusReplies;
+    QList<QNetworkReply *> m_initialReplies;
+    QList<QNetworkReply *> m_pollingReplies;
+    SyncthingConnectProfile m_connectProfile;
+    bool m_requestingDirStatusOnConnect;
+    bool m_initialRequestFailed;
+    QStringList m_dirStatusOnConnectIds;
+    QStringList m_eventTypes;
     bool m_unreadNotifications;
     bool m_hasConfig;
     bool m_hasStatus;
+    bool m_standby;
+    QTimer m_trafficPollTimer;
+    QTimer m_devStatsPollTimer;
+    QTimer m_errorsPollTimer;
+    QTimer m_eventsPollTimer;
+    QJsonObject m_rawConfig;
     std::vector<SyncthingDir> m_dirs;
+    SyncthingDirPathIndex m_dirPathIndex;
     std::vector<SyncthingDir *> m_syncedDirs;
     std::vector<SyncthingDir *> m_completedDirs;
     std::vector<SyncthingDev> m_devs;
@@ -228,6 +339,8 @@ private:
     QString m_lastFileName;
     bool m_lastFileDeleted;
     QList<QSslError> m_expectedSslErrors;
+    QHash<QString, QNetworkRequest> m_restRequestTemplates;
+    SyncthingResponseCache m_responseCache;
 };
 
 /*!
@@ -244,6 +357,24 @@ inline const QString &SyncthingConnection::syncthingUrl() const
 inline void SyncthingConnection::setSyncthingUrl(const QString &url)
 {
     m_syncthingUrl = url;
+    m_restRequestTemplates.clear();
+    m_responseCache.clear();
+}
+
+/*!
+ * \brief Returns whether the Syncthing URL refers to a local socket (eg. "unix:///run/syncthing/gui.sock").
+ */
+inline bool SyncthingConnection::isUsingLocalSocket() const
+{
+    return m_syncthingUrl.startsWith(QLatin1String("unix://"));
+}
+
+/*!
+ * \brief Returns the path of the local socket if isUsingLocalSocket() returns true.
+ */
+inline QString SyncthingConnection::localSocketPath() const
+{
+    return m_syncthingUrl.mid(7);
 }
 
 /*!
@@ -256,10 +387,13 @@ inline const QByteArray &SyncthingConnection::apiKey() const
 
 /*!
  * \brief Sets the API key used to connect to Syncthing.
+ * \remarks Cached responses are discarded as they have been received using the previous API key.
  */
 inline void SyncthingConnection::setApiKey(const QByteArray &apiKey)
 {
     m_apiKey = apiKey;
+    m_restRequestTemplates.clear();
+    m_responseCache.clear();
 }
 
 /*!
@@ -280,10 +414,13 @@ inline const QString &SyncthingConnection::password() const
 
 /*!
  * \brief Provides credentials used for HTTP authentication.
+ * \remarks Cached responses are discarded as they have been received using the previous credentials.
  */
 inline void SyncthingConnection::setCredentials(const QString &user, const QString &password)
 {
     m_user = user, m_password = password;
+    m_restRequestTemplates.clear();
+    m_responseCache.clear();
 }
 
 /*!
@@ -319,6 +456,55 @@ inline void SyncthingConnection::considerAllNotificationsRead()
     m_unreadNotifications = false;
 }
 
+/*!
+ * \brief Returns which data is requested when connecting.
+ * \sa setConnectProfile()
+ */
+inline SyncthingConnectProfile SyncthingConnection::connectProfile() const
+{
+    return m_connectProfile;
+}
+
+/*!
+ * \brief Returns whether the status of directories is requested via "db/status" when connecting.
+ * \sa setRequestingDirStatusOnConnect()
+ */
+inline bool SyncthingConnection::isRequestingDirStatusOnConnect() const
+{
+    return m_requestingDirStatusOnConnect;
+}
+
+/*!
+ * \brief Returns the types of events requested or an empty list if all events are requested.
+ * \sa setEventTypes()
+ */
+inline const QStringList &SyncthingConnection::eventTypes() const
+{
+    return m_eventTypes;
+}
+
+/*!
+ * \brief Sets the types of events to request (eg. "StateChanged"); all events are requested if \a eventTypes is empty.
+ * \remarks
+ * - The filtering is done by Syncthing so events of other types are not even transferred.
+ * - The state of the connection is only updated by received events. So this is only useful when only the events
+ *   themselves are of interest (see newEvents()).
+ * - Takes effect on the next events request.
+ */
+inline void SyncthingConnection::setEventTypes(const QStringList &eventTypes)
+{
+    m_eventTypes = eventTypes;
+}
+
+/*!
+ * \brief Returns whether the connection is in standby mode.
+ * \sa setStandby()
+ */
+inline bool SyncthingConnection::isStandby() const
+{
+    return m_standby;
+}
+
 /*!
  * \brief Returns the interval for polling traffic status (which currently can not be received via event API) in milliseconds.
  * \remarks Default value is 2000 milliseconds.
@@ -355,6 +541,70 @@ inline void SyncthingConnection::setDevStatsPollInterval(int devStatsPollInterva
     m_devStatsPollInterval = devStatsPollInterval;
 }
 
+/*!
+ * \brief Returns the deadline for requests in milliseconds.
+ *
+ * Requests which have not been finished when the deadline is exceeded are aborted and reissued (except commands which
+ * are only reported as failed). This prevents polling from stalling forever on half-open connections.
+ *
+ * \remarks
+ * - Default value is 60000 milliseconds. A value of zero disables the deadline.
+ * - Some endpoints use a different deadline, eg. rescan requests have none because Syncthing only responds when the
+ *   scan has finished (see requestDeadline()).
+ */
+inline int SyncthingConnection::requestTimeout() const
+{
+    return m_requestTimeout;
+}
+
+/*!
+ * \brief Sets the deadline for requests in milliseconds.
+ * \sa requestTimeout()
+ */
+inline void SyncthingConnection::setRequestTimeout(int requestTimeout)
+{
+    m_requestTimeout = requestTimeout;
+}
+
+/*!
+ * \brief Returns the time in milliseconds Syncthing is asked to keep the events request pending when no new events occur.
+ *
+ * The deadline of the events request is this timeout plus requestTimeout().
+ *
+ * \remarks Default value is 60000 milliseconds which is also the default of Syncthing. Syncthing only supports whole
+ *          seconds.
+ */
+inline int SyncthingConnection::longPollingTimeout() const
+{
+    return m_longPollingTimeout;
+}
+
+/*!
+ * \brief Sets the time in milliseconds Syncthing is asked to keep the events request pending.
+ * \sa longPollingTimeout()
+ */
+inline void SyncthingConnection::setLongPollingTimeout(int longPollingTimeout)
+{
+    m_longPollingTimeout = longPollingTimeout;
+}
+
+/*!
+ * \brief Returns the cache for responses of REST API endpoints which rarely change.
+ * \remarks The cache can be used to adjust its limits or to clear it. It is cleared when the URL changes.
+ */
+inline SyncthingResponseCache &SyncthingConnection::responseCache()
+{
+    return m_responseCache;
+}
+
+/*!
+ * \brief Returns the number of requests which have been aborted because their deadline has been exceeded.
+ */
+inline uint64 SyncthingConnection::abortedRequests() const
+{
+    return m_abortedRequests;
+}
+
 /*!
  * \brief Returns the reconnect interval in milliseconds.
  * \remarks Default value is 0 which indicates disabled auto-reconnect.
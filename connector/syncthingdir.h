@@ -80,9 +80,12 @@ struct LIB_SYNCTHING_CONNECTOR_EXPORT SyncthingDir
     int progressRate = 0;
     std::vector<SyncthingDirError> errors;
     std::vector<SyncthingDirError> previousErrors;
-    int globalBytes = 0, globalDeleted = 0, globalFiles = 0;
-    int localBytes = 0, localDeleted = 0, localFiles = 0;
-    int neededByted = 0, neededFiles = 0;
+    uint64 globalBytes = 0;
+    int globalDeleted = 0, globalFiles = 0;
+    uint64 localBytes = 0;
+    int localDeleted = 0, localFiles = 0;
+    uint64 neededByted = 0;
+    int neededFiles = 0;
     ChronoUtilities::DateTime lastScanTime;
     ChronoUtilities::DateTime lastFileTime;
     QString lastFileName;
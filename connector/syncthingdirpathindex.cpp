@@ -0,0 +1,175 @@
+#include "./syncthingdirpathindex.h"
+#include "./syncthingdir.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+
+using namespace std;
+
+namespace Data {
+
+/*!
+ * \class SyncthingDirPathIndex
+ * \brief The SyncthingDirPathIndex class maps local paths to the directory containing them.
+ *
+ * The index is a trie over the components of the normalized directory paths. So looking up the directory containing
+ * a path takes time proportional to the length of the path, regardless of the number of directories.
+ *
+ * Besides its normalized path, each directory is indexed under the path with resolved symlinks.
+ */
+
+/*!
+ * \brief Returns the key used for the specified path \a component.
+ * \remarks Paths are considered case-insensitive under Windows.
+ */
+static inline QString componentKey(const QString &component)
+{
+#ifdef PLATFORM_WINDOWS
+    return component.toLower();
+#else
+    return component;
+#endif
+}
+
+/*!
+ * \brief Builds the index for the specified \a dirs.
+ * \remarks The indices returned by find() refer to \a dirs. So the index must be built again when \a dirs changes.
+ */
+void SyncthingDirPathIndex::build(const std::vector<SyncthingDir> &dirs)
+{
+    m_nodes.clear();
+    m_nodes.emplace_back();
+    vector<QString> paths;
+    paths.reserve(dirs.size());
+    int dirIndex = 0;
+    for(const SyncthingDir &dir : dirs) {
+        paths.emplace_back(normalizePath(dir.path));
+        insert(paths.back(), dirIndex++);
+    }
+    // add the paths with resolved symlinks as well; insert them after all regular paths so those take precedence
+    dirIndex = 0;
+    for(const QString &path : paths) {
+        const QString resolvedPath(canonicalPath(path));
+        if(resolvedPath != path) {
+            insert(resolvedPath, dirIndex);
+        }
+        ++dirIndex;
+    }
+}
+
+/*!
+ * \brief Adds the specified \a normalizedPath of the directory with the specified \a dirIndex to the trie.
+ */
+void SyncthingDirPathIndex::insert(const QString &normalizedPath, int dirIndex)
+{
+    if(normalizedPath.isEmpty()) {
+        return;
+    }
+    int node = 0;
+    for(const QString &component : normalizedPath.split(QChar('/'), QString::SkipEmptyParts)) {
+        const QString key(componentKey(component));
+        const auto child = m_nodes[static_cast<size_t>(node)].children.constFind(key);
+        if(child != m_nodes[static_cast<size_t>(node)].children.constEnd()) {
+            node = *child;
+        } else {
+            const int newNode = static_cast<int>(m_nodes.size());
+            m_nodes.emplace_back();
+            m_nodes[static_cast<size_t>(node)].children.insert(key, newNode);
+            node = newNode;
+        }
+    }
+    // keep the first dir if several dirs share the same path
+    if(m_nodes[static_cast<size_t>(node)].dirIndex < 0) {
+        m_nodes[static_cast<size_t>(node)].dirIndex = dirIndex;
+    }
+}
+
+/*!
+ * \brief Returns the index of the innermost directory matching the specified path \a components or -1 if there is none.
+ * \param matchedComponents Is set to the number of components making up the path of the directory.
+ */
+int SyncthingDirPathIndex::lookup(const QStringList &components, int &matchedComponents) const
+{
+    int node = 0, dirIndex = m_nodes.front().dirIndex;
+    matchedComponents = 0;
+    for(int i = 0; i != components.size(); ++i) {
+        const Node &currentNode = m_nodes[static_cast<size_t>(node)];
+        const auto child = currentNode.children.constFind(componentKey(components[i]));
+        if(child == currentNode.children.constEnd()) {
+            break;
+        }
+        node = *child;
+        if(m_nodes[static_cast<size_t>(node)].dirIndex >= 0) {
+            dirIndex = m_nodes[static_cast<size_t>(node)].dirIndex;
+            matchedComponents = i + 1;
+        }
+    }
+    return dirIndex;
+}
+
+/*!
+ * \brief Returns the index of the innermost directory containing the specified \a path or -1 if there is none.
+ * \param relativePath Is set to the path relative to the directory (empty if \a path is the directory itself).
+ * \remarks
+ * - Relative paths are considered relative to the current working directory.
+ * - If \a path is not within any directory as specified, it is looked up again with resolved symlinks. So a directory
+ *   is also found via a symlink to it or via its actual location if its path contains symlinks. Symlinks within
+ *   a directory are still reported as part of that directory.
+ */
+int SyncthingDirPathIndex::find(const QString &path, QString *relativePath) const
+{
+    if(m_nodes.empty()) {
+        return -1;
+    }
+    const QString normalizedPath(normalizePath(path));
+    QStringList components(normalizedPath.split(QChar('/'), QString::SkipEmptyParts));
+    int matchedComponents;
+    int dirIndex = lookup(components, matchedComponents);
+    if(dirIndex < 0) {
+        const QString resolvedPath(canonicalPath(normalizedPath));
+        if(resolvedPath != normalizedPath) {
+            components = resolvedPath.split(QChar('/'), QString::SkipEmptyParts);
+            dirIndex = lookup(components, matchedComponents);
+        }
+    }
+    if(dirIndex >= 0 && relativePath) {
+        *relativePath = components.mid(matchedComponents).join(QChar('/'));
+    }
+    return dirIndex;
+}
+
+/*!
+ * \brief Returns the specified \a path as absolute path with expanded tilde, separators converted to '/' and redundant
+ *        separators and "." and ".." components removed.
+ * \remarks Relative paths are considered relative to the current working directory. An empty \a path is returned as-is.
+ */
+QString SyncthingDirPathIndex::normalizePath(const QString &path)
+{
+    if(path.isEmpty()) {
+        return path;
+    }
+    QString normalizedPath(QDir::fromNativeSeparators(path));
+    if(normalizedPath == QLatin1String("~") || normalizedPath.startsWith(QLatin1String("~/"))) {
+        normalizedPath.replace(0, 1, QDir::homePath());
+    }
+    return QDir::cleanPath(QDir::current().absoluteFilePath(normalizedPath));
+}
+
+/*!
+ * \brief Returns the specified \a normalizedPath with all symlinks resolved.
+ * \remarks Only the longest leading part of the path which exists on the local file system can be resolved. The
+ *          remaining components are appended as-is.
+ */
+QString SyncthingDirPathIndex::canonicalPath(const QString &normalizedPath)
+{
+    for(int end = normalizedPath.size(); end > 0; end = normalizedPath.lastIndexOf(QChar('/'), end - 1)) {
+        const QString resolvedPath(QFileInfo(normalizedPath.left(end)).canonicalFilePath());
+        if(!resolvedPath.isEmpty()) {
+            return resolvedPath == QLatin1String("/") ? normalizedPath.mid(end) : resolvedPath + normalizedPath.midRef(end);
+        }
+    }
+    return normalizedPath;
+}
+
+} // namespace Data
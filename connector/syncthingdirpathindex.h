@@ -0,0 +1,58 @@
+#ifndef DATA_SYNCTHINGDIRPATHINDEX_H
+#define DATA_SYNCTHINGDIRPATHINDEX_H
+
+#include "./global.h"
+
+#include <QHash>
+#include <QString>
+
+QT_FORWARD_DECLARE_CLASS(QStringList)
+
+#include <vector>
+
+namespace Data {
+
+struct SyncthingDir;
+
+class LIB_SYNCTHING_CONNECTOR_EXPORT SyncthingDirPathIndex
+{
+public:
+    void build(const std::vector<SyncthingDir> &dirs);
+    void clear();
+    bool isEmpty() const;
+    int find(const QString &path, QString *relativePath = nullptr) const;
+    static QString normalizePath(const QString &path);
+    static QString canonicalPath(const QString &normalizedPath);
+
+private:
+    struct Node
+    {
+        QHash<QString, int> children;
+        int dirIndex = -1;
+    };
+
+    void insert(const QString &normalizedPath, int dirIndex);
+    int lookup(const QStringList &components, int &matchedComponents) const;
+
+    std::vector<Node> m_nodes;
+};
+
+/*!
+ * \brief Removes all dirs from the index.
+ */
+inline void SyncthingDirPathIndex::clear()
+{
+    m_nodes.clear();
+}
+
+/*!
+ * \brief Returns whether the index has not been built yet or has been cleared.
+ */
+inline bool SyncthingDirPathIndex::isEmpty() const
+{
+    return m_nodes.empty();
+}
+
+} // namespace Data
+
+#endif // DATA_SYNCTHINGDIRPATHINDEX_H
@@ -0,0 +1,177 @@
+#include "./syncthingipc.h"
+#include "./utils.h"
+
+#include <c++utilities/conversion/binaryconversion.h>
+
+#include <QIODevice>
+#include <QLocalSocket>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QString>
+#include <QUrl>
+
+using namespace ConversionUtilities;
+
+namespace Data {
+
+/*!
+ * \brief The size of a frame header.
+ *
+ * A frame consists of the following fields:
+ * - 2 byte magic 0xFFFF (distinguishes frames from the argument data sent by older instances which start with the
+ *   number of arguments)
+ * - 1 byte protocol version (see syncthingIpcVersion)
+ * - 1 byte type (the SyncthingIpcRequest for requests and the SyncthingIpcResult for responses)
+ * - 4 byte payload size (big endian)
+ * - the payload (compact JSON object)
+ */
+constexpr qint64 frameHeaderSize = 8;
+
+/*!
+ * \brief The max. payload size accepted by readSyncthingIpcFrame().
+ */
+constexpr uint32 maxPayloadSize = 64 * 1024 * 1024;
+
+/*!
+ * \brief Returns the name of the local server a running Syncthing Tray instance listens to.
+ * \remarks Under UNIX the socket is placed within the user's runtime directory (usually XDG_RUNTIME_DIR) which is
+ *          only accessible by the user. Otherwise other local users could create the socket before the tray is
+ *          started to impersonate it.
+ */
+QString syncthingTrayServerName()
+{
+#ifdef Q_OS_UNIX
+    const QString runtimeDir(QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation));
+    if(!runtimeDir.isEmpty()) {
+        return runtimeDir + QStringLiteral("/syncthingtray.sock");
+    }
+#endif
+    return QStringLiteral("Syncthing Tray by Martchus");
+}
+
+/*!
+ * \brief Returns whether the specified URLs refer to the same Syncthing instance.
+ * \remarks Different names of the local machine (eg. "localhost" and "127.0.0.1") are considered equal.
+ */
+bool isSameSyncthingInstance(const QUrl &url, const QUrl &otherUrl)
+{
+    if(url.port(8080) != otherUrl.port(8080)) {
+        return false;
+    }
+    return url.host().compare(otherUrl.host(), Qt::CaseInsensitive) == 0 || (isLocal(url) && isLocal(otherUrl));
+}
+
+/*!
+ * \brief Writes a frame with the specified \a type and \a payload to the specified \a device.
+ */
+void writeSyncthingIpcFrame(QIODevice &device, unsigned char type, const QJsonObject &payload)
+{
+    const QByteArray payloadData(QJsonDocument(payload).toJson(QJsonDocument::Compact));
+    char header[frameHeaderSize];
+    header[0] = header[1] = static_cast<char>(0xFF);
+    header[2] = static_cast<char>(syncthingIpcVersion);
+    header[3] = static_cast<char>(type);
+    BE::getBytes(static_cast<uint32>(payloadData.size()), header + 4);
+    device.write(header, frameHeaderSize);
+    device.write(payloadData);
+}
+
+/*!
+ * \brief Reads a frame from the specified \a device.
+ *
+ * The data is only consumed if a complete frame is available. Hence this function can be called whenever new data
+ * becomes available until SyncthingIpcFrameStatus::Incomplete is not returned anymore.
+ */
+SyncthingIpcFrameStatus readSyncthingIpcFrame(QIODevice &device, unsigned char &version, unsigned char &type, QJsonObject &payload)
+{
+    char header[frameHeaderSize];
+    const qint64 headerSize = device.peek(header, frameHeaderSize);
+    if(headerSize < 2) {
+        return SyncthingIpcFrameStatus::Incomplete;
+    }
+    if(static_cast<unsigned char>(header[0]) != 0xFF || static_cast<unsigned char>(header[1]) != 0xFF) {
+        return SyncthingIpcFrameStatus::NoFrame;
+    }
+    if(headerSize < frameHeaderSize) {
+        return SyncthingIpcFrameStatus::Incomplete;
+    }
+    const uint32 payloadSize = BE::toUInt32(header + 4);
+    if(payloadSize > maxPayloadSize) {
+        return SyncthingIpcFrameStatus::Invalid;
+    }
+    if(device.bytesAvailable() < frameHeaderSize + payloadSize) {
+        return SyncthingIpcFrameStatus::Incomplete;
+    }
+    device.read(header, frameHeaderSize);
+    version = static_cast<unsigned char>(header[2]);
+    type = static_cast<unsigned char>(header[3]);
+    QJsonParseError jsonError;
+    const QJsonDocument payloadDoc(QJsonDocument::fromJson(device.read(payloadSize), &jsonError));
+    if(jsonError.error != QJsonParseError::NoError) {
+        return SyncthingIpcFrameStatus::Invalid;
+    }
+    payload = payloadDoc.object();
+    return SyncthingIpcFrameStatus::Complete;
+}
+
+/*!
+ * \brief Sends the specified \a request to a running Syncthing Tray instance and waits for the \a response.
+ *
+ * The \a request should contain the "url" of the Syncthing instance in question. The tray only responds if it has a
+ * connection to that instance. No credentials are sent; the tray uses the ones it is already configured with.
+ *
+ * \remarks
+ * - Blocks for at most \a timeout milliseconds until the tray responds. Returns immediately if no tray is running.
+ * - Once the tray has accepted a SyncthingIpcRequest::Command, blocks until the results of the commands have been
+ *   received (the tray's requests to Syncthing are subject to the deadlines of its connection).
+ * - Meant to be used by command line tools which would otherwise need to query the REST API.
+ */
+SyncthingIpcResult querySyncthingTray(SyncthingIpcRequest type, const QJsonObject &request, QJsonObject &response, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QLocalSocket socket;
+    socket.connectToServer(syncthingTrayServerName(), QLocalSocket::ReadWrite);
+    if(!socket.waitForConnected(timeout)) {
+        return SyncthingIpcResult::NoTray;
+    }
+    writeSyncthingIpcFrame(socket, static_cast<unsigned char>(type), request);
+    socket.flush();
+
+    unsigned char version, result;
+    bool accepted = false;
+    for(;;) {
+        switch(readSyncthingIpcFrame(socket, version, result, response)) {
+        case SyncthingIpcFrameStatus::Complete:
+            if(version != syncthingIpcVersion) {
+                return SyncthingIpcResult::UnsupportedVersion;
+            }
+            if(static_cast<SyncthingIpcResult>(result) == SyncthingIpcResult::Accepted) {
+                // the tray waits for Syncthing itself so the time it takes is not limited by the timeout
+                accepted = true;
+                continue;
+            }
+            return static_cast<SyncthingIpcResult>(result);
+        case SyncthingIpcFrameStatus::Incomplete: {
+            if(accepted) {
+                if(socket.waitForReadyRead(-1)) {
+                    continue;
+                }
+                return SyncthingIpcResult::NoTray;
+            }
+            const qint64 remainingTime = timeout - timer.elapsed();
+            if(remainingTime > 0 && socket.waitForReadyRead(static_cast<int>(remainingTime))) {
+                continue;
+            }
+            // older instances don't respond at all but treat the data as arguments when the connection is closed
+            return SyncthingIpcResult::NoTray;
+        }
+        default:
+            return SyncthingIpcResult::NoTray;
+        }
+    }
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef DATA_SYNCTHINGIPC_H
+#define DATA_SYNCTHINGIPC_H
+
+#include "./global.h"
+
+#include <QtGlobal>
+
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QString)
+QT_FORWARD_DECLARE_CLASS(QUrl)
+QT_FORWARD_DECLARE_CLASS(QJsonObject)
+
+namespace Data {
+
+/*!
+ * \brief The version of the protocol used to communicate with a running Syncthing Tray instance.
+ * \remarks Must be incremented when the format of frames or payloads changes incompatibly.
+ */
+constexpr unsigned char syncthingIpcVersion = 2;
+
+/*!
+ * \brief Specifies the type of a request sent to Syncthing Tray.
+ */
+enum class SyncthingIpcRequest : unsigned char
+{
+    StatusSnapshot = 1, /**< requests the current directory and device information (see SyncthingConnection::snapshot()) */
+    Command = 2 /**< forwards commands like "rescan" or "pause" to the tray's connection and reports their results */
+};
+
+/*!
+ * \brief Specifies the result of a request sent to Syncthing Tray.
+ */
+enum class SyncthingIpcResult : unsigned char
+{
+    Ok, /**< the request has been handled */
+    UnsupportedVersion, /**< the tray uses a different protocol version */
+    UnsupportedRequest, /**< the request type or command is unknown */
+    NotAvailable, /**< the tray has no connection to the requested Syncthing instance */
+    NotConnected, /**< the tray's connection to the requested Syncthing instance has not been established */
+    NoTray, /**< there is no Syncthing Tray instance running or it did not respond in time */
+    Accepted, /**< the request is handled asynchronously; the final result is sent as another frame when done */
+    CommandFailed /**< at least one of the forwarded commands failed (see the "results" of the response) */
+};
+
+/*!
+ * \brief Specifies the state of a frame when reading it via readSyncthingIpcFrame().
+ */
+enum class SyncthingIpcFrameStatus
+{
+    NoFrame, /**< the data is no frame at all (but eg. arguments sent by a legacy instance) */
+    Incomplete, /**< the data received so far is not a complete frame */
+    Complete, /**< a complete frame has been read */
+    Invalid /**< the frame header is invalid */
+};
+
+QString LIB_SYNCTHING_CONNECTOR_EXPORT syncthingTrayServerName();
+bool LIB_SYNCTHING_CONNECTOR_EXPORT isSameSyncthingInstance(const QUrl &url, const QUrl &otherUrl);
+void LIB_SYNCTHING_CONNECTOR_EXPORT writeSyncthingIpcFrame(QIODevice &device, unsigned char type, const QJsonObject &payload);
+SyncthingIpcFrameStatus LIB_SYNCTHING_CONNECTOR_EXPORT readSyncthingIpcFrame(QIODevice &device, unsigned char &version, unsigned char &type, QJsonObject &payload);
+SyncthingIpcResult LIB_SYNCTHING_CONNECTOR_EXPORT querySyncthingTray(SyncthingIpcRequest type, const QJsonObject &request, QJsonObject &response, int timeout = 1000);
+
+}
+
+#endif // DATA_SYNCTHINGIPC_H
@@ -0,0 +1,367 @@
+#include "./syncthinglocalsocketreply.h"
+
+#include <QStringBuilder>
+#include <QTimer>
+#include <QUrl>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace Data {
+
+/*!
+ * \class SyncthingLocalSocketReply
+ * \brief The SyncthingLocalSocketReply class performs a HTTP request via a Unix domain socket (or a named pipe under Windows).
+ *
+ * Syncthing is able to serve the GUI/REST API on a local socket when the GUI address is set to "unix:///path/to/socket".
+ * QNetworkAccessManager does not support this so SyncthingConnection uses this minimal HTTP/1.1 client instead. It provides
+ * the same interface as the replies created by QNetworkAccessManager as far as SyncthingConnection relies on it.
+ *
+ * \remarks
+ * - Each reply uses its own socket and sends "Connection: close". Connecting to a local socket is cheap so keeping
+ *   connections alive would not be worth the additional complexity.
+ * - TLS is not supported. It would not add anything for a socket which is only accessible on the local machine anyways.
+ * - Responses with "Content-Length" and chunked responses as well as responses terminated by closing the connection are
+ *   supported.
+ */
+
+/*!
+ * \brief Constructs a new reply and starts sending the specified \a request with the specified \a data to the socket
+ *        with the specified \a socketPath.
+ * \remarks Only the path and query of the URL of \a request are used (as well as the credentials if present).
+ */
+SyncthingLocalSocketReply::SyncthingLocalSocketReply(const QString &socketPath, QNetworkAccessManager::Operation operation, const QNetworkRequest &request, const QByteArray &data, QObject *parent) :
+    QNetworkReply(parent),
+    m_readPos(0),
+    m_remainingSize(-1),
+    m_headerRead(false),
+    m_chunked(false),
+    m_finished(false)
+{
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(operation);
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    // compose the request
+    const QUrl url(request.url());
+    m_requestData.reserve(256 + data.size());
+    switch(operation) {
+    case QNetworkAccessManager::HeadOperation:
+        m_requestData += "HEAD ";
+        break;
+    case QNetworkAccessManager::PutOperation:
+        m_requestData += "PUT ";
+        break;
+    case QNetworkAccessManager::PostOperation:
+        m_requestData += "POST ";
+        break;
+    case QNetworkAccessManager::DeleteOperation:
+        m_requestData += "DELETE ";
+        break;
+    default:
+        m_requestData += "GET ";
+    }
+    const QString path(url.path(QUrl::FullyEncoded));
+    m_requestData += path.isEmpty() ? QByteArray("/") : path.toUtf8();
+    if(url.hasQuery()) {
+        m_requestData += '?';
+        m_requestData += url.query(QUrl::FullyEncoded).toUtf8();
+    }
+    m_requestData += " HTTP/1.1\r\nHost: localhost\r\n";
+    if(!url.userName().isEmpty()) {
+        m_requestData += "Authorization: Basic ";
+        m_requestData += QString(url.userName() % QChar(':') % url.password()).toUtf8().toBase64();
+        m_requestData += "\r\n";
+    }
+    for(const QByteArray &headerName : request.rawHeaderList()) {
+        m_requestData += headerName;
+        m_requestData += ": ";
+        m_requestData += request.rawHeader(headerName);
+        m_requestData += "\r\n";
+    }
+    if(operation == QNetworkAccessManager::PostOperation || operation == QNetworkAccessManager::PutOperation) {
+        m_requestData += "Content-Length: ";
+        m_requestData += QByteArray::number(data.size());
+        m_requestData += "\r\n";
+    }
+    m_requestData += "Connection: close\r\n\r\n";
+    m_requestData += data;
+
+    connect(&m_socket, &QLocalSocket::connected, this, &SyncthingLocalSocketReply::sendRequest);
+    connect(&m_socket, &QLocalSocket::readyRead, this, &SyncthingLocalSocketReply::readResponse);
+    connect(&m_socket, static_cast<void(QLocalSocket::*)(QLocalSocket::LocalSocketError)>(&QLocalSocket::error), this, &SyncthingLocalSocketReply::handleSocketError);
+    connect(&m_socket, &QLocalSocket::disconnected, this, &SyncthingLocalSocketReply::handleDisconnected);
+
+    // connect delayed because QLocalSocket might fail synchronously but the caller must be able to connect to finished() first
+    QTimer::singleShot(0, this, [this, socketPath] {
+        if(!m_finished) {
+            m_socket.connectToServer(socketPath);
+        }
+    });
+}
+
+/*!
+ * \brief Destroys the reply, closing the socket if still connected.
+ */
+SyncthingLocalSocketReply::~SyncthingLocalSocketReply()
+{
+    disconnect(&m_socket, nullptr, this, nullptr);
+    m_socket.abort();
+}
+
+/*!
+ * \brief Aborts the request; emits error() with QNetworkReply::OperationCanceledError and finished().
+ */
+void SyncthingLocalSocketReply::abort()
+{
+    if(m_finished) {
+        return;
+    }
+    finish(OperationCanceledError, tr("Operation canceled"));
+    m_socket.abort();
+}
+
+/*!
+ * \brief Returns the number of bytes of the response which have not been read so far.
+ */
+qint64 SyncthingLocalSocketReply::bytesAvailable() const
+{
+    return QNetworkReply::bytesAvailable() + m_content.size() - m_readPos;
+}
+
+qint64 SyncthingLocalSocketReply::readData(char *data, qint64 maxSize)
+{
+    const auto size = static_cast<int>(min<qint64>(maxSize, m_content.size() - m_readPos));
+    if(!size) {
+        return m_finished ? -1 : 0;
+    }
+    memcpy(data, m_content.constData() + m_readPos, static_cast<size_t>(size));
+    m_readPos += size;
+    return size;
+}
+
+void SyncthingLocalSocketReply::sendRequest()
+{
+    m_socket.write(m_requestData);
+    m_requestData = QByteArray();
+}
+
+void SyncthingLocalSocketReply::readResponse()
+{
+    if(m_finished) {
+        return;
+    }
+    m_buffer += m_socket.readAll();
+    if(!m_headerRead && !readHeader()) {
+        return;
+    }
+    if(readBody()) {
+        finish();
+    }
+}
+
+/*!
+ * \brief Reads the status line and the header fields if completely buffered.
+ * \returns Returns whether the header has been read.
+ */
+bool SyncthingLocalSocketReply::readHeader()
+{
+    const int headerEnd = m_buffer.indexOf("\r\n\r\n");
+    if(headerEnd < 0) {
+        return false;
+    }
+    const QList<QByteArray> lines(m_buffer.left(headerEnd).split('\n'));
+    m_buffer.remove(0, headerEnd + 4);
+
+    // read status line, eg. "HTTP/1.1 200 OK"
+    const QByteArray statusLine(lines.front().trimmed());
+    const int codeStart = statusLine.indexOf(' ') + 1;
+    const int reasonStart = statusLine.indexOf(' ', codeStart) + 1;
+    bool ok = false;
+    const int statusCode = codeStart ? statusLine.mid(codeStart, reasonStart ? reasonStart - codeStart - 1 : -1).toInt(&ok) : 0;
+    if(!statusLine.startsWith("HTTP/") || !ok) {
+        finish(ProtocolFailure, tr("Received invalid status line \"%1\".").arg(QString::fromLatin1(statusLine)));
+        return false;
+    }
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, statusCode);
+    setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, reasonStart ? statusLine.mid(reasonStart) : QByteArray());
+
+    // read header fields
+    for(auto i = lines.cbegin() + 1, end = lines.cend(); i != end; ++i) {
+        const int colon = i->indexOf(':');
+        if(colon <= 0) {
+            continue;
+        }
+        const QByteArray name(i->left(colon).trimmed()), value(i->mid(colon + 1).trimmed());
+        if(qstricmp(name.constData(), "Content-Length") == 0) {
+            m_remainingSize = value.toLongLong(&ok);
+            if(!ok || m_remainingSize < 0) {
+                finish(ProtocolFailure, tr("Received invalid content length \"%1\".").arg(QString::fromLatin1(value)));
+                return false;
+            }
+        } else if(qstricmp(name.constData(), "Transfer-Encoding") == 0) {
+            m_chunked = value.toLower().contains("chunked");
+        }
+        setRawHeader(name, value);
+    }
+    if(m_chunked) {
+        m_remainingSize = 0;
+    } else if(operation() == QNetworkAccessManager::HeadOperation || statusCode == 204 || statusCode == 304) {
+        m_remainingSize = 0;
+    }
+    m_headerRead = true;
+    emit metaDataChanged();
+    return true;
+}
+
+/*!
+ * \brief Moves the buffered part of the body to the content which can be read by the user.
+ * \returns Returns whether the body has been read completely.
+ */
+bool SyncthingLocalSocketReply::readBody()
+{
+    if(!m_chunked) {
+        if(m_remainingSize < 0) {
+            // read until the server closes the connection
+            appendContent(m_buffer);
+            m_buffer.clear();
+            return false;
+        }
+        const auto size = static_cast<int>(min<qint64>(m_remainingSize, m_buffer.size()));
+        appendContent(m_buffer.left(size));
+        m_buffer.remove(0, size);
+        m_remainingSize -= size;
+        return !m_remainingSize;
+    }
+
+    // decode chunked body; m_remainingSize contains the remaining size of the current chunk including the trailing CRLF
+    for(;;) {
+        if(!m_remainingSize) {
+            const int lineEnd = m_buffer.indexOf("\r\n");
+            if(lineEnd < 0) {
+                return false;
+            }
+            const int extensionStart = m_buffer.indexOf(';');
+            bool ok;
+            const qint64 chunkSize = m_buffer.left(extensionStart >= 0 && extensionStart < lineEnd ? extensionStart : lineEnd).trimmed().toLongLong(&ok, 16);
+            if(!ok || chunkSize < 0) {
+                finish(ProtocolFailure, tr("Received invalid chunk size."));
+                return false;
+            }
+            m_buffer.remove(0, lineEnd + 2);
+            if(!chunkSize) {
+                // last chunk; trailers are ignored
+                return true;
+            }
+            m_remainingSize = chunkSize + 2;
+        }
+        const auto size = static_cast<int>(min<qint64>(m_remainingSize, m_buffer.size()));
+        const auto contentSize = static_cast<int>(max<qint64>(0, min<qint64>(size, m_remainingSize - 2)));
+        appendContent(m_buffer.left(contentSize));
+        m_buffer.remove(0, size);
+        m_remainingSize -= size;
+        if(m_remainingSize) {
+            return false;
+        }
+    }
+}
+
+void SyncthingLocalSocketReply::appendContent(const QByteArray &content)
+{
+    if(content.isEmpty()) {
+        return;
+    }
+    if(m_readPos == m_content.size()) {
+        m_content.clear();
+        m_readPos = 0;
+    }
+    m_content += content;
+    emit readyRead();
+}
+
+void SyncthingLocalSocketReply::handleSocketError(QLocalSocket::LocalSocketError socketError)
+{
+    if(m_finished) {
+        return;
+    }
+    NetworkError networkError;
+    switch(socketError) {
+    case QLocalSocket::PeerClosedError:
+        // handled in handleDisconnected()
+        return;
+    case QLocalSocket::ConnectionRefusedError:
+        networkError = ConnectionRefusedError;
+        break;
+    case QLocalSocket::ServerNotFoundError:
+        networkError = HostNotFoundError;
+        break;
+    case QLocalSocket::SocketAccessError:
+        networkError = ContentAccessDenied;
+        break;
+    case QLocalSocket::SocketTimeoutError:
+        networkError = TimeoutError;
+        break;
+    default:
+        networkError = UnknownNetworkError;
+    }
+    finish(networkError, tr("Unable to communicate with \"%1\": %2").arg(m_socket.fullServerName(), m_socket.errorString()));
+}
+
+void SyncthingLocalSocketReply::handleDisconnected()
+{
+    if(m_finished) {
+        return;
+    }
+    if(m_headerRead && !m_chunked && m_remainingSize < 0) {
+        readResponse();
+        finish();
+    } else {
+        finish(RemoteHostClosedError, tr("Connection closed before the response has been received completely."));
+    }
+}
+
+/*!
+ * \brief Emits error() if \a networkError is not QNetworkReply::NoError or the status code indicates an error; emits finished().
+ */
+void SyncthingLocalSocketReply::finish(NetworkError networkError, const QString &errorString)
+{
+    if(m_finished) {
+        return;
+    }
+    m_finished = true;
+
+    QString errorMessage(errorString);
+    if(networkError == NoError) {
+        const int statusCode = attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if(statusCode >= 400) {
+            switch(statusCode) {
+            case 401:
+                networkError = AuthenticationRequiredError;
+                break;
+            case 403:
+                networkError = ContentAccessDenied;
+                break;
+            case 404:
+                networkError = ContentNotFoundError;
+                break;
+            case 405:
+                networkError = ContentOperationNotPermittedError;
+                break;
+            default:
+                networkError = statusCode >= 500 ? UnknownServerError : UnknownContentError;
+            }
+            errorMessage = tr("Error transferring %1 - server replied: %2").arg(url().toString(), attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString());
+        }
+    }
+    if(networkError != NoError) {
+        setError(networkError, errorMessage);
+        emit error(networkError);
+    }
+    setFinished(true);
+    emit finished();
+}
+
+} // namespace Data
@@ -0,0 +1,59 @@
+#ifndef DATA_SYNCTHINGLOCALSOCKETREPLY_H
+#define DATA_SYNCTHINGLOCALSOCKETREPLY_H
+
+#include <QByteArray>
+#include <QLocalSocket>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+namespace Data {
+
+class SyncthingLocalSocketReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    SyncthingLocalSocketReply(const QString &socketPath, QNetworkAccessManager::Operation operation, const QNetworkRequest &request, const QByteArray &data = QByteArray(), QObject *parent = nullptr);
+    ~SyncthingLocalSocketReply();
+
+    void abort() override;
+    qint64 bytesAvailable() const override;
+    bool isSequential() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+
+private slots:
+    void sendRequest();
+    void readResponse();
+    void handleSocketError(QLocalSocket::LocalSocketError socketError);
+    void handleDisconnected();
+
+private:
+    bool readHeader();
+    bool readBody();
+    void appendContent(const QByteArray &content);
+    void finish(NetworkError error = NoError, const QString &errorString = QString());
+
+    QLocalSocket m_socket;
+    QByteArray m_requestData;
+    QByteArray m_buffer;
+    QByteArray m_content;
+    int m_readPos;
+    qint64 m_remainingSize;
+    bool m_headerRead;
+    bool m_chunked;
+    bool m_finished;
+};
+
+/*!
+ * \brief Returns true; the response can only be read sequentially.
+ */
+inline bool SyncthingLocalSocketReply::isSequential() const
+{
+    return true;
+}
+
+} // namespace Data
+
+#endif // DATA_SYNCTHINGLOCALSOCKETREPLY_H
@@ -0,0 +1,108 @@
+#include "./syncthingresponsecache.h"
+
+namespace Data {
+
+/*!
+ * \class SyncthingResponseCache
+ * \brief The SyncthingResponseCache class caches responses of REST API endpoints which rarely change.
+ *
+ * Entries are keyed by endpoint and query and expire after a time-to-live specified per entry. Entries can be
+ * invalidated before, eg. SyncthingConnection invalidates statistics when receiving related events. The number of
+ * entries and the total size of the cached responses are bounded; entries expiring first are evicted first.
+ */
+
+SyncthingResponseCache::SyncthingResponseCache() :
+    m_totalBytes(0),
+    m_maxEntries(64),
+    m_maxBytes(4 * 1024 * 1024)
+{
+    m_clock.start();
+}
+
+/*!
+ * \brief Returns the response cached for the specified \a key or nullptr if there is no such response or it has
+ *        expired.
+ * \remarks The returned pointer is only valid until the cache is modified.
+ */
+const QByteArray *SyncthingResponseCache::find(const QString &key) const
+{
+    const auto i = m_entries.constFind(key);
+    if(i == m_entries.cend() || i->expiry <= m_clock.elapsed()) {
+        return nullptr;
+    }
+    return &i->response;
+}
+
+/*!
+ * \brief Caches the specified \a response for the specified \a key for \a ttl milliseconds.
+ * \remarks Does nothing if \a ttl is not positive or the response exceeds the size limit on its own.
+ */
+void SyncthingResponseCache::insert(const QString &key, const QByteArray &response, int ttl)
+{
+    if(ttl <= 0 || response.size() > m_maxBytes) {
+        return;
+    }
+    const auto i = m_entries.find(key);
+    if(i != m_entries.end()) {
+        m_totalBytes -= i->response.size();
+        m_entries.erase(i);
+    }
+    evict(response.size());
+    m_entries.insert(key, Entry{ response, m_clock.elapsed() + ttl });
+    m_totalBytes += response.size();
+}
+
+/*!
+ * \brief Removes all entries with keys starting with the specified \a keyPrefix.
+ */
+void SyncthingResponseCache::invalidate(const QString &keyPrefix)
+{
+    for(auto i = m_entries.begin(); i != m_entries.end();) {
+        if(i.key().startsWith(keyPrefix)) {
+            m_totalBytes -= i->response.size();
+            i = m_entries.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+/*!
+ * \brief Sets the maximum number of entries and the maximum total size of the cached responses in bytes.
+ * \remarks Entries are evicted if the current content exceeds the new limits.
+ */
+void SyncthingResponseCache::setLimits(int maxEntries, int maxBytes)
+{
+    m_maxEntries = maxEntries;
+    m_maxBytes = maxBytes;
+    evict(0);
+}
+
+/*!
+ * \brief Evicts expired entries and, if still required, the entries expiring first until an entry with the specified
+ *        \a requiredBytes fits.
+ */
+void SyncthingResponseCache::evict(int requiredBytes)
+{
+    const qint64 now = m_clock.elapsed();
+    for(auto i = m_entries.begin(); i != m_entries.end();) {
+        if(i->expiry <= now) {
+            m_totalBytes -= i->response.size();
+            i = m_entries.erase(i);
+        } else {
+            ++i;
+        }
+    }
+    while(!m_entries.isEmpty() && (m_entries.size() >= m_maxEntries || m_totalBytes + requiredBytes > m_maxBytes)) {
+        auto first = m_entries.begin(), i = first;
+        for(++i; i != m_entries.end(); ++i) {
+            if(i->expiry < first->expiry) {
+                first = i;
+            }
+        }
+        m_totalBytes -= first->response.size();
+        m_entries.erase(first);
+    }
+}
+
+} // namespace Data
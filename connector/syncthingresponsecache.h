@@ -0,0 +1,89 @@
+#ifndef DATA_SYNCTHINGRESPONSECACHE_H
+#define DATA_SYNCTHINGRESPONSECACHE_H
+
+#include "./global.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+namespace Data {
+
+class LIB_SYNCTHING_CONNECTOR_EXPORT SyncthingResponseCache
+{
+public:
+    SyncthingResponseCache();
+
+    const QByteArray *find(const QString &key) const;
+    void insert(const QString &key, const QByteArray &response, int ttl);
+    void invalidate(const QString &keyPrefix);
+    void clear();
+    int size() const;
+    int totalBytes() const;
+    int maxEntries() const;
+    int maxBytes() const;
+    void setLimits(int maxEntries, int maxBytes);
+
+private:
+    struct Entry
+    {
+        QByteArray response;
+        qint64 expiry;
+    };
+
+    void evict(int requiredBytes);
+
+    QHash<QString, Entry> m_entries;
+    QElapsedTimer m_clock;
+    int m_totalBytes;
+    int m_maxEntries;
+    int m_maxBytes;
+};
+
+/*!
+ * \brief Removes all entries.
+ */
+inline void SyncthingResponseCache::clear()
+{
+    m_entries.clear();
+    m_totalBytes = 0;
+}
+
+/*!
+ * \brief Returns the number of entries (including expired entries which have not been evicted yet).
+ */
+inline int SyncthingResponseCache::size() const
+{
+    return m_entries.size();
+}
+
+/*!
+ * \brief Returns the total size of the cached responses in bytes.
+ */
+inline int SyncthingResponseCache::totalBytes() const
+{
+    return m_totalBytes;
+}
+
+/*!
+ * \brief Returns the maximum number of entries.
+ * \remarks Default value is 64.
+ */
+inline int SyncthingResponseCache::maxEntries() const
+{
+    return m_maxEntries;
+}
+
+/*!
+ * \brief Returns the maximum total size of the cached responses in bytes.
+ * \remarks Default value is 4 MiB.
+ */
+inline int SyncthingResponseCache::maxBytes() const
+{
+    return m_maxBytes;
+}
+
+} // namespace Data
+
+#endif // DATA_SYNCTHINGRESPONSECACHE_H
@@ -0,0 +1,248 @@
+#include "../syncthingconnection.h"
+#include "../syncthingdir.h"
+
+#include "./fakesyncthing.h"
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <QNetworkReply>
+#include <QUrlQuery>
+
+#include <memory>
+
+using namespace std;
+using namespace Data;
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The ConnectionTests class tests SyncthingConnection against FakeSyncthing.
+ */
+class ConnectionTests : public TestFixture
+{
+    CPPUNIT_TEST_SUITE(ConnectionTests);
+    CPPUNIT_TEST(testConnectProfile);
+    CPPUNIT_TEST(testFailedInitialRequest);
+    CPPUNIT_TEST(testRequestDeadlineAndReissue);
+    CPPUNIT_TEST(testResponseCache);
+    CPPUNIT_TEST(testDirStatusBeyond2GiB);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testConnectProfile();
+    void testFailedInitialRequest();
+    void testRequestDeadlineAndReissue();
+    void testResponseCache();
+    void testDirStatusBeyond2GiB();
+
+private:
+    void connect(SyncthingConnectProfile connectProfile);
+
+    unique_ptr<FakeSyncthing> m_syncthing;
+    unique_ptr<SyncthingConnection> m_connection;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ConnectionTests);
+
+void ConnectionTests::setUp()
+{
+    ensureApplication();
+    m_syncthing.reset(new FakeSyncthing);
+    m_syncthing->setResponse("system/config", "{\"folders\":[{\"id\":\"dir1\",\"label\":\"Directory 1\",\"path\":\"/tmp/dir1\","
+                                              "\"devices\":[{\"deviceID\":\"DEV1\"}]}],\"devices\":[{\"deviceID\":\"DEV1\",\"name\":\"Device 1\"}]}");
+    m_syncthing->setResponse("system/status", "{\"myID\":\"DEV1\"}");
+    m_syncthing->setResponse("system/connections", "{\"connections\":{},\"total\":{\"inBytesTotal\":0,\"outBytesTotal\":0}}");
+    m_syncthing->setResponse("system/error", "{\"errors\":null}");
+    m_syncthing->setResponse("stats/folder", "{}");
+    m_syncthing->setResponse("stats/device", "{}");
+    m_syncthing->setResponse("system/pause", "");
+    m_syncthing->setResponse("db/scan", "");
+    m_connection.reset(new SyncthingConnection(m_syncthing->url(), QByteArray("testkey")));
+    // prevent polling from influencing the number of requests
+    m_connection->setTrafficPollInterval(60 * 1000);
+}
+
+void ConnectionTests::tearDown()
+{
+    m_connection.reset();
+    m_syncthing.reset();
+}
+
+/*!
+ * \brief Connects using the specified \a connectProfile and waits until the connection has been established.
+ */
+void ConnectionTests::connect(SyncthingConnectProfile connectProfile)
+{
+    m_connection->setConnectProfile(connectProfile);
+    m_connection->connect();
+    CPPUNIT_ASSERT_MESSAGE("connection established", waitFor([this] { return m_connection->isConnected(); }));
+}
+
+/*!
+ * \brief Tests whether only the data according to the connect profile is requested.
+ */
+void ConnectionTests::testConnectProfile()
+{
+    connect(SyncthingConnectProfile::Config);
+    CPPUNIT_ASSERT_EQUAL(1, m_syncthing->requestCount("system/config"));
+    for(const char *path : {"system/status", "system/connections", "system/error", "stats/folder", "stats/device", "events"}) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(path, 0, m_syncthing->requestCount(path));
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), m_connection->dirInfo().size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), m_connection->devInfo().size());
+
+    m_connection->disconnect();
+    m_syncthing->resetRequestCounts();
+    connect(SyncthingConnectProfile::Status | SyncthingConnectProfile::DirStatistics);
+    CPPUNIT_ASSERT_EQUAL(1, m_syncthing->requestCount("system/config"));
+    CPPUNIT_ASSERT_EQUAL(1, m_syncthing->requestCount("system/status"));
+    CPPUNIT_ASSERT_EQUAL(1, m_syncthing->requestCount("stats/folder"));
+    for(const char *path : {"system/connections", "system/error", "stats/device", "events"}) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(path, 0, m_syncthing->requestCount(path));
+    }
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("DEV1").toStdString(), m_connection->myId().toStdString());
+}
+
+/*!
+ * \brief Tests whether the connection is not considered established when a request made when connecting fails.
+ */
+void ConnectionTests::testFailedInitialRequest()
+{
+    int errors = 0;
+    QObject::connect(m_connection.get(), &SyncthingConnection::error, [&errors] {
+        ++errors;
+    });
+    bool becameIdle = false;
+    QObject::connect(m_connection.get(), &SyncthingConnection::statusChanged, [&becameIdle] (SyncthingStatus status) {
+        becameIdle = becameIdle || status == SyncthingStatus::Idle;
+    });
+
+    // parse error
+    m_syncthing->setResponse("stats/folder", "{");
+    m_connection->setConnectProfile(SyncthingConnectProfile::Connections | SyncthingConnectProfile::DirStatistics);
+    m_connection->connect();
+    CPPUNIT_ASSERT(waitFor([this, &errors] { return errors == 1 && m_syncthing->requestCount("system/connections") == 1; }));
+    CPPUNIT_ASSERT_MESSAGE("not established", !waitFor([this] { return m_connection->isConnected(); }, 500));
+    CPPUNIT_ASSERT(!becameIdle);
+
+    // network error
+    m_syncthing->setResponse("stats/folder", "{}");
+    m_syncthing->removeResponse("system/connections");
+    m_syncthing->resetRequestCounts();
+    m_connection->connect();
+    CPPUNIT_ASSERT(waitFor([this, &errors] { return errors == 2 && m_syncthing->requestCount("stats/folder") == 1; }));
+    CPPUNIT_ASSERT_MESSAGE("not established", !waitFor([this] { return m_connection->isConnected(); }, 500));
+    CPPUNIT_ASSERT(!becameIdle);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(SyncthingStatus::Disconnected), static_cast<int>(m_connection->status()));
+}
+
+/*!
+ * \brief Tests whether polling requests exceeding the deadline are aborted and reissued, commands exceeding the
+ *        deadline fail and rescans have no deadline at all.
+ */
+void ConnectionTests::testRequestDeadlineAndReissue()
+{
+    m_connection->setRequestTimeout(200);
+    m_syncthing->setIgnoredRequests("system/connections", 1);
+    connect(SyncthingConnectProfile::Connections);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("timed out request reissued", 2, m_syncthing->requestCount("system/connections"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(1), m_connection->abortedRequests());
+
+    // commands are not reissued
+    QString errorMessage;
+    QObject::connect(m_connection.get(), &SyncthingConnection::error, [&errorMessage] (const QString &message) {
+        errorMessage = message;
+    });
+    m_syncthing->setDelay("system/pause", 1000);
+    bool pauseFinished = false;
+    QNetworkReply *reply = m_connection->pause(QStringLiteral("DEV1"));
+    QObject::connect(reply, &QNetworkReply::finished, [&pauseFinished] {
+        pauseFinished = true;
+    });
+    CPPUNIT_ASSERT(waitFor([&pauseFinished] { return pauseFinished; }));
+    CPPUNIT_ASSERT_EQUAL(1, m_syncthing->requestCount("system/pause"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(2), m_connection->abortedRequests());
+    CPPUNIT_ASSERT_MESSAGE(errorMessage.toStdString(), errorMessage.contains(QStringLiteral("timed out")));
+
+    // rescans take as long as the scan takes
+    m_syncthing->setDelay("db/scan", 500);
+    bool scanFinished = false;
+    QNetworkReply::NetworkError scanError = QNetworkReply::UnknownNetworkError;
+    reply = m_connection->rescan(QStringLiteral("dir1"));
+    QObject::connect(reply, &QNetworkReply::finished, [reply, &scanFinished, &scanError] {
+        scanFinished = true;
+        scanError = reply->error();
+    });
+    CPPUNIT_ASSERT(waitFor([&scanFinished] { return scanFinished; }));
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(QNetworkReply::NoError), static_cast<int>(scanError));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(2), m_connection->abortedRequests());
+}
+
+/*!
+ * \brief Tests whether statistics are served from the response cache and other responses are not cached.
+ */
+void ConnectionTests::testResponseCache()
+{
+    connect(SyncthingConnectProfile::Config);
+    int responses = 0;
+    const auto countResponse = [&responses] (const QByteArray &) {
+        ++responses;
+    };
+
+    m_connection->requestRestData(QStringLiteral("stats/device"), QUrlQuery(), countResponse);
+    CPPUNIT_ASSERT(waitFor([&responses] { return responses == 1; }));
+    m_connection->requestRestData(QStringLiteral("stats/device"), QUrlQuery(), countResponse);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("cached response passed immediately", 2, responses);
+    CPPUNIT_ASSERT_EQUAL(1, m_syncthing->requestCount("stats/device"));
+
+    m_connection->requestRestData(QStringLiteral("stats/device"), QUrlQuery(), countResponse, SyncthingCachePolicy::Fresh);
+    CPPUNIT_ASSERT(waitFor([&responses] { return responses == 3; }));
+    CPPUNIT_ASSERT_EQUAL(2, m_syncthing->requestCount("stats/device"));
+
+    m_connection->requestRestData(QStringLiteral("system/config"), QUrlQuery(), countResponse);
+    CPPUNIT_ASSERT(waitFor([&responses] { return responses == 4; }));
+    m_connection->requestRestData(QStringLiteral("system/config"), QUrlQuery(), countResponse);
+    CPPUNIT_ASSERT(waitFor([&responses] { return responses == 5; }));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("config not cached", 3, m_syncthing->requestCount("system/config"));
+
+    m_connection->setApiKey(QByteArray("otherkey"));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("cache cleared when changing API key", 0, m_connection->responseCache().size());
+    m_connection->requestRestData(QStringLiteral("stats/device"), QUrlQuery(), countResponse);
+    CPPUNIT_ASSERT(waitFor([&responses] { return responses == 6; }));
+    CPPUNIT_ASSERT_EQUAL(3, m_syncthing->requestCount("stats/device"));
+}
+
+/*!
+ * \brief Tests whether byte counts of directories exceeding the range of int are read and snapshotted correctly.
+ */
+void ConnectionTests::testDirStatusBeyond2GiB()
+{
+    m_syncthing->setResponse("db/status", "{\"globalBytes\":5368709120,\"localBytes\":3221225472,\"needBytes\":2147483648,"
+                                          "\"globalFiles\":10,\"localFiles\":6,\"needFiles\":4,\"state\":\"syncing\"}");
+    m_connection->setRequestingDirStatusOnConnect(true);
+    connect(SyncthingConnectProfile::Config);
+    CPPUNIT_ASSERT_EQUAL(1, m_syncthing->requestCount("db/status"));
+
+    const SyncthingDir &dir = m_connection->dirInfo().front();
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(5368709120ull), dir.globalBytes);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(3221225472ull), dir.localBytes);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(2147483648ull), dir.neededByted);
+    CPPUNIT_ASSERT_EQUAL(10, dir.globalFiles);
+    CPPUNIT_ASSERT_EQUAL(4, dir.neededFiles);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(SyncthingDirStatus::Synchronizing), static_cast<int>(dir.status));
+    CPPUNIT_ASSERT_EQUAL(60, dir.progressPercentage);
+
+    // the sizes must survive the snapshot handed to syncthingctl
+    SyncthingConnection restoredConnection;
+    CPPUNIT_ASSERT(restoredConnection.restoreSnapshot(m_connection->snapshot()));
+    const SyncthingDir &restoredDir = restoredConnection.dirInfo().front();
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(5368709120ull), restoredDir.globalBytes);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(3221225472ull), restoredDir.localBytes);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64>(2147483648ull), restoredDir.neededByted);
+    CPPUNIT_ASSERT_EQUAL(10, restoredDir.globalFiles);
+    CPPUNIT_ASSERT_EQUAL(6, restoredDir.localFiles);
+    CPPUNIT_ASSERT_EQUAL(4, restoredDir.neededFiles);
+}
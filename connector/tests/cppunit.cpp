@@ -0,0 +1 @@
+#include <c++utilities/tests/cppunit.h>
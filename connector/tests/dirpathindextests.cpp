@@ -0,0 +1,182 @@
+#include "../syncthingdir.h"
+#include "../syncthingdirpathindex.h"
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+using namespace std;
+using namespace Data;
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The DirPathIndexTests class tests the SyncthingDirPathIndex class.
+ */
+class DirPathIndexTests : public TestFixture
+{
+    CPPUNIT_TEST_SUITE(DirPathIndexTests);
+    CPPUNIT_TEST(testNestedDirs);
+    CPPUNIT_TEST(testPathOutsideDirs);
+    CPPUNIT_TEST(testSiblingPrefixes);
+    CPPUNIT_TEST(testUnnormalizedPaths);
+    CPPUNIT_TEST(testSymlinks);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testNestedDirs();
+    void testPathOutsideDirs();
+    void testSiblingPrefixes();
+    void testUnnormalizedPaths();
+    void testSymlinks();
+
+private:
+    int find(const QString &path);
+
+    vector<SyncthingDir> m_dirs;
+    SyncthingDirPathIndex m_index;
+    QString m_relativePath;
+    QString m_workingDir;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DirPathIndexTests);
+
+void DirPathIndexTests::setUp()
+{
+    m_dirs.clear();
+    m_index.clear();
+    m_relativePath = QStringLiteral("not set");
+    m_workingDir = QDir::currentPath();
+}
+
+void DirPathIndexTests::tearDown()
+{
+    QDir::setCurrent(m_workingDir);
+}
+
+/*!
+ * \brief Looks up the specified \a path in the index (building it first if required) and returns the index of the dir.
+ */
+int DirPathIndexTests::find(const QString &path)
+{
+    if(m_index.isEmpty()) {
+        m_index.build(m_dirs);
+    }
+    m_relativePath = QStringLiteral("not set");
+    return m_index.find(path, &m_relativePath);
+}
+
+/*!
+ * \brief Tests whether the innermost of nested dirs is found.
+ */
+void DirPathIndexTests::testNestedDirs()
+{
+    m_dirs.emplace_back(QStringLiteral("inner"), QString(), QStringLiteral("/syncthingtray-test/a/b/c"));
+    m_dirs.emplace_back(QStringLiteral("outer"), QString(), QStringLiteral("/syncthingtray-test/a"));
+    m_dirs.emplace_back(QStringLiteral("middle"), QString(), QStringLiteral("/syncthingtray-test/a/b/"));
+
+    CPPUNIT_ASSERT_EQUAL(0, find(QStringLiteral("/syncthingtray-test/a/b/c/d/file")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("d/file").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL(2, find(QStringLiteral("/syncthingtray-test/a/b")));
+    CPPUNIT_ASSERT_MESSAGE("relative path empty for dir itself", m_relativePath.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(2, find(QStringLiteral("/syncthingtray-test/a/b/cd")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("cd").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL(1, find(QStringLiteral("/syncthingtray-test/a/x")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("x").toStdString(), m_relativePath.toStdString());
+}
+
+/*!
+ * \brief Tests whether paths not within any dir are not found.
+ */
+void DirPathIndexTests::testPathOutsideDirs()
+{
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing found before building index", -1, m_index.find(QStringLiteral("/syncthingtray-test")));
+
+    m_dirs.emplace_back(QStringLiteral("dir"), QString(), QStringLiteral("/syncthingtray-test/a/b"));
+    m_dirs.emplace_back(QStringLiteral("no path"), QString(), QString());
+    CPPUNIT_ASSERT_EQUAL(-1, find(QStringLiteral("/syncthingtray-test/x/y")));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("relative path untouched", QStringLiteral("not set").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("parent of dir", -1, find(QStringLiteral("/syncthingtray-test/a")));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("root", -1, find(QStringLiteral("/")));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("empty path", -1, find(QString()));
+}
+
+/*!
+ * \brief Tests whether dirs whose names share a prefix are distinguished.
+ */
+void DirPathIndexTests::testSiblingPrefixes()
+{
+    m_dirs.emplace_back(QStringLiteral("foo"), QString(), QStringLiteral("/syncthingtray-test/a/foo"));
+    m_dirs.emplace_back(QStringLiteral("foobar"), QString(), QStringLiteral("/syncthingtray-test/a/foobar"));
+
+    CPPUNIT_ASSERT_EQUAL(1, find(QStringLiteral("/syncthingtray-test/a/foobar/x")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("x").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL(0, find(QStringLiteral("/syncthingtray-test/a/foo/x")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("x").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL(-1, find(QStringLiteral("/syncthingtray-test/a/fo")));
+    CPPUNIT_ASSERT_EQUAL(-1, find(QStringLiteral("/syncthingtray-test/a/foob/x")));
+}
+
+/*!
+ * \brief Tests whether relative paths and paths containing "~", "." and ".." are normalized for dirs and lookups.
+ */
+void DirPathIndexTests::testUnnormalizedPaths()
+{
+    QTemporaryDir workingDir;
+    CPPUNIT_ASSERT(workingDir.isValid());
+    CPPUNIT_ASSERT(QDir::setCurrent(workingDir.path()));
+    const QString currentDir(QDir::currentPath());
+
+    m_dirs.emplace_back(QStringLiteral("home"), QString(), QStringLiteral("~/syncthingtray-test"));
+    m_dirs.emplace_back(QStringLiteral("dots"), QString(), QStringLiteral("/syncthingtray-test/a/./b/../c//"));
+    m_dirs.emplace_back(QStringLiteral("relative"), QString(), QStringLiteral("rel/dir"));
+    m_dirs.emplace_back(QStringLiteral("absolute"), QString(), QStringLiteral("/syncthingtray-test/rel"));
+
+    CPPUNIT_ASSERT_EQUAL(0, find(QDir::homePath() + QStringLiteral("/syncthingtray-test/file")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("file").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL(0, find(QStringLiteral("~/syncthingtray-test/file")));
+    CPPUNIT_ASSERT_EQUAL(1, find(QStringLiteral("/syncthingtray-test/a/c/x/./y//z")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("x/y/z").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL(1, find(QStringLiteral("/syncthingtray-test/a/b/../c/x")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("x").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("leaving dir via ..", -1, find(QStringLiteral("/syncthingtray-test/a/c/../b/x")));
+    CPPUNIT_ASSERT_EQUAL(2, find(currentDir + QStringLiteral("/rel/dir/file")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("file").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL(2, find(QStringLiteral("rel/dir/file")));
+    CPPUNIT_ASSERT_EQUAL(2, find(QStringLiteral("./rel/x/../dir/file")));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("relative path not matching absolute dir", -1, find(QStringLiteral("syncthingtray-test/rel/file")));
+}
+
+/*!
+ * \brief Tests whether dirs are found via symlinks to them and via their actual location if their path is a symlink.
+ */
+void DirPathIndexTests::testSymlinks()
+{
+#ifndef PLATFORM_WINDOWS
+    QTemporaryDir tempDir;
+    CPPUNIT_ASSERT(tempDir.isValid());
+    const QString base(tempDir.path());
+    CPPUNIT_ASSERT(QDir(base).mkpath(QStringLiteral("real/sub")));
+    CPPUNIT_ASSERT(QDir(base).mkpath(QStringLiteral("other")));
+    CPPUNIT_ASSERT(QFile::link(base + QStringLiteral("/real"), base + QStringLiteral("/link")));
+    CPPUNIT_ASSERT(QFile::link(base + QStringLiteral("/other"), base + QStringLiteral("/real/sub/link-to-other")));
+
+    m_dirs.emplace_back(QStringLiteral("real"), QString(), base + QStringLiteral("/real"));
+    m_dirs.emplace_back(QStringLiteral("via link"), QString(), base + QStringLiteral("/link/sub"));
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("symlink to dir", 0, find(base + QStringLiteral("/link/file")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("file").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("actual location of dir", 1, find(base + QStringLiteral("/real/sub/not/existing")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("not/existing").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("path via link", 1, find(base + QStringLiteral("/link/sub/file")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("file").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("symlink within dir not resolved", 1, find(base + QStringLiteral("/real/sub/link-to-other")));
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("link-to-other").toStdString(), m_relativePath.toStdString());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("target of symlink within dir", -1, find(base + QStringLiteral("/other")));
+#endif
+}
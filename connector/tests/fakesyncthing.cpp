@@ -0,0 +1,162 @@
+#include "./fakesyncthing.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <memory>
+
+using namespace std;
+
+namespace Data {
+
+/*!
+ * \class FakeSyncthing
+ * \brief The FakeSyncthing class serves canned responses for REST API endpoints to test SyncthingConnection.
+ *
+ * Each connection serves one request and is closed afterwards. Endpoints without response are answered with 404.
+ * Requests can be delayed or ignored (not answered at all) to test deadlines.
+ */
+
+FakeSyncthing::FakeSyncthing()
+{
+    QObject::connect(&m_server, &QTcpServer::newConnection, [this] {
+        handleConnection();
+    });
+    m_server.listen(QHostAddress::LocalHost);
+}
+
+/*!
+ * \brief Returns the URL to be used as Syncthing URL.
+ */
+QString FakeSyncthing::url() const
+{
+    return QStringLiteral("http://127.0.0.1:") + QString::number(m_server.serverPort());
+}
+
+/*!
+ * \brief Sets the \a response for the endpoint with the specified \a path (relative to "/rest/").
+ */
+void FakeSyncthing::setResponse(const QByteArray &path, const QByteArray &response)
+{
+    m_responses[path] = response;
+}
+
+/*!
+ * \brief Removes the response for the endpoint with the specified \a path so requests are answered with 404.
+ */
+void FakeSyncthing::removeResponse(const QByteArray &path)
+{
+    m_responses.remove(path);
+}
+
+/*!
+ * \brief Answers requests to the endpoint with the specified \a path only after \a delay milliseconds.
+ */
+void FakeSyncthing::setDelay(const QByteArray &path, int delay)
+{
+    m_delays[path] = delay;
+}
+
+/*!
+ * \brief Does not answer the next \a count requests to the endpoint with the specified \a path.
+ */
+void FakeSyncthing::setIgnoredRequests(const QByteArray &path, int count)
+{
+    m_ignoredRequests[path] = count;
+}
+
+/*!
+ * \brief Returns the number of requests received for the endpoint with the specified \a path.
+ */
+int FakeSyncthing::requestCount(const QByteArray &path) const
+{
+    return m_requestCounts.value(path);
+}
+
+/*!
+ * \brief Resets the number of requests received for all endpoints.
+ */
+void FakeSyncthing::resetRequestCounts()
+{
+    m_requestCounts.clear();
+}
+
+void FakeSyncthing::handleConnection()
+{
+    while(QTcpSocket *const socket = m_server.nextPendingConnection()) {
+        auto buffer = make_shared<QByteArray>();
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket, buffer] {
+            buffer->append(socket->readAll());
+            const int headerEnd = buffer->indexOf("\r\n\r\n");
+            if(headerEnd < 0) {
+                return;
+            }
+            // the request line looks like "GET /rest/system/config?foo=bar HTTP/1.1"; only the path is relevant
+            const QByteArray requestLine(buffer->left(buffer->indexOf("\r\n")));
+            const int pathStart = requestLine.indexOf("/rest/") + 6;
+            int pathEnd = requestLine.indexOf('?', pathStart);
+            if(pathEnd < 0) {
+                pathEnd = requestLine.indexOf(' ', pathStart);
+            }
+            buffer->clear();
+            handleRequest(socket, requestLine.mid(pathStart, pathEnd - pathStart));
+        });
+    }
+}
+
+void FakeSyncthing::handleRequest(QTcpSocket *socket, const QByteArray &path)
+{
+    ++m_requestCounts[path];
+    int &ignoredRequests = m_ignoredRequests[path];
+    if(ignoredRequests > 0) {
+        --ignoredRequests;
+        return;
+    }
+    const auto response = m_responses.constFind(path);
+    const QByteArray status(response != m_responses.cend() ? "200 OK" : "404 Not Found");
+    const QByteArray body(response != m_responses.cend() ? *response : QByteArray("404 page not found\n"));
+    QTimer::singleShot(m_delays.value(path), socket, [socket, status, body] {
+        socket->write("HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(body.size())
+                      + "\r\nConnection: close\r\n\r\n" + body);
+        socket->disconnectFromHost();
+    });
+}
+
+/*!
+ * \brief Processes events until \a condition returns true or \a timeout milliseconds have passed.
+ * \returns Returns whether \a condition returned true.
+ */
+bool waitFor(const function<bool()> &condition, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(!condition()) {
+        if(timer.elapsed() > timeout) {
+            return false;
+        }
+        QEventLoop loop;
+        QTimer::singleShot(10, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return true;
+}
+
+/*!
+ * \brief Ensures a QCoreApplication exists; it is required to process network events.
+ */
+void ensureApplication()
+{
+    static int argc = 1;
+    static char appName[] = "syncthingconnector_tests";
+    static char *argv[] = { appName, nullptr };
+    if(!QCoreApplication::instance()) {
+        new QCoreApplication(argc, argv);
+    }
+}
+
+} // namespace Data
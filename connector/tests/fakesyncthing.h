@@ -0,0 +1,44 @@
+#ifndef SYNCTHINGCONNECTOR_TESTS_FAKESYNCTHING_H
+#define SYNCTHINGCONNECTOR_TESTS_FAKESYNCTHING_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QTcpServer>
+
+#include <functional>
+
+QT_FORWARD_DECLARE_CLASS(QTcpSocket)
+
+namespace Data {
+
+class FakeSyncthing
+{
+public:
+    FakeSyncthing();
+
+    QString url() const;
+    void setResponse(const QByteArray &path, const QByteArray &response);
+    void removeResponse(const QByteArray &path);
+    void setDelay(const QByteArray &path, int delay);
+    void setIgnoredRequests(const QByteArray &path, int count);
+    int requestCount(const QByteArray &path) const;
+    void resetRequestCounts();
+
+private:
+    void handleConnection();
+    void handleRequest(QTcpSocket *socket, const QByteArray &path);
+
+    QTcpServer m_server;
+    QHash<QByteArray, QByteArray> m_responses;
+    QHash<QByteArray, int> m_delays;
+    QHash<QByteArray, int> m_ignoredRequests;
+    QHash<QByteArray, int> m_requestCounts;
+};
+
+bool waitFor(const std::function<bool()> &condition, int timeout = 5000);
+void ensureApplication();
+
+} // namespace Data
+
+#endif // SYNCTHINGCONNECTOR_TESTS_FAKESYNCTHING_H
@@ -0,0 +1,146 @@
+#include "../syncthingipc.h"
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonObject>
+
+using namespace std;
+using namespace Data;
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The IpcTests class tests reading and writing the frames used to communicate with Syncthing Tray.
+ */
+class IpcTests : public TestFixture
+{
+    CPPUNIT_TEST_SUITE(IpcTests);
+    CPPUNIT_TEST(testRoundTrip);
+    CPPUNIT_TEST(testTruncatedFrame);
+    CPPUNIT_TEST(testOversizedFrame);
+    CPPUNIT_TEST(testInvalidFrame);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testRoundTrip();
+    void testTruncatedFrame();
+    void testOversizedFrame();
+    void testInvalidFrame();
+
+private:
+    SyncthingIpcFrameStatus read(const QByteArray &data, qint64 *consumed = nullptr);
+
+    unsigned char m_version;
+    unsigned char m_type;
+    QJsonObject m_payload;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IpcTests);
+
+void IpcTests::setUp()
+{
+    m_version = m_type = 0;
+    m_payload = QJsonObject();
+}
+
+void IpcTests::tearDown()
+{}
+
+/*!
+ * \brief Returns the frame header for the specified \a payloadSize.
+ */
+static QByteArray frameHeader(quint32 payloadSize)
+{
+    QByteArray header("\xFF\xFF", 2);
+    header += static_cast<char>(syncthingIpcVersion);
+    header += static_cast<char>(SyncthingIpcRequest::StatusSnapshot);
+    for(int shift = 24; shift >= 0; shift -= 8) {
+        header += static_cast<char>((payloadSize >> shift) & 0xFF);
+    }
+    return header;
+}
+
+/*!
+ * \brief Reads a frame from the specified \a data.
+ * \param consumed Is set to the number of bytes consumed from \a data.
+ */
+SyncthingIpcFrameStatus IpcTests::read(const QByteArray &data, qint64 *consumed)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    const SyncthingIpcFrameStatus status = readSyncthingIpcFrame(buffer, m_version, m_type, m_payload);
+    if(consumed) {
+        *consumed = buffer.pos();
+    }
+    return status;
+}
+
+/*!
+ * \brief Tests whether frames written via writeSyncthingIpcFrame() are read back by readSyncthingIpcFrame().
+ */
+void IpcTests::testRoundTrip()
+{
+    const QJsonObject request{
+        {QStringLiteral("url"), QStringLiteral("http://localhost:8080")},
+        {QStringLiteral("commands"), QJsonArray{QStringLiteral("rescan"), QStringLiteral("ümläut")}}
+    };
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    writeSyncthingIpcFrame(buffer, static_cast<unsigned char>(SyncthingIpcRequest::Command), request);
+    writeSyncthingIpcFrame(buffer, static_cast<unsigned char>(SyncthingIpcResult::NoTray), QJsonObject());
+    buffer.seek(0);
+
+    CPPUNIT_ASSERT(readSyncthingIpcFrame(buffer, m_version, m_type, m_payload) == SyncthingIpcFrameStatus::Complete);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(syncthingIpcVersion), static_cast<int>(m_version));
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(SyncthingIpcRequest::Command), static_cast<int>(m_type));
+    CPPUNIT_ASSERT(request == m_payload);
+
+    CPPUNIT_ASSERT(readSyncthingIpcFrame(buffer, m_version, m_type, m_payload) == SyncthingIpcFrameStatus::Complete);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(SyncthingIpcResult::NoTray), static_cast<int>(m_type));
+    CPPUNIT_ASSERT(m_payload.isEmpty());
+    CPPUNIT_ASSERT_MESSAGE("both frames consumed", buffer.atEnd());
+}
+
+/*!
+ * \brief Tests whether a truncated frame is reported as incomplete without consuming any data.
+ */
+void IpcTests::testTruncatedFrame()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    writeSyncthingIpcFrame(buffer, static_cast<unsigned char>(SyncthingIpcRequest::StatusSnapshot), QJsonObject{{QStringLiteral("url"), QStringLiteral("http://localhost:8080")}});
+    const QByteArray frame(buffer.data());
+
+    for(int size = 0; size != frame.size(); ++size) {
+        qint64 consumed = -1;
+        CPPUNIT_ASSERT_MESSAGE("truncated frame incomplete", read(frame.left(size), &consumed) == SyncthingIpcFrameStatus::Incomplete);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing consumed", static_cast<qint64>(0), consumed);
+    }
+    CPPUNIT_ASSERT(read(frame) == SyncthingIpcFrameStatus::Complete);
+}
+
+/*!
+ * \brief Tests whether frames announcing a payload exceeding the max. size are rejected before the payload is received.
+ */
+void IpcTests::testOversizedFrame()
+{
+    CPPUNIT_ASSERT(read(frameHeader(64 * 1024 * 1024) + "{}") == SyncthingIpcFrameStatus::Incomplete);
+    CPPUNIT_ASSERT(read(frameHeader(64 * 1024 * 1024 + 1) + "{}") == SyncthingIpcFrameStatus::Invalid);
+    CPPUNIT_ASSERT(read(frameHeader(0xFFFFFFFF)) == SyncthingIpcFrameStatus::Invalid);
+}
+
+/*!
+ * \brief Tests whether data which is no frame or contains no valid JSON is rejected.
+ */
+void IpcTests::testInvalidFrame()
+{
+    CPPUNIT_ASSERT(read(QByteArray("\x00\x00\x00\x01", 4)) == SyncthingIpcFrameStatus::NoFrame);
+    CPPUNIT_ASSERT(read(frameHeader(3) + "{\"a") == SyncthingIpcFrameStatus::Invalid);
+    CPPUNIT_ASSERT(read(frameHeader(2) + "{}") == SyncthingIpcFrameStatus::Complete);
+}
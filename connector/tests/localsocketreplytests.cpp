@@ -0,0 +1,170 @@
+#include "../syncthingconnection.h"
+
+#include "./fakesyncthing.h"
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QNetworkReply>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <memory>
+
+using namespace std;
+using namespace Data;
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The LocalSocketReplyTests class tests the HTTP client used by SyncthingConnection for "unix://" URLs.
+ *
+ * The fake server sends the response in the specified parts with a delay in between so the reply needs to handle
+ * the response being split across several reads.
+ */
+class LocalSocketReplyTests : public TestFixture
+{
+    CPPUNIT_TEST_SUITE(LocalSocketReplyTests);
+    CPPUNIT_TEST(testContentLength);
+    CPPUNIT_TEST(testChunked);
+    CPPUNIT_TEST(testCloseDelimited);
+    CPPUNIT_TEST(testErrorStatus);
+    CPPUNIT_TEST(testPrematureClose);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testContentLength();
+    void testChunked();
+    void testCloseDelimited();
+    void testErrorStatus();
+    void testPrematureClose();
+
+private:
+    QNetworkReply *request(const QList<QByteArray> &responseParts, bool closeAfterwards = false);
+
+    unique_ptr<QLocalServer> m_server;
+    unique_ptr<SyncthingConnection> m_connection;
+    unique_ptr<QNetworkReply> m_reply;
+    QByteArray m_request;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LocalSocketReplyTests);
+
+void LocalSocketReplyTests::setUp()
+{
+    ensureApplication();
+    const QString serverName(QStringLiteral("syncthingtray-test-") + QString::number(QCoreApplication::applicationPid()));
+    QLocalServer::removeServer(serverName);
+    m_server.reset(new QLocalServer);
+    CPPUNIT_ASSERT(m_server->listen(serverName));
+    m_connection.reset(new SyncthingConnection(QStringLiteral("unix://") + m_server->fullServerName(), QByteArray("testkey")));
+    m_request.clear();
+}
+
+void LocalSocketReplyTests::tearDown()
+{
+    m_reply.reset();
+    m_connection.reset();
+    m_server.reset();
+}
+
+/*!
+ * \brief Requests "system/status" and lets the fake server respond with the specified \a responseParts.
+ * \returns Returns the reply after it has finished.
+ */
+QNetworkReply *LocalSocketReplyTests::request(const QList<QByteArray> &responseParts, bool closeAfterwards)
+{
+    QObject::connect(m_server.get(), &QLocalServer::newConnection, [this, responseParts, closeAfterwards] {
+        QLocalSocket *const socket = m_server->nextPendingConnection();
+        QObject::connect(socket, &QLocalSocket::readyRead, [this, socket, responseParts, closeAfterwards] {
+            m_request += socket->readAll();
+            if(!m_request.contains("\r\n\r\n")) {
+                return;
+            }
+            int delay = 0;
+            for(const QByteArray &part : responseParts) {
+                QTimer::singleShot(delay, socket, [socket, part] {
+                    socket->write(part);
+                    socket->flush();
+                });
+                delay += 20;
+            }
+            if(closeAfterwards) {
+                QTimer::singleShot(delay, socket, &QLocalSocket::disconnectFromServer);
+            }
+        });
+    });
+    m_reply.reset(m_connection->requestRestData(QStringLiteral("system/status"), QUrlQuery()));
+    CPPUNIT_ASSERT_MESSAGE("reply finished", waitFor([this] { return m_reply->isFinished(); }));
+    CPPUNIT_ASSERT_MESSAGE("request line", m_request.startsWith("GET /rest/system/status HTTP/1.1\r\n"));
+    CPPUNIT_ASSERT_MESSAGE("API key sent", m_request.contains("\r\nX-API-Key: testkey\r\n"));
+    return m_reply.get();
+}
+
+/*!
+ * \brief Tests reading a response with "Content-Length"; the server does not close the connection.
+ */
+void LocalSocketReplyTests::testContentLength()
+{
+    QNetworkReply *const reply = request({
+        "HTTP/1.1 200 OK\r\nContent-Length: 11\r\n", "\r\nhello", " world"
+    });
+    CPPUNIT_ASSERT_EQUAL(QNetworkReply::NoError, reply->error());
+    CPPUNIT_ASSERT_EQUAL(200, reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+    CPPUNIT_ASSERT_EQUAL(QByteArray("11").toStdString(), reply->rawHeader("Content-Length").toStdString());
+    CPPUNIT_ASSERT_EQUAL(QByteArray("hello world").toStdString(), reply->readAll().toStdString());
+}
+
+/*!
+ * \brief Tests decoding a chunked response with chunk sizes, chunk data and CRLFs split across reads.
+ */
+void LocalSocketReplyTests::testChunked()
+{
+    QNetworkReply *const reply = request({
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r", "\nhel", "lo\r", "\n6;ext=1\r\n wor", "ld\r\n0\r\n", "\r\n"
+    });
+    CPPUNIT_ASSERT_EQUAL(QNetworkReply::NoError, reply->error());
+    CPPUNIT_ASSERT_EQUAL(QByteArray("hello world").toStdString(), reply->readAll().toStdString());
+}
+
+/*!
+ * \brief Tests reading a response without "Content-Length" which is terminated by closing the connection.
+ */
+void LocalSocketReplyTests::testCloseDelimited()
+{
+    QNetworkReply *const reply = request({
+        "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n{\"a\":", "1}"
+    }, true);
+    CPPUNIT_ASSERT_EQUAL(QNetworkReply::NoError, reply->error());
+    CPPUNIT_ASSERT_EQUAL(QByteArray("{\"a\":1}").toStdString(), reply->readAll().toStdString());
+}
+
+/*!
+ * \brief Tests whether an error status is reported as error while the body is still readable.
+ */
+void LocalSocketReplyTests::testErrorStatus()
+{
+    QNetworkReply *const reply = request({
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nnot found"
+    });
+    CPPUNIT_ASSERT_EQUAL(QNetworkReply::ContentNotFoundError, reply->error());
+    CPPUNIT_ASSERT_EQUAL(404, reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+    CPPUNIT_ASSERT_EQUAL(QStringLiteral("Not Found").toStdString(), reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString().toStdString());
+    CPPUNIT_ASSERT_EQUAL(QByteArray("not found").toStdString(), reply->readAll().toStdString());
+}
+
+/*!
+ * \brief Tests whether closing the connection before the announced content has been sent is reported as error.
+ */
+void LocalSocketReplyTests::testPrematureClose()
+{
+    QNetworkReply *const reply = request({
+        "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n", "abc"
+    }, true);
+    CPPUNIT_ASSERT_EQUAL(QNetworkReply::RemoteHostClosedError, reply->error());
+}
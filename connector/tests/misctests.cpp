@@ -0,0 +1,117 @@
+#include "../syncthingconnection.h"
+#include "../syncthingresponsecache.h"
+
+#include "./fakesyncthing.h"
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <QThread>
+
+using namespace std;
+using namespace Data;
+using namespace CPPUNIT_NS;
+
+/*!
+ * \brief The MiscTests class tests parts of the connector which do not require a Syncthing instance.
+ */
+class MiscTests : public TestFixture
+{
+    CPPUNIT_TEST_SUITE(MiscTests);
+    CPPUNIT_TEST(testConnectProfileFlags);
+    CPPUNIT_TEST(testResponseCacheTtl);
+    CPPUNIT_TEST(testResponseCacheLimits);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testConnectProfileFlags();
+    void testResponseCacheTtl();
+    void testResponseCacheLimits();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MiscTests);
+
+void MiscTests::setUp()
+{
+    ensureApplication();
+}
+
+void MiscTests::tearDown()
+{}
+
+/*!
+ * \brief Tests whether each flag of SyncthingConnectProfile can be tested via & and the config is always requested.
+ */
+void MiscTests::testConnectProfileFlags()
+{
+    const SyncthingConnectProfile flags[] = {
+        SyncthingConnectProfile::Config, SyncthingConnectProfile::Status, SyncthingConnectProfile::Connections,
+        SyncthingConnectProfile::DirStatistics, SyncthingConnectProfile::DevStatistics, SyncthingConnectProfile::Errors,
+        SyncthingConnectProfile::Events
+    };
+    for(const SyncthingConnectProfile &flag : flags) {
+        CPPUNIT_ASSERT(flag & flag);
+        CPPUNIT_ASSERT(SyncthingConnectProfile::Full & flag);
+        for(const SyncthingConnectProfile &other : flags) {
+            CPPUNIT_ASSERT_EQUAL(&flag == &other, static_cast<bool>(flag & other));
+        }
+    }
+
+    SyncthingConnection connection;
+    CPPUNIT_ASSERT(connection.connectProfile() & SyncthingConnectProfile::Full);
+    connection.setConnectProfile(SyncthingConnectProfile::Status);
+    CPPUNIT_ASSERT_MESSAGE("config always requested", connection.connectProfile() & SyncthingConnectProfile::Config);
+    CPPUNIT_ASSERT(connection.connectProfile() & SyncthingConnectProfile::Status);
+    CPPUNIT_ASSERT(!(connection.connectProfile() & SyncthingConnectProfile::Events));
+}
+
+/*!
+ * \brief Tests whether entries of SyncthingResponseCache expire after their TTL and can be invalidated.
+ */
+void MiscTests::testResponseCacheTtl()
+{
+    SyncthingResponseCache cache;
+    cache.insert(QStringLiteral("stats/device?"), QByteArray("{}"), 50);
+    cache.insert(QStringLiteral("stats/folder?"), QByteArray("{}"), 60 * 1000);
+    cache.insert(QStringLiteral("system/config?"), QByteArray("{}"), 0);
+    CPPUNIT_ASSERT_MESSAGE("responses without TTL not cached", !cache.find(QStringLiteral("system/config?")));
+    const QByteArray *const response = cache.find(QStringLiteral("stats/device?"));
+    CPPUNIT_ASSERT(response);
+    CPPUNIT_ASSERT_EQUAL(QByteArray("{}").toStdString(), response->toStdString());
+    CPPUNIT_ASSERT_EQUAL(4, cache.totalBytes());
+
+    QThread::msleep(100);
+    CPPUNIT_ASSERT_MESSAGE("expired", !cache.find(QStringLiteral("stats/device?")));
+    CPPUNIT_ASSERT_MESSAGE("not expired yet", cache.find(QStringLiteral("stats/folder?")));
+
+    cache.invalidate(QStringLiteral("stats/"));
+    CPPUNIT_ASSERT(!cache.find(QStringLiteral("stats/folder?")));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+    CPPUNIT_ASSERT_EQUAL(0, cache.totalBytes());
+}
+
+/*!
+ * \brief Tests whether SyncthingResponseCache evicts the entries expiring first when exceeding its limits.
+ */
+void MiscTests::testResponseCacheLimits()
+{
+    SyncthingResponseCache cache;
+    cache.setLimits(2, 10);
+    cache.insert(QStringLiteral("a"), QByteArray("123"), 3000);
+    cache.insert(QStringLiteral("b"), QByteArray("123"), 1000);
+    cache.insert(QStringLiteral("c"), QByteArray("123"), 2000);
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+    CPPUNIT_ASSERT_MESSAGE("entry expiring first evicted", !cache.find(QStringLiteral("b")));
+    CPPUNIT_ASSERT(cache.find(QStringLiteral("a")));
+    CPPUNIT_ASSERT(cache.find(QStringLiteral("c")));
+
+    cache.insert(QStringLiteral("d"), QByteArray("12345678"), 4000);
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+    CPPUNIT_ASSERT_EQUAL(8, cache.totalBytes());
+    cache.insert(QStringLiteral("e"), QByteArray("12345678901"), 4000);
+    CPPUNIT_ASSERT_MESSAGE("responses exceeding the size limit not cached", !cache.find(QStringLiteral("e")));
+    CPPUNIT_ASSERT(cache.find(QStringLiteral("d")));
+}
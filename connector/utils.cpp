@@ -32,7 +32,8 @@ bool isLocal(const QUrl &url)
 {
     const QString host(url.host());
     const QHostAddress hostAddress(host);
-    return host.compare(QLatin1String("localhost"), Qt::CaseInsensitive) == 0
+    return url.scheme() == QLatin1String("unix")
+            || host.compare(QLatin1String("localhost"), Qt::CaseInsensitive) == 0
             || hostAddress.isLoopback()
             || QNetworkInterface::allAddresses().contains(hostAddress);
 }
@@ -1,8 +1,11 @@
 #include "./settings.h"
 #include "./singleinstance.h"
+#include "./startupprofile.h"
+#include "./paintbenchmark.h"
 
 #include "../gui/trayicon.h"
 #include "../gui/traywidget.h"
+#include "../gui/statusiconengine.h"
 
 #include "../../connector/syncthingprocess.h"
 #ifdef LIB_SYNCTHING_CONNECTOR_SUPPORT_SYSTEMD
@@ -24,6 +27,7 @@
 #include <QNetworkAccessManager>
 #include <QMessageBox>
 #include <QStringBuilder>
+#include <QTimer>
 
 #include <iostream>
 
@@ -43,6 +47,20 @@ void handleSystemdServiceError(const QString &context, const QString &name, cons
 }
 #endif
 
+/*!
+ * \brief Starts Syncthing via the launcher if enabled.
+ * \remarks Invoked when entering the event loop so the tray icon is shown as early as possible. It is nevertheless
+ *          scheduled before the tray widget applies the settings so Syncthing is launched before connecting to it.
+ */
+void startLauncher()
+{
+    const auto &launcher = Settings::values().launcher;
+    if(launcher.enabled) {
+        syncthingProcess().startSyncthing(launcher.syncthingCmd());
+        StartupProfile::mark("launcher started");
+    }
+}
+
 int initSyncthingTray(bool windowed, bool waitForTray)
 {
     auto &v = Settings::values();
@@ -52,27 +70,27 @@ int initSyncthingTray(bool windowed, bool waitForTray)
     QObject::connect(&service, &SyncthingService::errorOccurred, &handleSystemdServiceError);
 #endif
     if(windowed) {
-        if(v.launcher.enabled) {
-            syncthingProcess().startSyncthing(v.launcher.syncthingCmd());
-        }
+        QTimer::singleShot(0, &startLauncher);
         auto *trayWidget = new TrayWidget;
         trayWidget->setAttribute(Qt::WA_DeleteOnClose);
         trayWidget->show();
+        StartupProfile::mark("tray widget shown");
     } else {
 #ifndef QT_NO_SYSTEMTRAYICON
         if(QSystemTrayIcon::isSystemTrayAvailable() || waitForTray) {
-            if(v.launcher.enabled) {
-                syncthingProcess().startSyncthing(v.launcher.syncthingCmd());
-            }
+            QTimer::singleShot(0, &startLauncher);
             auto *trayIcon = new TrayIcon;
             trayIcon->show();
+            StartupProfile::mark("tray icon shown");
             if(v.firstLaunch) {
-                QMessageBox msgBox;
-                msgBox.setIcon(QMessageBox::Information);
-                msgBox.setText(QCoreApplication::translate("main", "You must configure how to connect to Syncthing when using Syncthing Tray the first time."));
-                msgBox.setInformativeText(QCoreApplication::translate("main", "Note that the settings dialog allows importing URL, credentials and API-key from the local Syncthing configuration."));
-                msgBox.exec();
-                trayIcon->trayMenu().widget()->showSettingsDialog();
+                QTimer::singleShot(0, trayIcon, [trayIcon] {
+                    QMessageBox msgBox;
+                    msgBox.setIcon(QMessageBox::Information);
+                    msgBox.setText(QCoreApplication::translate("main", "You must configure how to connect to Syncthing when using Syncthing Tray the first time."));
+                    msgBox.setInformativeText(QCoreApplication::translate("main", "Note that the settings dialog allows importing URL, credentials and API-key from the local Syncthing configuration."));
+                    msgBox.exec();
+                    trayIcon->trayMenu().widget()->showSettingsDialog();
+                });
             }
         } else {
             QMessageBox::critical(nullptr, QApplication::applicationName(), QApplication::translate("main", "The system tray is (currently) not available. You could open the tray menu as a regular window using the -w flag, though."));
@@ -99,6 +117,21 @@ void trigger(bool tray, bool webUi)
     }
 }
 
+/*!
+ * \brief Triggers the specified actions after the deferred initialization of the tray widgets created so far.
+ * \remarks Zero-timers are processed in the order they have been started, so the settings have been applied (see
+ *          TrayWidget::TrayWidget()) when the actions are triggered. Otherwise the web view would not use the
+ *          configured URL.
+ */
+void triggerDeferred(bool tray, bool webUi)
+{
+    if(tray || webUi) {
+        QTimer::singleShot(0, [tray, webUi] {
+            trigger(tray, webUi);
+        });
+    }
+}
+
 int runApplication(int argc, const char *const *argv)
 {
     static bool firstRun = true;
@@ -118,11 +151,18 @@ int runApplication(int argc, const char *const *argv)
     triggerArg.setCombinable(true);
     Argument waitForTrayArg("wait", '\0', "wait until the system tray becomes available instead of showing an error message if the system tray is not available on start-up");
     waitForTrayArg.setCombinable(true);
+    Argument startupProfileArg("startup-profile", '\0', "prints the time spent in the different startup phases to stderr");
+    startupProfileArg.setCombinable(true);
+    Argument benchPaintArg("bench-paint", '\0', "paints the directory, device and download views repeatedly using generated data and prints the time per frame to stderr");
+    benchPaintArg.setValueNames({"rows", "frames"});
+    benchPaintArg.setRequiredValueCount(2);
     Argument &widgetsGuiArg = qtConfigArgs.qtWidgetsGuiArg();
     widgetsGuiArg.addSubArgument(&windowedArg);
     widgetsGuiArg.addSubArgument(&showWebUiArg);
     widgetsGuiArg.addSubArgument(&triggerArg);
     widgetsGuiArg.addSubArgument(&waitForTrayArg);
+    widgetsGuiArg.addSubArgument(&startupProfileArg);
+    widgetsGuiArg.addSubArgument(&benchPaintArg);
 
     parser.setMainArguments({&qtConfigArgs.qtWidgetsGuiArg(), &helpArg});
     try {
@@ -130,26 +170,49 @@ int runApplication(int argc, const char *const *argv)
         if(qtConfigArgs.qtWidgetsGuiArg().isPresent()) {
             if(firstRun) {
                 firstRun = false;
+                if(startupProfileArg.isPresent()) {
+                    StartupProfile::start();
+                }
 
                 SET_QT_APPLICATION_INFO;
                 QApplication application(argc, const_cast<char **>(argv));
                 QGuiApplication::setQuitOnLastWindowClosed(false);
+                StartupProfile::mark("application created");
+                if(benchPaintArg.isPresent()) {
+                    // paint the views without starting a tray or checking for another instance
+                    Settings::restore();
+                    Settings::values().qt.apply();
+                    QtUtilitiesResources::init();
+                    const int res = PaintBenchmark::run(QByteArray(benchPaintArg.values().at(0)).toInt(), QByteArray(benchPaintArg.values().at(1)).toInt());
+                    QtUtilitiesResources::cleanup();
+                    return res;
+                }
                 SingleInstance singleInstance(argc, argv);
-                networkAccessManager().setParent(&singleInstance);
+                setNetworkAccessManagerParent(&singleInstance);
                 QObject::connect(&singleInstance, &SingleInstance::newInstance, &runApplication);
+                StartupProfile::mark("single instance check");
 
                 Settings::restore();
                 Settings::values().qt.apply();
                 qtConfigArgs.applySettings(true);
+                StartupProfile::mark("settings restored");
 
                 LOAD_QT_TRANSLATIONS;
                 TranslationFiles::loadApplicationTranslationFile(QStringLiteral("syncthingconnection"));
                 TranslationFiles::loadApplicationTranslationFile(QStringLiteral("syncthingmodel"));
                 QtUtilitiesResources::init();
+                StartupProfile::mark("translations and resources loaded");
 
                 int res = initSyncthingTray(windowedArg.isPresent(), waitForTrayArg.isPresent());
                 if(!res) {
-                    trigger(triggerArg.isPresent(), showWebUiArg.isPresent());
+                    triggerDeferred(triggerArg.isPresent(), showWebUiArg.isPresent());
+                    QTimer::singleShot(0, [] {
+                        StartupProfile::finish("deferred initialization done");
+                    });
+                    // remove outdated icons from the disk cache once the tray is up
+                    QTimer::singleShot(10000, [] {
+                        StatusIconEngine::pruneDiskCache();
+                    });
                     res = application.exec();
                 }
 
@@ -163,7 +226,7 @@ int runApplication(int argc, const char *const *argv)
                 } else {
                     const int res = initSyncthingTray(windowedArg.isPresent(), waitForTrayArg.isPresent());
                     if(!res) {
-                        trigger(triggerArg.isPresent(), showWebUiArg.isPresent());
+                        triggerDeferred(triggerArg.isPresent(), showWebUiArg.isPresent());
                     }
                     return res;
                 }
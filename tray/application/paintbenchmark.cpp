@@ -0,0 +1,156 @@
+#include "./paintbenchmark.h"
+
+#include "../gui/dirview.h"
+#include "../gui/devview.h"
+#include "../gui/downloadview.h"
+
+#include "../../connector/syncthingconnection.h"
+#include "../../model/syncthingdirectorymodel.h"
+#include "../../model/syncthingdevicemodel.h"
+#include "../../model/syncthingdownloadmodel.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPixmap>
+#include <QScrollBar>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+using namespace Data;
+
+namespace QtGui {
+
+/*!
+ * \class PaintBenchmark
+ * \brief The PaintBenchmark class measures how long painting the directory, device and download views takes (see --bench-paint).
+ *
+ * The views are populated with generated directories, devices and downloading items with long labels so the item delegates
+ * need to elide the texts. For each view the following times per frame are printed to stderr:
+ * - cold: the first frame which needs to populate the text layout cache of the delegate
+ * - warm: subsequent frames at the same size which are served from the cache
+ * - scrolling: frames scrolled by one page each time so rows which have not been painted before come into view
+ * - resizing: frames with a different width each time so every text needs to be elided again
+ */
+
+/*!
+ * \brief Returns the elapsed time of the specified \a timer divided by \a frames in milliseconds.
+ */
+static double msPerFrame(const QElapsedTimer &timer, int frames)
+{
+    return static_cast<double>(timer.nsecsElapsed()) / 1000000.0 / frames;
+}
+
+/*!
+ * \brief Paints the specified \a view \a frames times and prints the times per frame prefixed with \a name.
+ */
+static void benchmarkView(QTreeView &view, const char *name, int frames)
+{
+    // show the view off-screen so it is laid out like a regular view
+    QWidget *const viewport = view.viewport();
+    view.setAttribute(Qt::WA_DontShowOnScreen);
+    view.resize(400, 1000);
+    view.show();
+    QCoreApplication::processEvents();
+    QPixmap target(viewport->size());
+    QElapsedTimer timer;
+
+    timer.start();
+    viewport->render(&target);
+    const double cold = msPerFrame(timer, 1);
+
+    timer.start();
+    for(int i = 0; i != frames; ++i) {
+        viewport->render(&target);
+    }
+    const double warm = msPerFrame(timer, frames);
+
+    QScrollBar *const scrollBar = view.verticalScrollBar();
+    timer.start();
+    for(int i = 0; i != frames; ++i) {
+        scrollBar->setValue((i * scrollBar->pageStep()) % (scrollBar->maximum() + 1));
+        viewport->render(&target);
+    }
+    const double scrolling = msPerFrame(timer, frames);
+    scrollBar->setValue(0);
+
+    timer.start();
+    for(int i = 0; i != frames; ++i) {
+        view.resize(300 + (i % 200), 1000);
+        // the view lays out its items in a posted event so process it to paint the new geometry
+        QCoreApplication::processEvents();
+        viewport->render(&target);
+    }
+    const double resizing = msPerFrame(timer, frames);
+
+    cerr << name << ": cold " << cold << " ms, warm " << warm << " ms, scrolling " << scrolling << " ms, resizing " << resizing << " ms per frame" << endl;
+}
+
+/*!
+ * \brief Populates the views with \a rows generated directories, devices and downloading items and paints each view \a frames times.
+ * \returns Returns the exit code for the application.
+ */
+int PaintBenchmark::run(int rows, int frames)
+{
+    if(rows <= 0 || frames <= 0) {
+        cerr << "The number of rows and frames must be positive." << endl;
+        return 1;
+    }
+
+    QJsonArray dirs, devs;
+    for(int i = 0; i != rows; ++i) {
+        const QString number(QString::number(i));
+        dirs.append(QJsonObject{
+            {QStringLiteral("id"), QStringLiteral("dir-") + number},
+            {QStringLiteral("label"), QStringLiteral("Directory with a rather long label which needs to be elided ") + number},
+            {QStringLiteral("path"), QStringLiteral("/home/user/some/deeply/nested/path/to/the/directory/") + number},
+            {QStringLiteral("status"), static_cast<int>(i % 3 ? SyncthingDirStatus::Idle : SyncthingDirStatus::Synchronizing)}
+        });
+        devs.append(QJsonObject{
+            {QStringLiteral("id"), QStringLiteral("DEVICE-") + number},
+            {QStringLiteral("name"), QStringLiteral("Device with a rather long name which needs to be elided ") + number},
+            {QStringLiteral("status"), static_cast<int>(i % 3 ? SyncthingDevStatus::Idle : SyncthingDevStatus::Disconnected)},
+            {QStringLiteral("paused"), i % 5 == 0}
+        });
+    }
+    SyncthingConnection connection;
+    if(!connection.restoreSnapshot(QJsonObject{{QStringLiteral("dirs"), dirs}, {QStringLiteral("devs"), devs}})) {
+        cerr << "Unable to populate the models." << endl;
+        return 1;
+    }
+
+    SyncthingDirectoryModel dirModel(connection);
+    SyncthingDeviceModel devModel(connection);
+    SyncthingDownloadModel dlModel(connection);
+    DirView dirView;
+    dirView.setModel(&dirModel);
+    DevView devView;
+    devView.setModel(&devModel);
+    DownloadView dlView;
+    dlView.setModel(&dlModel);
+
+    // the connection only assigns download progress when reading events so spread the items over the first directories directly
+    auto &dirInfo = const_cast<vector<SyncthingDir> &>(connection.dirInfo());
+    const int downloadingDirs = min(rows, 10);
+    for(int i = 0; i != rows; ++i) {
+        SyncthingDir &dir = dirInfo[static_cast<size_t>(i % downloadingDirs)];
+        dir.downloadingItems.emplace_back(dir.path, QStringLiteral("some/nested/path/to/a/file/with/a/rather/long/name/%1.bin").arg(i), QJsonObject{
+            {QStringLiteral("Pulled"), i % 100},
+            {QStringLiteral("Pulling"), 1},
+            {QStringLiteral("Total"), 100}
+        });
+    }
+    emit connection.downloadProgressChanged();
+    dlView.expandAll();
+
+    cerr << "Painting " << rows << " rows " << frames << " times ..." << endl;
+    benchmarkView(dirView, "directories", frames);
+    benchmarkView(devView, "devices", frames);
+    benchmarkView(dlView, "downloads", frames);
+    return 0;
+}
+
+}
@@ -0,0 +1,14 @@
+#ifndef PAINT_BENCHMARK_H
+#define PAINT_BENCHMARK_H
+
+namespace QtGui {
+
+class PaintBenchmark
+{
+public:
+    static int run(int rows, int frames);
+};
+
+}
+
+#endif // PAINT_BENCHMARK_H
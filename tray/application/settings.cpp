@@ -74,12 +74,14 @@ void restore()
         primaryConnectionSettings.label = QStringLiteral("Primary instance");
     }
     settings.endArray();
+    v.connection.standbyConnections = settings.value(QStringLiteral("standbyConnections"), v.connection.standbyConnections).toInt();
 
     auto &notifyOn = v.notifyOn;
     notifyOn.disconnect = settings.value(QStringLiteral("notifyOnDisconnect"), notifyOn.disconnect).toBool();
     notifyOn.internalErrors = settings.value(QStringLiteral("notifyOnErrors"), notifyOn.internalErrors).toBool();
     notifyOn.syncComplete = settings.value(QStringLiteral("notifyOnSyncComplete"), notifyOn.syncComplete).toBool();
     notifyOn.syncthingErrors = settings.value(QStringLiteral("showSyncthingNotifications"), notifyOn.syncthingErrors).toBool();
+    notifyOn.syncCompleteDelay = settings.value(QStringLiteral("syncCompleteDelay"), notifyOn.syncCompleteDelay).toInt();
 #ifdef QT_UTILITIES_SUPPORT_DBUS_NOTIFICATIONS
     v.dbusNotifications = settings.value(QStringLiteral("dbusNotifications"), DBusNotification::isAvailable()).toBool();
 #endif
@@ -89,6 +91,8 @@ void restore()
     appearance.frameStyle = settings.value(QStringLiteral("frameStyle"), appearance.frameStyle).toInt();
     appearance.tabPosition = settings.value(QStringLiteral("tabPos"), appearance.tabPosition).toInt();
     appearance.brightTextColors = settings.value(QStringLiteral("brightTextColors"), appearance.brightTextColors).toBool();
+    appearance.trayIconOverlay = settings.value(QStringLiteral("trayIconOverlay"), appearance.trayIconOverlay).toBool();
+    appearance.minStatusDuration = settings.value(QStringLiteral("minStatusDuration"), appearance.minStatusDuration).toInt();
     settings.endGroup();
 
     settings.beginGroup(QStringLiteral("startup"));
@@ -111,6 +115,7 @@ void restore()
     webView.zoomFactor = settings.value(QStringLiteral("zoomFactor"), webView.zoomFactor).toDouble();
     webView.geometry = settings.value(QStringLiteral("geometry")).toByteArray();
     webView.keepRunning = settings.value(QStringLiteral("keepRunning"), webView.keepRunning).toBool();
+    webView.unloadAfterIdle = settings.value(QStringLiteral("unloadAfterIdle"), webView.unloadAfterIdle).toInt();
     settings.endGroup();
 #endif
 
@@ -142,12 +147,14 @@ void save()
         settings.setValue(QStringLiteral("httpsCertPath"), connectionSettings->httpsCertPath);
     }
     settings.endArray();
+    settings.setValue(QStringLiteral("standbyConnections"), v.connection.standbyConnections);
 
     const auto &notifyOn = v.notifyOn;
     settings.setValue(QStringLiteral("notifyOnDisconnect"), notifyOn.disconnect);
     settings.setValue(QStringLiteral("notifyOnErrors"), notifyOn.internalErrors);
     settings.setValue(QStringLiteral("notifyOnSyncComplete"), notifyOn.syncComplete);
     settings.setValue(QStringLiteral("showSyncthingNotifications"), notifyOn.syncthingErrors);
+    settings.setValue(QStringLiteral("syncCompleteDelay"), notifyOn.syncCompleteDelay);
 #ifdef QT_UTILITIES_SUPPORT_DBUS_NOTIFICATIONS
     settings.setValue(QStringLiteral("dbusNotifications"), v.dbusNotifications);
 #endif
@@ -157,6 +164,8 @@ void save()
     settings.setValue(QStringLiteral("frameStyle"), appearance.frameStyle);
     settings.setValue(QStringLiteral("tabPos"), appearance.tabPosition);
     settings.setValue(QStringLiteral("brightTextColors"), appearance.brightTextColors);
+    settings.setValue(QStringLiteral("trayIconOverlay"), appearance.trayIconOverlay);
+    settings.setValue(QStringLiteral("minStatusDuration"), appearance.minStatusDuration);
     settings.endGroup();
 
     settings.beginGroup(QStringLiteral("startup"));
@@ -179,6 +188,7 @@ void save()
     settings.setValue(QStringLiteral("zoomFactor"), webView.zoomFactor);
     settings.setValue(QStringLiteral("geometry"), webView.geometry);
     settings.setValue(QStringLiteral("keepRunning"), webView.keepRunning);
+    settings.setValue(QStringLiteral("unloadAfterIdle"), webView.unloadAfterIdle);
     settings.endGroup();
 #endif
 
@@ -30,6 +30,7 @@ struct Connection
 {
     Data::SyncthingConnectionSettings primary;
     std::vector<Data::SyncthingConnectionSettings> secondary;
+    int standbyConnections = 2;
 };
 
 struct NotifyOn
@@ -38,6 +39,7 @@ struct NotifyOn
     bool internalErrors = true;
     bool syncComplete = true;
     bool syncthingErrors = true;
+    int syncCompleteDelay = 3000;
 };
 
 struct Appearance
@@ -47,6 +49,8 @@ struct Appearance
     int frameStyle = QFrame::StyledPanel | QFrame::Sunken;
     int tabPosition = QTabWidget::South;
     bool brightTextColors = false;
+    bool trayIconOverlay = true;
+    int minStatusDuration = 1000;
 };
 
 struct Launcher
@@ -78,6 +82,7 @@ struct WebView
     double zoomFactor = 1.0;
     QByteArray geometry;
     bool keepRunning = true;
+    int unloadAfterIdle = 0;
 };
 #endif
 
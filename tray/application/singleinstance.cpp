@@ -1,17 +1,26 @@
 #include "./singleinstance.h"
 
+#include "../gui/traywidget.h"
+
+#include "../../connector/syncthingconnection.h"
+#include "../../connector/syncthingipc.h"
+
 #include <c++utilities/misc/memory.h>
 #include <c++utilities/conversion/binaryconversion.h>
 
 #include <QLocalServer>
 #include <QLocalSocket>
-#include <QStringBuilder>
-#include <QCoreApplication>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QNetworkReply>
+#include <QUrl>
 
 #include <iostream>
+#include <memory>
 
 using namespace std;
 using namespace ConversionUtilities;
+using namespace Data;
 
 namespace QtGui {
 
@@ -19,14 +28,16 @@ SingleInstance::SingleInstance(int argc, const char *const *argv, QObject *paren
     QObject(parent),
     m_server(nullptr)
 {
-    const QString appId(QCoreApplication::applicationName() % QStringLiteral(" by ") % QCoreApplication::organizationName());
+    // note: the same server is used to respond to requests sent via Data::querySyncthingTray()
+    const QString appId(syncthingTrayServerName());
 
     // check for previous instance
     QLocalSocket socket;
     socket.connectToServer(appId, QLocalSocket::ReadWrite);
     if(socket.waitForConnected(1000)) {
         cerr << "Info: Application already running, sending args to previous instance" << endl;
-        if(argc >= 0 && argc <= 0xFFFF) {
+        // note: argc 0xFFFF is reserved to distinguish frames of the request/response protocol (see Data::syncthingIpcVersion)
+        if(argc >= 0 && argc < 0xFFFF) {
             char buffer[2];
             BE::getBytes(static_cast<uint16>(argc), buffer);
             socket.write(buffer, 2);
@@ -48,6 +59,7 @@ SingleInstance::SingleInstance(int argc, const char *const *argv, QObject *paren
     QLocalServer::removeServer(appId);
     // -> start server
     m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
     connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::handleNewConnection);
     if(!m_server->listen(appId)) {
         cerr << "Error: Unable to launch as single instance application" << endl;
@@ -57,9 +69,153 @@ SingleInstance::SingleInstance(int argc, const char *const *argv, QObject *paren
 void SingleInstance::handleNewConnection()
 {
     QLocalSocket *socket = m_server->nextPendingConnection();
+    connect(socket, &QLocalSocket::readyRead, this, &SingleInstance::readRequest);
     connect(socket, &QLocalSocket::readChannelFinished, this, &SingleInstance::readArgs);
 }
 
+/*!
+ * \brief Reads and handles a request sent via Data::querySyncthingTray().
+ * \remarks Does nothing if the data sent by the other side are arguments; those are read via readArgs() when the other
+ *          side closes the connection.
+ */
+void SingleInstance::readRequest()
+{
+    auto *socket = static_cast<QLocalSocket *>(sender());
+    unsigned char version, type;
+    QJsonObject request, response;
+    SyncthingIpcResult result = SyncthingIpcResult::UnsupportedRequest;
+    switch(readSyncthingIpcFrame(*socket, version, type, request)) {
+    case SyncthingIpcFrameStatus::NoFrame:
+        disconnect(socket, &QLocalSocket::readyRead, this, &SingleInstance::readRequest);
+        return;
+    case SyncthingIpcFrameStatus::Incomplete:
+        return;
+    case SyncthingIpcFrameStatus::Invalid:
+        cerr << "Error: Another application sent an invalid request." << endl;
+        break;
+    case SyncthingIpcFrameStatus::Complete:
+        result = version == syncthingIpcVersion ? handleRequest(socket, type, request, response) : SyncthingIpcResult::UnsupportedVersion;
+        break;
+    }
+
+    disconnect(socket, nullptr, this, nullptr);
+    connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    writeSyncthingIpcFrame(*socket, static_cast<unsigned char>(result), response);
+    // accepted requests are completed by the handler
+    if(result != SyncthingIpcResult::Accepted) {
+        socket->disconnectFromServer();
+    }
+}
+
+/*!
+ * \brief Handles the specified \a request using the connection of the first tray widget which is connected to the
+ *        Syncthing instance specified in the \a request.
+ */
+SyncthingIpcResult SingleInstance::handleRequest(QLocalSocket *socket, unsigned char type, const QJsonObject &request, QJsonObject &response)
+{
+    // find the connection to the requested Syncthing instance; the server is only accessible by the current user so
+    // no credentials are required
+    const QUrl url(request.value(QStringLiteral("url")).toString());
+    SyncthingConnection *connection = nullptr;
+    for(TrayWidget *trayWidget : TrayWidget::instances()) {
+        SyncthingConnection &trayConnection = trayWidget->connection();
+        if(isSameSyncthingInstance(url, QUrl(trayConnection.syncthingUrl()))) {
+            connection = &trayConnection;
+            if(connection->isConnected()) {
+                break;
+            }
+        }
+    }
+    if(!connection) {
+        return SyncthingIpcResult::NotAvailable;
+    }
+    if(!connection->isConnected()) {
+        return SyncthingIpcResult::NotConnected;
+    }
+
+    switch(static_cast<SyncthingIpcRequest>(type)) {
+    case SyncthingIpcRequest::StatusSnapshot:
+        response = connection->snapshot();
+        return SyncthingIpcResult::Ok;
+    case SyncthingIpcRequest::Command:
+        return handleCommands(socket, *connection, request);
+    default:
+        return SyncthingIpcResult::UnsupportedRequest;
+    }
+}
+
+/*!
+ * \brief Forwards the commands from the specified \a request to the specified \a connection.
+ *
+ * Returns SyncthingIpcResult::Accepted if at least one request to Syncthing has been made. In this case the final
+ * result is written to the \a socket once all requests have finished. The response contains the results of the
+ * individual requests so the other side can report failures (eg. unknown directory IDs).
+ */
+SyncthingIpcResult SingleInstance::handleCommands(QLocalSocket *socket, SyncthingConnection &connection, const QJsonObject &request)
+{
+    // validate the commands and collect the IDs first so nothing is done if one of the commands is unknown
+    QList<QPair<QString, QString> > commands;
+    for(const QJsonValue &commandValue : request.value(QStringLiteral("commands")).toArray()) {
+        const QJsonObject commandObject(commandValue.toObject());
+        const QString command(commandObject.value(QStringLiteral("command")).toString());
+        if(command == QLatin1String("rescan-all")) {
+            for(const SyncthingDir &dir : connection.dirInfo()) {
+                commands << qMakePair(QStringLiteral("rescan"), dir.id);
+            }
+        } else if(command == QLatin1String("pause-all") || command == QLatin1String("resume-all")) {
+            for(const SyncthingDev &dev : connection.devInfo()) {
+                commands << qMakePair(command.left(command.size() - 4), dev.id);
+            }
+        } else if(command == QLatin1String("rescan") || command == QLatin1String("pause") || command == QLatin1String("resume")) {
+            for(const QJsonValue &id : commandObject.value(QStringLiteral("ids")).toArray()) {
+                commands << qMakePair(command, id.toString());
+            }
+        } else {
+            return SyncthingIpcResult::UnsupportedRequest;
+        }
+    }
+    if(commands.isEmpty()) {
+        return SyncthingIpcResult::Ok;
+    }
+
+    // send the requests and write the final result when the last one has finished
+    struct PendingCommands
+    {
+        QJsonArray results;
+        int remaining;
+        bool failed;
+    };
+    const auto pending = make_shared<PendingCommands>(PendingCommands{ QJsonArray(), commands.size(), false });
+    for(const auto &command : commands) {
+        QNetworkReply *reply;
+        if(command.first == QLatin1String("rescan")) {
+            reply = connection.rescan(command.second);
+        } else if(command.first == QLatin1String("pause")) {
+            reply = connection.pause(command.second);
+        } else {
+            reply = connection.resume(command.second);
+        }
+        connect(reply, &QNetworkReply::finished, socket, [socket, reply, command, pending] {
+            QJsonObject result;
+            result.insert(QStringLiteral("command"), command.first);
+            result.insert(QStringLiteral("id"), command.second);
+            if(reply->error() != QNetworkReply::NoError) {
+                result.insert(QStringLiteral("error"), reply->errorString());
+                pending->failed = true;
+            }
+            pending->results.append(result);
+            if(--pending->remaining) {
+                return;
+            }
+            QJsonObject response;
+            response.insert(QStringLiteral("results"), pending->results);
+            writeSyncthingIpcFrame(*socket, static_cast<unsigned char>(pending->failed ? SyncthingIpcResult::CommandFailed : SyncthingIpcResult::Ok), response);
+            socket->disconnectFromServer();
+        });
+    }
+    return SyncthingIpcResult::Accepted;
+}
+
 void SingleInstance::readArgs()
 {
     auto *socket = static_cast<QLocalSocket *>(sender());
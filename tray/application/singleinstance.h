@@ -4,9 +4,13 @@
 #include <QObject>
 
 QT_FORWARD_DECLARE_CLASS(QLocalServer)
+QT_FORWARD_DECLARE_CLASS(QLocalSocket)
+QT_FORWARD_DECLARE_CLASS(QJsonObject)
 
 namespace Data {
 struct SyncthingDir;
+class SyncthingConnection;
+enum class SyncthingIpcResult : unsigned char;
 }
 
 namespace QtGui {
@@ -22,9 +26,13 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void handleNewConnection();
+    void readRequest();
     void readArgs();
 
 private:
+    static Data::SyncthingIpcResult handleRequest(QLocalSocket *socket, unsigned char type, const QJsonObject &request, QJsonObject &response);
+    static Data::SyncthingIpcResult handleCommands(QLocalSocket *socket, Data::SyncthingConnection &connection, const QJsonObject &request);
+
     QLocalServer *m_server;
 
 };
@@ -0,0 +1,55 @@
+#include "./startupprofile.h"
+
+#include <QElapsedTimer>
+
+#include <iostream>
+
+using namespace std;
+
+namespace QtGui {
+
+/*!
+ * \class StartupProfile
+ * \brief The StartupProfile class prints the time spent in the different startup phases (see --startup-profile).
+ *
+ * Does nothing unless start() has been called. Stops printing timings after finish() has been called so phases
+ * which are executed again later on (eg. when another instance is opened) are not printed.
+ */
+
+static QElapsedTimer timer;
+static qint64 lastMark = 0;
+static bool enabled = false;
+
+/*!
+ * \brief Starts measuring; all times printed by mark() are relative to this call.
+ */
+void StartupProfile::start()
+{
+    enabled = true;
+    lastMark = 0;
+    timer.start();
+}
+
+/*!
+ * \brief Prints the time spent since the last mark and since start() for the specified \a phase.
+ */
+void StartupProfile::mark(const char *phase)
+{
+    if(!enabled) {
+        return;
+    }
+    const qint64 now = timer.elapsed();
+    cerr << "Startup: " << phase << ": " << (now - lastMark) << " ms (total " << now << " ms)" << endl;
+    lastMark = now;
+}
+
+/*!
+ * \brief Prints the time for the specified \a phase and stops printing timings.
+ */
+void StartupProfile::finish(const char *phase)
+{
+    mark(phase);
+    enabled = false;
+}
+
+}
@@ -0,0 +1,16 @@
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+namespace QtGui {
+
+class StartupProfile
+{
+public:
+    static void start();
+    static void mark(const char *phase);
+    static void finish(const char *phase);
+};
+
+}
+
+#endif // STARTUP_PROFILE_H
@@ -11,6 +11,7 @@
 #include <QStyleOptionViewItem>
 #include <QBrush>
 #include <QPalette>
+#include <QStaticText>
 
 using namespace Data;
 
@@ -45,9 +46,10 @@ void DevButtonsItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem
         textRect.setWidth(textRect.width() - 20);
         QTextOption textOption;
         textOption.setAlignment(opt.displayAlignment);
+        const QStaticText &text = m_textLayoutCache.staticText(opt.fontMetrics, opt.font, displayText(index.data(Qt::DisplayRole), option.locale), textOption, static_cast<int>(textRect.width()));
         painter->setFont(opt.font);
         painter->setPen(opt.palette.color(opt.state & QStyle::State_Selected ? QPalette::HighlightedText : QPalette::Text));
-        painter->drawText(textRect, displayText(index.data(Qt::DisplayRole), option.locale), textOption);
+        painter->drawStaticText(TextLayoutCache::alignedTextPos(textRect, text, opt.displayAlignment), text);
 
         // draw buttons
         const int buttonY = option.rect.y() + centerObj(option.rect.height(), 16);
@@ -1,6 +1,8 @@
 #ifndef DEVBUTTONSITEMDELEGATE_H
 #define DEVBUTTONSITEMDELEGATE_H
 
+#include "./textlayoutcache.h"
+
 #include <QStyledItemDelegate>
 #include <QPixmap>
 
@@ -17,6 +19,7 @@ public:
 private:
     const QPixmap m_pauseIcon;
     const QPixmap m_resumeIcon;
+    mutable TextLayoutCache m_textLayoutCache;
 };
 
 }
@@ -40,9 +40,9 @@ void DownloadItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
         opt.displayAlignment = Qt::AlignTop | Qt::AlignLeft;
         opt.decorationSize = QSize(option.rect.height(), option.rect.height());
         opt.features |= QStyleOptionViewItem::HasDecoration;
-        opt.text = option.fontMetrics.elidedText(opt.text, Qt::ElideMiddle, opt.rect.width() - opt.rect.height() - 26);
+        opt.text = m_textLayoutCache.elidedText(option.fontMetrics, option.font, opt.text, Qt::ElideMiddle, opt.rect.width() - opt.rect.height() - 26);
     } else {
-        opt.text = option.fontMetrics.elidedText(opt.text, Qt::ElideMiddle, opt.rect.width() / 2 - 4);
+        opt.text = m_textLayoutCache.elidedText(option.fontMetrics, option.font, opt.text, Qt::ElideMiddle, opt.rect.width() / 2 - 4);
     }
     QApplication::style()->drawControl(QStyle::CE_ItemViewItem, &opt, painter);
 
@@ -56,7 +56,7 @@ void DownloadItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
         progressBarOption.rect.setX(opt.rect.x() + opt.rect.height() + 4);
         progressBarOption.rect.setY(opt.rect.y() + opt.rect.height() / 2);
     } else {
-        progressBarOption.rect.setX(opt.rect.x() + opt.fontMetrics.width(opt.text) + 6);
+        progressBarOption.rect.setX(opt.rect.x() + m_textLayoutCache.width(opt.fontMetrics, opt.font, opt.text) + 6);
         progressBarOption.rect.setWidth(progressBarOption.rect.width() - 18);
     }
     progressBarOption.textAlignment = Qt::AlignCenter;
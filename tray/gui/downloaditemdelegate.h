@@ -1,6 +1,8 @@
 #ifndef DOWNLOADITEMDELEGATE_H
 #define DOWNLOADITEMDELEGATE_H
 
+#include "./textlayoutcache.h"
+
 #include <QStyledItemDelegate>
 #include <QPixmap>
 
@@ -17,6 +19,7 @@ public:
 
 private:
     const QPixmap m_folderIcon;
+    mutable TextLayoutCache m_textLayoutCache;
 };
 
 }
@@ -0,0 +1,94 @@
+#include "./notificationaggregator.h"
+
+#include "../../connector/syncthingconnection.h"
+
+using namespace ChronoUtilities;
+using namespace Data;
+
+namespace QtGui {
+
+/*!
+ * \class NotificationAggregator
+ * \brief The NotificationAggregator class rate-limits and aggregates Syncthing notifications before they are shown.
+ *
+ * Notifications are grouped by their source (the ID of the directory they relate to or an empty string for general
+ * errors). Within one window only maxPerWindow() notifications per source are passed through immediately. Further
+ * notifications are counted and emitted as one summary ("523 new errors in directory X") when the window ends.
+ */
+
+/*!
+ * \brief Constructs a new aggregator which looks up directory names from the specified \a connection.
+ */
+NotificationAggregator::NotificationAggregator(const SyncthingConnection &connection, QObject *parent) :
+    QObject(parent),
+    m_connection(connection),
+    m_maxPerWindow(3)
+{
+    m_clock.start();
+    m_flushTimer.setInterval(10000);
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &NotificationAggregator::flush);
+}
+
+/*!
+ * \brief Adds a new notification with the specified \a message from the specified \a source.
+ * \remarks Emits notificationReady() immediately unless the rate limit for \a source has been exceeded.
+ */
+void NotificationAggregator::addNotification(DateTime when, const QString &message, const QString &source)
+{
+    const qint64 now = m_clock.elapsed();
+    Source &src = m_sources[source];
+    if(now - src.windowStart >= m_flushTimer.interval()) {
+        src.windowStart = now;
+        src.emitted = 0;
+    }
+    if(src.emitted < m_maxPerWindow && !src.suppressed) {
+        ++src.emitted;
+        emit notificationReady(when, message);
+        return;
+    }
+    ++src.suppressed;
+    src.lastWhen = when;
+    src.lastMessage = message;
+    if(!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+/*!
+ * \brief Emits the summaries for all suppressed notifications and discards sources which are no longer active.
+ */
+void NotificationAggregator::flush()
+{
+    const qint64 now = m_clock.elapsed();
+    for(auto i = m_sources.begin(); i != m_sources.end(); ) {
+        Source &src = i.value();
+        if(src.suppressed == 1) {
+            emit notificationReady(src.lastWhen, src.lastMessage);
+        } else if(src.suppressed > 1) {
+            QString dirName;
+            if(!i.key().isEmpty()) {
+                for(const SyncthingDir &dir : m_connection.dirInfo()) {
+                    if(dir.id == i.key()) {
+                        dirName = dir.displayName();
+                        break;
+                    }
+                }
+            }
+            emit notificationReady(src.lastWhen, dirName.isEmpty()
+                                   ? tr("%1 new notifications").arg(src.suppressed)
+                                   : tr("%1 new errors in directory %2").arg(src.suppressed).arg(dirName));
+        } else if(now - src.windowStart >= m_flushTimer.interval()) {
+            i = m_sources.erase(i);
+            continue;
+        }
+        if(src.suppressed) {
+            src.suppressed = 0;
+            src.windowStart = now;
+            src.emitted = 1;
+        }
+        ++i;
+    }
+}
+
+}
@@ -0,0 +1,87 @@
+#ifndef NOTIFICATION_AGGREGATOR_H
+#define NOTIFICATION_AGGREGATOR_H
+
+#include <c++utilities/chrono/datetime.h>
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+
+namespace Data {
+class SyncthingConnection;
+}
+
+namespace QtGui {
+
+class NotificationAggregator : public QObject
+{
+    Q_OBJECT
+
+public:
+    NotificationAggregator(const Data::SyncthingConnection &connection, QObject *parent = nullptr);
+
+    int window() const;
+    void setWindow(int window);
+    int maxPerWindow() const;
+    void setMaxPerWindow(int maxPerWindow);
+
+public slots:
+    void addNotification(ChronoUtilities::DateTime when, const QString &message, const QString &source);
+    void flush();
+
+signals:
+    void notificationReady(ChronoUtilities::DateTime when, const QString &message);
+
+private:
+    struct Source
+    {
+        qint64 windowStart = 0;
+        int emitted = 0;
+        int suppressed = 0;
+        ChronoUtilities::DateTime lastWhen;
+        QString lastMessage;
+    };
+
+    const Data::SyncthingConnection &m_connection;
+    QHash<QString, Source> m_sources;
+    QElapsedTimer m_clock;
+    QTimer m_flushTimer;
+    int m_maxPerWindow;
+};
+
+/*!
+ * \brief Returns the length of the aggregation window in milliseconds.
+ */
+inline int NotificationAggregator::window() const
+{
+    return m_flushTimer.interval();
+}
+
+/*!
+ * \brief Sets the length of the aggregation window in milliseconds.
+ */
+inline void NotificationAggregator::setWindow(int window)
+{
+    m_flushTimer.setInterval(window);
+}
+
+/*!
+ * \brief Returns how many notifications per source are passed through immediately within one window.
+ */
+inline int NotificationAggregator::maxPerWindow() const
+{
+    return m_maxPerWindow;
+}
+
+/*!
+ * \brief Sets how many notifications per source are passed through immediately within one window.
+ */
+inline void NotificationAggregator::setMaxPerWindow(int maxPerWindow)
+{
+    m_maxPerWindow = maxPerWindow;
+}
+
+}
+
+#endif // NOTIFICATION_AGGREGATOR_H
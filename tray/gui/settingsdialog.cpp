@@ -32,7 +32,6 @@
 
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QHostAddress>
 #if defined(PLATFORM_LINUX) && !defined(Q_OS_ANDROID)
 # include <QStandardPaths>
 #elif defined(PLATFORM_WINDOWS)
@@ -100,7 +99,7 @@ void ConnectionOptionPage::insertFromConfigFile()
         }
         if(!config.guiAddress.isEmpty()) {
             ui()->urlLineEdit->selectAll();
-            ui()->urlLineEdit->insert(((config.guiEnforcesSecureConnection || !QHostAddress(config.guiAddress.mid(0, config.guiAddress.indexOf(QChar(':')))).isLoopback()) ? QStringLiteral("https://") : QStringLiteral("http://")) + config.guiAddress);
+            ui()->urlLineEdit->insert(config.syncthingUrl());
         }
         if(!config.guiUser.isEmpty() || !config.guiPasswordHash.isEmpty()) {
             ui()->authCheckBox->setChecked(true);
@@ -210,6 +209,7 @@ bool ConnectionOptionPage::apply()
         ok = cacheCurrentSettings(true);
         values().connection.primary = m_primarySettings;
         values().connection.secondary = m_secondarySettings;
+        values().connection.standbyConnections = ui()->standbyConnectionsSpinBox->value();
     }
     return ok;
 }
@@ -230,6 +230,7 @@ void ConnectionOptionPage::reset()
         ui()->selectionComboBox->clear();
         ui()->selectionComboBox->addItems(itemTexts);
         ui()->selectionComboBox->setCurrentIndex(0);
+        ui()->standbyConnectionsSpinBox->setValue(values().connection.standbyConnections);
 
         updateConnectionStatus();
     }
@@ -258,6 +259,7 @@ bool NotificationsOptionPage::apply()
         notifyOn.internalErrors = ui()->notifyOnErrorsCheckBox->isChecked();
         notifyOn.syncComplete = ui()->notifyOnSyncCompleteCheckBox->isChecked();
         notifyOn.syncthingErrors = ui()->showSyncthingNotificationsCheckBox->isChecked();
+        notifyOn.syncCompleteDelay = ui()->syncCompleteDelaySpinBox->value();
 #ifdef QT_UTILITIES_SUPPORT_DBUS_NOTIFICATIONS
         if((values().dbusNotifications = ui()->dbusRadioButton->isChecked()) && !DBusNotification::isAvailable()) {
             errors() << QCoreApplication::translate("QtGui::NotificationsOptionPage", "Configured to use D-Bus notifications but D-Bus notification daemon seems unavailabe.");
@@ -276,6 +278,7 @@ void NotificationsOptionPage::reset()
         ui()->notifyOnErrorsCheckBox->setChecked(notifyOn.internalErrors);
         ui()->notifyOnSyncCompleteCheckBox->setChecked(notifyOn.syncComplete);
         ui()->showSyncthingNotificationsCheckBox->setChecked(notifyOn.syncthingErrors);
+        ui()->syncCompleteDelaySpinBox->setValue(notifyOn.syncCompleteDelay);
 #ifdef QT_UTILITIES_SUPPORT_DBUS_NOTIFICATIONS
         (values().dbusNotifications ? ui()->dbusRadioButton : ui()->qtRadioButton)->setChecked(true);
 #else
@@ -315,6 +318,8 @@ bool AppearanceOptionPage::apply()
         settings.frameStyle = style;
         settings.tabPosition = ui()->tabPosComboBox->currentIndex();
         settings.brightTextColors = ui()->brightTextColorsCheckBox->isChecked();
+        settings.trayIconOverlay = ui()->trayIconOverlayCheckBox->isChecked();
+        settings.minStatusDuration = ui()->minStatusDurationSpinBox->value();
     }
     return true;
 }
@@ -342,6 +347,8 @@ void AppearanceOptionPage::reset()
         ui()->frameShadowComboBox->setCurrentIndex(index);
         ui()->tabPosComboBox->setCurrentIndex(settings.tabPosition);
         ui()->brightTextColorsCheckBox->setChecked(settings.brightTextColors);
+        ui()->trayIconOverlayCheckBox->setChecked(settings.trayIconOverlay);
+        ui()->minStatusDurationSpinBox->setValue(settings.minStatusDuration);
     }
 }
 
@@ -690,6 +697,7 @@ bool WebViewOptionPage::apply()
         webView.disabled = ui()->disableCheckBox->isChecked();
         webView.zoomFactor = ui()->zoomDoubleSpinBox->value();
         webView.keepRunning = ui()->keepRunningCheckBox->isChecked();
+        webView.unloadAfterIdle = ui()->unloadAfterIdleSpinBox->value() * 60;
     }
 #endif
     return true;
@@ -703,6 +711,8 @@ void WebViewOptionPage::reset()
         ui()->disableCheckBox->setChecked(webView.disabled);
         ui()->zoomDoubleSpinBox->setValue(webView.zoomFactor);
         ui()->keepRunningCheckBox->setChecked(webView.keepRunning);
+        ui()->unloadAfterIdleSpinBox->setValue(webView.unloadAfterIdle / 60);
+        ui()->unloadAfterIdleSpinBox->setEnabled(webView.keepRunning);
     }
 #endif
 }
@@ -0,0 +1,109 @@
+#include "./statusdebouncer.h"
+
+#include "../application/settings.h"
+
+#include "../../connector/syncthingconnection.h"
+
+using namespace Data;
+
+namespace QtGui {
+
+/*!
+ * \class StatusDebouncer
+ * \brief The StatusDebouncer class filters the status changes of a SyncthingConnection to avoid flapping.
+ *
+ * - A new status is only propagated if the previous status has been shown for at least the minimum dwell time
+ *   configured in the appearance settings. Otherwise it is delayed and possibly superseded by further changes.
+ *   Disconnects are always propagated immediately.
+ * - syncComplete() is only emitted when no directory started synchronizing again within the quiet period configured
+ *   in the notification settings. The names of directories completed in between are accumulated.
+ */
+
+/*!
+ * \brief Constructs a new debouncer for the specified \a connection.
+ * \remarks The connection's statusChanged() signal needs to be connected to handleStatusChanged().
+ */
+StatusDebouncer::StatusDebouncer(const SyncthingConnection &connection, QObject *parent) :
+    QObject(parent),
+    m_connection(connection),
+    m_rawStatus(SyncthingStatus::Disconnected),
+    m_pendingStatus(SyncthingStatus::Disconnected),
+    m_status(SyncthingStatus::Disconnected)
+{
+    m_dwellTimer.setSingleShot(true);
+    m_syncCompleteTimer.setSingleShot(true);
+    connect(&m_dwellTimer, &QTimer::timeout, this, &StatusDebouncer::applyPendingStatus);
+    connect(&m_syncCompleteTimer, &QTimer::timeout, this, &StatusDebouncer::emitSyncComplete);
+}
+
+/*!
+ * \brief Handles a status change of the underlying connection.
+ */
+void StatusDebouncer::handleStatusChanged(SyncthingStatus status)
+{
+    const auto &settings = Settings::values();
+
+    // keep track of completed directories
+    switch(status) {
+    case SyncthingStatus::Disconnected:
+    case SyncthingStatus::Reconnecting:
+        m_syncCompleteTimer.stop();
+        m_completedDirs.clear();
+        break;
+    case SyncthingStatus::Synchronizing:
+        m_syncCompleteTimer.stop();
+        break;
+    default:
+        if(m_rawStatus == SyncthingStatus::Synchronizing && settings.notifyOn.syncComplete) {
+            for(const SyncthingDir *dir : m_connection.completedDirs()) {
+                const QString name(dir->displayName());
+                if(!m_completedDirs.contains(name)) {
+                    m_completedDirs << name;
+                }
+            }
+        }
+        if(!m_completedDirs.isEmpty()) {
+            m_syncCompleteTimer.start(settings.notifyOn.syncCompleteDelay);
+        }
+    }
+    m_rawStatus = status;
+
+    // propagate status considering the minimum dwell time
+    m_pendingStatus = status;
+    if(status == m_status) {
+        m_dwellTimer.stop();
+        return;
+    }
+    const int minDwellTime = settings.appearance.minStatusDuration;
+    const qint64 elapsed = m_lastChange.isValid() ? m_lastChange.elapsed() : minDwellTime;
+    if(status == SyncthingStatus::Disconnected || elapsed >= minDwellTime) {
+        applyPendingStatus();
+    } else if(!m_dwellTimer.isActive()) {
+        m_dwellTimer.start(static_cast<int>(minDwellTime - elapsed));
+    }
+}
+
+/*!
+ * \brief Propagates the pending status if it differs from the current status.
+ */
+void StatusDebouncer::applyPendingStatus()
+{
+    m_dwellTimer.stop();
+    if(m_pendingStatus != m_status) {
+        m_lastChange.start();
+        emit statusChanged(m_status = m_pendingStatus);
+    }
+}
+
+/*!
+ * \brief Emits syncComplete() for the directories completed since the last notification.
+ */
+void StatusDebouncer::emitSyncComplete()
+{
+    if(!m_completedDirs.isEmpty()) {
+        emit syncComplete(m_completedDirs);
+        m_completedDirs.clear();
+    }
+}
+
+}
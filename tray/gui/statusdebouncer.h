@@ -0,0 +1,57 @@
+#ifndef STATUS_DEBOUNCER_H
+#define STATUS_DEBOUNCER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QStringList>
+
+namespace Data {
+class SyncthingConnection;
+enum class SyncthingStatus;
+}
+
+namespace QtGui {
+
+class StatusDebouncer : public QObject
+{
+    Q_OBJECT
+
+public:
+    StatusDebouncer(const Data::SyncthingConnection &connection, QObject *parent = nullptr);
+
+    Data::SyncthingStatus status() const;
+
+public slots:
+    void handleStatusChanged(Data::SyncthingStatus status);
+
+signals:
+    void statusChanged(Data::SyncthingStatus status);
+    void syncComplete(const QStringList &dirNames);
+
+private slots:
+    void applyPendingStatus();
+    void emitSyncComplete();
+
+private:
+    const Data::SyncthingConnection &m_connection;
+    Data::SyncthingStatus m_rawStatus;
+    Data::SyncthingStatus m_pendingStatus;
+    Data::SyncthingStatus m_status;
+    QElapsedTimer m_lastChange;
+    QTimer m_dwellTimer;
+    QTimer m_syncCompleteTimer;
+    QStringList m_completedDirs;
+};
+
+/*!
+ * \brief Returns the debounced status.
+ */
+inline Data::SyncthingStatus StatusDebouncer::status() const
+{
+    return m_status;
+}
+
+}
+
+#endif // STATUS_DEBOUNCER_H
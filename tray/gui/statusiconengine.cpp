@@ -0,0 +1,183 @@
+#include "./statusiconengine.h"
+
+#include <QSvgRenderer>
+#include <QPainter>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <QPaintDevice>
+#include <QGuiApplication>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QStringBuilder>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QDirIterator>
+#include <QDateTime>
+
+namespace QtGui {
+
+/*!
+ * \class StatusIconEngine
+ * \brief The StatusIconEngine class renders a status icon lazily from its SVG file.
+ *
+ * The SVG file is only parsed when a size is actually requested (by the platform's tray implementation or when
+ * painting). Rendered pixmaps are cached in memory (QPixmapCache) and on disk (see diskCacheDirectory()) so the SVG
+ * does not need to be parsed at all on subsequent startups.
+ *
+ * The cache key is composed of the SHA-1 hash of the SVG data, the requested size (in device pixels) and the current
+ * icon theme. Hence updating the SVG files invalidates the disk cache implicitly. Outdated files are removed by
+ * pruneDiskCache().
+ */
+
+/*!
+ * \brief Constructs a new engine for the SVG file with the specified \a svgPath.
+ * \remarks The \a defaultSize is the only size returned by availableSizes() and used by tray implementations
+ *          which don't request a particular size (eg. Plasma 5).
+ */
+StatusIconEngine::StatusIconEngine(const QString &svgPath, const QSize &defaultSize) :
+    m_svgPath(svgPath),
+    m_defaultSize(defaultSize)
+{}
+
+/*!
+ * \brief Paints the icon into the specified \a rect considering the device pixel ratio of the \a painter's device.
+ */
+void StatusIconEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state)
+{
+    const qreal ratio = painter->device() ? painter->device()->devicePixelRatioF() : qApp->devicePixelRatio();
+    painter->drawPixmap(rect, pixmap(rect.size() * ratio, mode, state));
+}
+
+/*!
+ * \brief Returns the icon rendered for the specified \a size which is supposed to be in device pixels already.
+ * \remarks Looks up the memory cache and the disk cache before actually rendering the SVG.
+ */
+QPixmap StatusIconEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(mode)
+    Q_UNUSED(state)
+
+    const QString key(cacheKey(size));
+    QPixmap pixmap;
+    if(QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+
+    const QString cacheDir(diskCacheDirectory());
+    const QString cachePath(cacheDir % key % QStringLiteral(".png"));
+    if(cacheDir.isEmpty() || !pixmap.load(cachePath, "PNG") || pixmap.size() != size) {
+        pixmap = render(size);
+        if(!cacheDir.isEmpty() && QDir().mkpath(cacheDir)) {
+            QSaveFile file(cachePath);
+            if(file.open(QIODevice::WriteOnly) && pixmap.save(&file, "PNG")) {
+                file.commit();
+            }
+        }
+    }
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+QSize StatusIconEngine::actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(mode)
+    Q_UNUSED(state)
+    return size;
+}
+
+QList<QSize> StatusIconEngine::availableSizes(QIcon::Mode mode, QIcon::State state) const
+{
+    Q_UNUSED(mode)
+    Q_UNUSED(state)
+    return QList<QSize>() << m_defaultSize;
+}
+
+QString StatusIconEngine::key() const
+{
+    return QStringLiteral("StatusIconEngine");
+}
+
+QIconEngine *StatusIconEngine::clone() const
+{
+    return new StatusIconEngine(*this);
+}
+
+/*!
+ * \brief Returns the directory used to store rendered icons persistently or an empty string if there is none.
+ */
+QString StatusIconEngine::diskCacheDirectory()
+{
+    static const QString dir = [] {
+        const QString cacheLocation(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+        return cacheLocation.isEmpty() ? QString() : QString(cacheLocation + QStringLiteral("/status-icons/"));
+    }();
+    return dir;
+}
+
+/*!
+ * \brief Removes icons from the disk cache which have been rendered more than \a maxAgeDays ago.
+ * \remarks
+ * - Icons rendered for outdated SVG files, sizes or themes are never used again and would pile up otherwise.
+ * - Icons which are still in use are just rendered again when requested the next time.
+ */
+void StatusIconEngine::pruneDiskCache(int maxAgeDays)
+{
+    const QString cacheDir(diskCacheDirectory());
+    if(cacheDir.isEmpty()) {
+        return;
+    }
+    const QDateTime oldest(QDateTime::currentDateTimeUtc().addDays(-maxAgeDays));
+    for(QDirIterator i(cacheDir, QStringList() << QStringLiteral("*.png"), QDir::Files); i.hasNext();) {
+        i.next();
+        if(i.fileInfo().lastModified().toUTC() < oldest) {
+            QFile::remove(i.filePath());
+        }
+    }
+}
+
+/*!
+ * \brief Returns the hex-encoded SHA-1 hash of the SVG data.
+ * \remarks The file is only read (but not parsed) on the first call.
+ */
+const QByteArray &StatusIconEngine::svgHash()
+{
+    if(m_svgHash.isEmpty()) {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        QFile file(m_svgPath);
+        if(file.open(QIODevice::ReadOnly)) {
+            hash.addData(&file);
+        } else {
+            hash.addData(m_svgPath.toUtf8());
+        }
+        m_svgHash = hash.result().toHex();
+    }
+    return m_svgHash;
+}
+
+/*!
+ * \brief Returns the key used for the memory and disk cache for the specified \a size.
+ */
+QString StatusIconEngine::cacheKey(const QSize &size)
+{
+    return QString::fromLatin1(svgHash())
+            % QChar('-') % QString::number(size.width()) % QChar('x') % QString::number(size.height())
+            % QChar('-') % QString::number(qHash(QIcon::themeName()), 16);
+}
+
+/*!
+ * \brief Renders the SVG image to a QPixmap with the specified \a size.
+ * \remarks If instantiating QIcon directly from SVG image the icon is not displayed under Plasma 5. It would work
+ *          with Tint2, tough.
+ */
+QPixmap StatusIconEngine::render(const QSize &size)
+{
+    QSvgRenderer renderer(m_svgPath);
+    QPixmap pm(size);
+    pm.fill(QColor(Qt::transparent));
+    QPainter painter(&pm);
+    renderer.render(&painter, pm.rect());
+    return pm;
+}
+
+}
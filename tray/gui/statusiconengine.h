@@ -0,0 +1,38 @@
+#ifndef STATUS_ICON_ENGINE_H
+#define STATUS_ICON_ENGINE_H
+
+#include <QIconEngine>
+#include <QByteArray>
+#include <QString>
+#include <QSize>
+
+namespace QtGui {
+
+class StatusIconEngine : public QIconEngine
+{
+public:
+    StatusIconEngine(const QString &svgPath, const QSize &defaultSize = QSize(128, 128));
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state);
+    QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state);
+    QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state);
+    QList<QSize> availableSizes(QIcon::Mode mode = QIcon::Normal, QIcon::State state = QIcon::Off) const;
+    QString key() const;
+    QIconEngine *clone() const;
+
+    static QString diskCacheDirectory();
+    static void pruneDiskCache(int maxAgeDays = 30);
+
+private:
+    const QByteArray &svgHash();
+    QString cacheKey(const QSize &size);
+    QPixmap render(const QSize &size);
+
+    const QString m_svgPath;
+    const QSize m_defaultSize;
+    QByteArray m_svgHash;
+};
+
+}
+
+#endif // STATUS_ICON_ENGINE_H
@@ -0,0 +1,123 @@
+#include "./statusiconoverlayengine.h"
+
+#include <QPainter>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <QPaintDevice>
+#include <QGuiApplication>
+#include <QStringBuilder>
+
+namespace QtGui {
+
+/*!
+ * \class StatusIconOverlayEngine
+ * \brief The StatusIconOverlayEngine class draws a progress ring and an error badge over a status icon.
+ *
+ * Like the StatusIconEngine used for the base icon, the overlay is only drawn when a size is actually requested and
+ * it is drawn at that size (in device pixels) so it is sharp on HiDPI screens as well. Composed pixmaps are cached in
+ * memory (QPixmapCache) but not on disk because the number of combinations is too high.
+ */
+
+/*!
+ * \brief Constructs a new engine drawing the overlay over the specified \a baseIcon.
+ * \param progressBucket Specifies the progress in 5 % steps; a negative value means no progress ring is drawn.
+ * \param errorCount Specifies the number of errors to show in the badge; values greater than 9 are shown as "9+".
+ */
+StatusIconOverlayEngine::StatusIconOverlayEngine(const QIcon &baseIcon, int progressBucket, int errorCount) :
+    m_baseIcon(baseIcon),
+    m_progressBucket(progressBucket),
+    m_errorCount(errorCount)
+{}
+
+/*!
+ * \brief Paints the icon into the specified \a rect considering the device pixel ratio of the \a painter's device.
+ */
+void StatusIconOverlayEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state)
+{
+    const qreal ratio = painter->device() ? painter->device()->devicePixelRatioF() : qApp->devicePixelRatio();
+    painter->drawPixmap(rect, pixmap(rect.size() * ratio, mode, state));
+}
+
+/*!
+ * \brief Returns the composed icon for the specified \a size which is supposed to be in device pixels already.
+ */
+QPixmap StatusIconOverlayEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(mode)
+    Q_UNUSED(state)
+
+    const QString key(QStringLiteral("overlay-") % QString::number(m_baseIcon.cacheKey(), 16)
+                      % QChar('-') % QString::number(size.width()) % QChar('x') % QString::number(size.height())
+                      % QChar('-') % QString::number(m_progressBucket) % QChar('-') % QString::number(m_errorCount));
+    QPixmap pixmap;
+    if(!QPixmapCache::find(key, &pixmap)) {
+        pixmap = render(size);
+        QPixmapCache::insert(key, pixmap);
+    }
+    return pixmap;
+}
+
+QSize StatusIconOverlayEngine::actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(mode)
+    Q_UNUSED(state)
+    return size;
+}
+
+QList<QSize> StatusIconOverlayEngine::availableSizes(QIcon::Mode mode, QIcon::State state) const
+{
+    return m_baseIcon.availableSizes(mode, state);
+}
+
+QString StatusIconOverlayEngine::key() const
+{
+    return QStringLiteral("StatusIconOverlayEngine");
+}
+
+QIconEngine *StatusIconOverlayEngine::clone() const
+{
+    return new StatusIconOverlayEngine(*this);
+}
+
+/*!
+ * \brief Renders the base icon and the overlay to a QPixmap with the specified \a size.
+ * \remarks The base icon is painted onto a pixmap with a device pixel ratio of 1 so its engine renders it at
+ *          \a size as well.
+ */
+QPixmap StatusIconOverlayEngine::render(const QSize &size)
+{
+    QPixmap pixmap(size);
+    pixmap.fill(QColor(Qt::transparent));
+    QPainter painter(&pixmap);
+    m_baseIcon.paint(&painter, pixmap.rect());
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    if(m_progressBucket >= 0) {
+        // use the same proportions as on the 128 px icon the overlay has been designed for
+        const qreal penWidth = size.width() * 12.0 / 128.0;
+        const QRectF ringRect(QRectF(QPointF(0, 0), size).adjusted(penWidth / 2, penWidth / 2, -penWidth / 2, -penWidth / 2));
+        painter.setPen(QPen(QColor(0, 0, 0, 80), penWidth));
+        painter.drawEllipse(ringRect);
+        painter.setPen(QPen(QColor(0x2a, 0x9f, 0xd6), penWidth, Qt::SolidLine, Qt::FlatCap));
+        // angles are specified in 1/16 th of a degree, start at 12 o'clock and go clockwise
+        painter.drawArc(ringRect, 90 * 16, -m_progressBucket * 5 * 360 * 16 / 100);
+    }
+
+    if(m_errorCount > 0) {
+        const QRectF badgeRect(size.width() * 0.5, 0, size.width() * 0.5, size.height() * 0.5);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(0xda, 0x44, 0x53));
+        painter.drawEllipse(badgeRect);
+        QFont font(painter.font());
+        font.setBold(true);
+        font.setPixelSize(qMax(1, static_cast<int>(badgeRect.height() * (m_errorCount > 9 ? 0.45 : 0.6))));
+        painter.setFont(font);
+        painter.setPen(Qt::white);
+        painter.drawText(badgeRect, Qt::AlignCenter, m_errorCount > 9 ? QStringLiteral("9+") : QString::number(m_errorCount));
+    }
+
+    painter.end();
+    return pixmap;
+}
+
+}
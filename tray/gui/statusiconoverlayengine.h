@@ -0,0 +1,31 @@
+#ifndef STATUS_ICON_OVERLAY_ENGINE_H
+#define STATUS_ICON_OVERLAY_ENGINE_H
+
+#include <QIconEngine>
+#include <QIcon>
+
+namespace QtGui {
+
+class StatusIconOverlayEngine : public QIconEngine
+{
+public:
+    StatusIconOverlayEngine(const QIcon &baseIcon, int progressBucket, int errorCount);
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state);
+    QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state);
+    QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state);
+    QList<QSize> availableSizes(QIcon::Mode mode = QIcon::Normal, QIcon::State state = QIcon::Off) const;
+    QString key() const;
+    QIconEngine *clone() const;
+
+private:
+    QPixmap render(const QSize &size);
+
+    const QIcon m_baseIcon;
+    const int m_progressBucket;
+    const int m_errorCount;
+};
+
+}
+
+#endif // STATUS_ICON_OVERLAY_ENGINE_H
@@ -0,0 +1,132 @@
+#include "./textlayoutcache.h"
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QTextOption>
+#include <QTransform>
+
+namespace QtGui {
+
+/*!
+ * \class TextLayoutCache
+ * \brief The TextLayoutCache class caches elided texts, text widths and prepared static texts for item delegates.
+ *
+ * Item delegates paint every visible row again when scrolling or when any data changes. Eliding and laying out the
+ * same text again and again is relatively expensive, especially on low-end machines and with many rows. Hence the
+ * results are cached by text, font, width and elide mode/alignment.
+ *
+ * Since the width and the text are part of the key, resizing the view or changing the data implicitly leads to
+ * new entries being used. Outdated entries are not evicted individually; instead a cache is cleared as a whole when
+ * it exceeds the max. number of entries specified when constructing.
+ */
+
+/*!
+ * \brief Constructs a new cache which keeps at most \a maxEntries per kind of information.
+ */
+TextLayoutCache::TextLayoutCache(int maxEntries) :
+    m_maxEntries(maxEntries)
+{}
+
+/*!
+ * \brief Returns the specified \a text elided to fit into \a width using \a mode.
+ * \remarks The \a fontMetrics must belong to the specified \a font. They are only used if the text is not cached yet.
+ */
+const QString &TextLayoutCache::elidedText(const QFontMetrics &fontMetrics, const QFont &font, const QString &text, Qt::TextElideMode mode, int width)
+{
+    const Key key(font, text, mode, width);
+    auto i = m_elidedTexts.find(key);
+    if(i == m_elidedTexts.end()) {
+        makeRoom(m_elidedTexts);
+        i = m_elidedTexts.insert(key, fontMetrics.elidedText(text, mode, width));
+    }
+    return i.value();
+}
+
+/*!
+ * \brief Returns the width of the specified \a text.
+ * \remarks The \a fontMetrics must belong to the specified \a font. They are only used if the text is not cached yet.
+ */
+int TextLayoutCache::width(const QFontMetrics &fontMetrics, const QFont &font, const QString &text)
+{
+    const Key key(font, text, 0, 0);
+    auto i = m_widths.find(key);
+    if(i == m_widths.end()) {
+        makeRoom(m_widths);
+        i = m_widths.insert(key, fontMetrics.width(text));
+    }
+    return i.value();
+}
+
+/*!
+ * \brief Returns a prepared QStaticText for the specified \a text which is elided on the right to fit into the
+ *        specified \a width and aligned according to the specified \a option.
+ * \remarks
+ * - The text is elided via QFontMetrics::elidedText() and never wrapped so it is shown exactly like QPainter::drawText()
+ *   with a previously elided text would show it.
+ * - The \a fontMetrics must belong to the specified \a font. They are only used if the text is not cached yet.
+ */
+const QStaticText &TextLayoutCache::staticText(const QFontMetrics &fontMetrics, const QFont &font, const QString &text, const QTextOption &option, int width)
+{
+    const Key key(font, text, static_cast<int>(option.alignment()), width);
+    auto i = m_staticTexts.find(key);
+    if(i == m_staticTexts.end()) {
+        makeRoom(m_staticTexts);
+        QTextOption noWrapOption(option);
+        noWrapOption.setWrapMode(QTextOption::NoWrap);
+        QStaticText staticText(elidedText(fontMetrics, font, text, Qt::ElideRight, width));
+        staticText.setTextFormat(Qt::PlainText);
+        staticText.setTextOption(noWrapOption);
+        staticText.prepare(QTransform(), font);
+        i = m_staticTexts.insert(key, staticText);
+    }
+    return i.value();
+}
+
+/*!
+ * \brief Clears all cached information.
+ */
+void TextLayoutCache::clear()
+{
+    m_elidedTexts.clear();
+    m_widths.clear();
+    m_staticTexts.clear();
+}
+
+/*!
+ * \brief Returns the position to draw the specified \a text at so it is aligned within \a rect according to the
+ *        vertical flags of the specified \a alignment.
+ */
+QPointF TextLayoutCache::alignedTextPos(const QRectF &rect, const QStaticText &text, Qt::Alignment alignment)
+{
+    QPointF pos(rect.topLeft());
+    if(alignment & Qt::AlignVCenter) {
+        pos.ry() += (rect.height() - text.size().height()) / 2;
+    } else if(alignment & Qt::AlignBottom) {
+        pos.ry() += rect.height() - text.size().height();
+    }
+    return pos;
+}
+
+/*!
+ * \brief Clears the specified \a hash if it has reached the max. number of entries.
+ */
+template<typename Value> void TextLayoutCache::makeRoom(QHash<Key, Value> &hash)
+{
+    if(hash.size() >= m_maxEntries) {
+        hash.clear();
+    }
+}
+
+TextLayoutCache::Key::Key(const QFont &font, const QString &text, int flags, int width) :
+    font(font.key()),
+    text(text),
+    flags(flags),
+    width(width)
+{}
+
+bool TextLayoutCache::Key::operator==(const Key &other) const
+{
+    return width == other.width && flags == other.flags && text == other.text && font == other.font;
+}
+
+}
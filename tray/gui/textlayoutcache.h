@@ -0,0 +1,54 @@
+#ifndef TEXT_LAYOUT_CACHE_H
+#define TEXT_LAYOUT_CACHE_H
+
+#include <QHash>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include <QStaticText>
+
+QT_FORWARD_DECLARE_CLASS(QFont)
+QT_FORWARD_DECLARE_CLASS(QFontMetrics)
+QT_FORWARD_DECLARE_CLASS(QTextOption)
+
+namespace QtGui {
+
+class TextLayoutCache
+{
+public:
+    TextLayoutCache(int maxEntries = 2048);
+
+    const QString &elidedText(const QFontMetrics &fontMetrics, const QFont &font, const QString &text, Qt::TextElideMode mode, int width);
+    int width(const QFontMetrics &fontMetrics, const QFont &font, const QString &text);
+    const QStaticText &staticText(const QFontMetrics &fontMetrics, const QFont &font, const QString &text, const QTextOption &option, int width);
+    void clear();
+
+    static QPointF alignedTextPos(const QRectF &rect, const QStaticText &text, Qt::Alignment alignment);
+
+private:
+    struct Key
+    {
+        Key(const QFont &font, const QString &text, int flags, int width);
+        bool operator==(const Key &other) const;
+
+        QString font;
+        QString text;
+        int flags;
+        int width;
+    };
+    friend uint qHash(const Key &key, uint seed)
+    {
+        return qHash(key.text, seed) ^ qHash(key.font, seed) ^ static_cast<uint>(key.flags << 24) ^ static_cast<uint>(key.width);
+    }
+
+    template<typename Value> void makeRoom(QHash<Key, Value> &hash);
+
+    QHash<Key, QString> m_elidedTexts;
+    QHash<Key, int> m_widths;
+    QHash<Key, QStaticText> m_staticTexts;
+    const int m_maxEntries;
+};
+
+}
+
+#endif // TEXT_LAYOUT_CACHE_H
@@ -0,0 +1,224 @@
+#include "./trafficsparkline.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace QtGui {
+
+/*!
+ * \brief The width of a single sample in pixels.
+ */
+constexpr int sampleWidth = 2;
+
+/*!
+ * \brief The number of samples kept in the history.
+ */
+constexpr size_t historySize = 180;
+
+/*!
+ * \brief The min. rate (in kbit/s) the graph is scaled to so idle connections don't show noise.
+ */
+constexpr double minScale = 8.0;
+
+/*!
+ * \class TrafficSparkline
+ * \brief The TrafficSparkline class shows the recent incoming and outgoing traffic rates as a small graph.
+ *
+ * Samples are kept in a fixed-size ring buffer so adding a sample is O(1). The graph is rendered into a pixmap which
+ * is only scrolled by the width of new samples when painting; only the new samples are actually drawn. The graph is
+ * only rendered completely when the widget is resized, the scale needs to be increased or too many samples have been
+ * added while the widget was hidden. Nothing is painted while the widget is hidden.
+ */
+
+/*!
+ * \brief Constructs a new, empty sparkline.
+ */
+TrafficSparkline::TrafficSparkline(QWidget *parent) :
+    QWidget(parent),
+    m_samples(historySize),
+    m_head(0),
+    m_count(0),
+    m_pending(0),
+    m_scale(minScale),
+    m_invalidated(true)
+{
+    setToolTip(tr("Traffic history (filled: incoming, line: outgoing)"));
+}
+
+QSize TrafficSparkline::sizeHint() const
+{
+    return QSize(120, 32);
+}
+
+/*!
+ * \brief Adds a sample with the specified rates (in kbit/s).
+ * \remarks Only buffers the sample and schedules an update if the widget is visible.
+ */
+void TrafficSparkline::addSample(double incomingRate, double outgoingRate)
+{
+    m_head = (m_head + 1) % m_samples.size();
+    Sample &sample = m_samples[m_head];
+    sample.incomingRate = incomingRate;
+    sample.outgoingRate = outgoingRate;
+    if(m_count < m_samples.size()) {
+        ++m_count;
+    }
+
+    // increase the scale with some headroom so not every new peak requires rendering everything again
+    const double maxRate = max(incomingRate, outgoingRate);
+    if(maxRate > m_scale) {
+        m_scale = maxRate * 1.25;
+        m_invalidated = true;
+    } else if(!m_invalidated) {
+        ++m_pending;
+    }
+
+    if(isVisible()) {
+        update();
+    }
+}
+
+/*!
+ * \brief Discards all samples, eg. because the connection has been changed.
+ */
+void TrafficSparkline::clear()
+{
+    m_count = m_pending = 0;
+    m_scale = minScale;
+    m_invalidated = true;
+    update();
+}
+
+void TrafficSparkline::paintEvent(QPaintEvent *event)
+{
+    const qreal ratio = devicePixelRatioF();
+    if(m_invalidated || m_pixmap.size() != size() * ratio || m_pixmap.devicePixelRatioF() != ratio) {
+        renderAll();
+    } else if(m_pending) {
+        renderPending();
+    }
+    QPainter painter(this);
+    painter.drawPixmap(event->rect(), m_pixmap, QRectF(QPointF(event->rect().topLeft()) * ratio, QSizeF(event->rect().size()) * ratio));
+}
+
+void TrafficSparkline::resizeEvent(QResizeEvent *event)
+{
+    m_invalidated = true;
+    QWidget::resizeEvent(event);
+}
+
+void TrafficSparkline::changeEvent(QEvent *event)
+{
+    if(event->type() == QEvent::PaletteChange) {
+        m_invalidated = true;
+    }
+    QWidget::changeEvent(event);
+}
+
+/*!
+ * \brief Returns the sample with the specified \a age (0 is the newest sample).
+ */
+const TrafficSparkline::Sample &TrafficSparkline::sample(size_t age) const
+{
+    return m_samples[(m_head + m_samples.size() - age) % m_samples.size()];
+}
+
+/*!
+ * \brief Returns the y-coordinate for the specified \a rate considering the current scale.
+ */
+int TrafficSparkline::sampleY(double rate) const
+{
+    const int h = height();
+    return h - 1 - qRound(min(rate / m_scale, 1.0) * (h - 2));
+}
+
+/*!
+ * \brief Returns the number of samples which fit into the widget.
+ */
+int TrafficSparkline::visibleSampleCount() const
+{
+    return static_cast<int>(min<size_t>(m_count, static_cast<size_t>(width() / sampleWidth)));
+}
+
+/*!
+ * \brief Renders all visible samples, adjusting the scale to the visible samples.
+ */
+void TrafficSparkline::renderAll()
+{
+    const int visibleSamples = visibleSampleCount();
+    m_scale = minScale;
+    for(int age = 0; age < visibleSamples; ++age) {
+        const Sample &s = sample(static_cast<size_t>(age));
+        m_scale = max(m_scale, max(s.incomingRate, s.outgoingRate) * 1.25);
+    }
+
+    const qreal ratio = devicePixelRatioF();
+    m_pixmap = QPixmap(size() * ratio);
+    m_pixmap.setDevicePixelRatio(ratio);
+    m_pixmap.fill(Qt::transparent);
+    QPainter painter(&m_pixmap);
+    for(int age = visibleSamples - 1; age >= 0; --age) {
+        renderSample(painter, static_cast<size_t>(age), width() - (age + 1) * sampleWidth);
+    }
+    m_pending = 0;
+    m_invalidated = false;
+}
+
+/*!
+ * \brief Scrolls the pixmap by the width of the samples added since the last paint and renders only these samples.
+ */
+void TrafficSparkline::renderPending()
+{
+    if(m_pending >= static_cast<size_t>(width() / sampleWidth)) {
+        renderAll();
+        return;
+    }
+    const int dx = static_cast<int>(m_pending) * sampleWidth;
+    const qreal ratio = m_pixmap.devicePixelRatioF();
+    m_pixmap.scroll(-qRound(dx * ratio), 0, m_pixmap.rect());
+    QPainter painter(&m_pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(width() - dx, 0, dx, height(), Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    for(size_t age = m_pending; age-- > 0;) {
+        renderSample(painter, age, width() - static_cast<int>(age + 1) * sampleWidth);
+    }
+    m_pending = 0;
+}
+
+/*!
+ * \brief Renders the sample with the specified \a age at the specified \a x position.
+ * \remarks The line segments are connected to the previous sample which is assumed to be rendered left of \a x.
+ */
+void TrafficSparkline::renderSample(QPainter &painter, size_t age, int x)
+{
+    if(age >= m_count) {
+        return;
+    }
+    const Sample &current = sample(age);
+    const bool hasPrevious = age + 1 < m_count;
+    const int right = x + sampleWidth - 1;
+    const int bottom = height() - 1;
+
+    // incoming rate as filled area with a line on top
+    QColor incomingColor(palette().color(QPalette::Highlight));
+    const int incomingY = sampleY(current.incomingRate);
+    QColor fillColor(incomingColor);
+    fillColor.setAlpha(70);
+    painter.fillRect(x, incomingY, sampleWidth, bottom - incomingY + 1, fillColor);
+    painter.setPen(incomingColor);
+    painter.drawLine(hasPrevious ? QPoint(x - 1, sampleY(sample(age + 1).incomingRate)) : QPoint(x, incomingY), QPoint(right, incomingY));
+
+    // outgoing rate as line
+    QColor outgoingColor(palette().color(QPalette::WindowText));
+    outgoingColor.setAlpha(170);
+    const int outgoingY = sampleY(current.outgoingRate);
+    painter.setPen(outgoingColor);
+    painter.drawLine(hasPrevious ? QPoint(x - 1, sampleY(sample(age + 1).outgoingRate)) : QPoint(x, outgoingY), QPoint(right, outgoingY));
+}
+
+}
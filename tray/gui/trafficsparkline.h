@@ -0,0 +1,72 @@
+#ifndef TRAFFIC_SPARKLINE_H
+#define TRAFFIC_SPARKLINE_H
+
+#include <QWidget>
+#include <QPixmap>
+
+#include <vector>
+
+namespace QtGui {
+
+class TrafficSparkline : public QWidget
+{
+    Q_OBJECT
+
+public:
+    TrafficSparkline(QWidget *parent = nullptr);
+
+    std::size_t capacity() const;
+    std::size_t sampleCount() const;
+    QSize sizeHint() const;
+
+public slots:
+    void addSample(double incomingRate, double outgoingRate);
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void changeEvent(QEvent *event);
+
+private:
+    struct Sample
+    {
+        double incomingRate = 0.0;
+        double outgoingRate = 0.0;
+    };
+
+    const Sample &sample(std::size_t age) const;
+    int sampleY(double rate) const;
+    int visibleSampleCount() const;
+    void renderAll();
+    void renderPending();
+    void renderSample(QPainter &painter, std::size_t age, int x);
+
+    std::vector<Sample> m_samples;
+    std::size_t m_head;
+    std::size_t m_count;
+    std::size_t m_pending;
+    double m_scale;
+    QPixmap m_pixmap;
+    bool m_invalidated;
+};
+
+/*!
+ * \brief Returns the max. number of samples kept in the history.
+ */
+inline std::size_t TrafficSparkline::capacity() const
+{
+    return m_samples.size();
+}
+
+/*!
+ * \brief Returns the number of samples currently kept in the history.
+ */
+inline std::size_t TrafficSparkline::sampleCount() const
+{
+    return m_count;
+}
+
+}
+
+#endif // TRAFFIC_SPARKLINE_H
@@ -1,5 +1,7 @@
 #include "./trayicon.h"
 #include "./traywidget.h"
+#include "./statusiconengine.h"
+#include "./statusiconoverlayengine.h"
 
 #include "../application/settings.h"
 
@@ -8,9 +10,7 @@
 #include <qtutilities/misc/dialogutils.h>
 
 #include <QCoreApplication>
-#include <QSvgRenderer>
-#include <QPainter>
-#include <QPixmap>
+#include <QStringBuilder>
 
 using namespace std;
 using namespace Dialogs;
@@ -27,17 +27,21 @@ namespace QtGui {
 TrayIcon::TrayIcon(QObject *parent) :
     QSystemTrayIcon(parent),
     m_initialized(false),
-    m_size(QSize(128, 128)),
-    m_statusIconDisconnected(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-disconnected.svg")))),
-    m_statusIconIdling(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-ok.svg")))),
-    m_statusIconScanning(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-default.svg")))),
-    m_statusIconNotify(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-notify.svg")))),
-    m_statusIconPause(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-pause.svg")))),
-    m_statusIconSync(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-sync.svg")))),
-    m_statusIconError(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-error.svg")))),
-    m_statusIconErrorSync(QIcon(renderSvgImage(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-error-sync.svg")))),
+    m_statusIconDisconnected(statusIcon(QStringLiteral("disconnected"))),
+    m_statusIconIdling(statusIcon(QStringLiteral("ok"))),
+    m_statusIconScanning(statusIcon(QStringLiteral("default"))),
+    m_statusIconNotify(statusIcon(QStringLiteral("notify"))),
+    m_statusIconPause(statusIcon(QStringLiteral("pause"))),
+    m_statusIconSync(statusIcon(QStringLiteral("sync"))),
+    m_statusIconError(statusIcon(QStringLiteral("error"))),
+    m_statusIconErrorSync(statusIcon(QStringLiteral("error-sync"))),
     m_trayMenu(this),
-    m_status(SyncthingStatus::Disconnected)
+    m_notificationAggregator(m_trayMenu.widget()->connection()),
+    m_statusDebouncer(m_trayMenu.widget()->connection()),
+    m_status(SyncthingStatus::Disconnected),
+    m_baseIcon(nullptr),
+    m_currentIconKey(0, -1),
+    m_composedIcons(64)
 #ifdef QT_UTILITIES_SUPPORT_DBUS_NOTIFICATIONS
     ,
     m_disconnectedNotification(QCoreApplication::applicationName(), QStringLiteral("network-disconnect"), 5000),
@@ -74,8 +78,16 @@ TrayIcon::TrayIcon(QObject *parent) :
     connect(this, &TrayIcon::activated, this, &TrayIcon::handleActivated);
     connect(this, &TrayIcon::messageClicked, m_trayMenu.widget(), &TrayWidget::dismissNotifications);
     connect(connection, &SyncthingConnection::error, this, &TrayIcon::showInternalError);
-    connect(connection, &SyncthingConnection::newNotification, this, &TrayIcon::showSyncthingNotification);
-    connect(connection, &SyncthingConnection::statusChanged, this, &TrayIcon::updateStatusIconAndText);
+    connect(connection, &SyncthingConnection::newNotification, &m_notificationAggregator, &NotificationAggregator::addNotification);
+    connect(&m_notificationAggregator, &NotificationAggregator::notificationReady, this, &TrayIcon::showSyncthingNotification);
+    connect(connection, &SyncthingConnection::statusChanged, &m_statusDebouncer, &StatusDebouncer::handleStatusChanged);
+    connect(&m_statusDebouncer, &StatusDebouncer::statusChanged, this, &TrayIcon::updateStatusIconAndText);
+    connect(&m_statusDebouncer, &StatusDebouncer::syncComplete, this, &TrayIcon::showSyncComplete);
+    connect(connection, &SyncthingConnection::dirStatusChanged, this, &TrayIcon::scheduleStatusIconOverlayUpdate);
+    connect(connection, &SyncthingConnection::downloadProgressChanged, this, &TrayIcon::scheduleStatusIconOverlayUpdate);
+    m_overlayUpdateTimer.setSingleShot(true);
+    m_overlayUpdateTimer.setInterval(500);
+    connect(&m_overlayUpdateTimer, &QTimer::timeout, this, &TrayIcon::updateStatusIconOverlay);
 
     m_initialized = true;
 }
@@ -155,7 +167,7 @@ void TrayIcon::showSyncthingNotification(ChronoUtilities::DateTime when, const Q
             showMessage(tr("Syncthing notification - click to dismiss"), message, QSystemTrayIcon::Warning);
         }
     }
-    updateStatusIconAndText(m_status);
+    refreshStatusIconAndText();
 }
 
 void TrayIcon::updateStatusIconAndText(SyncthingStatus status)
@@ -163,12 +175,33 @@ void TrayIcon::updateStatusIconAndText(SyncthingStatus status)
     if(m_initialized && m_status == status) {
         return;
     }
+    applyStatus(status);
+}
+
+/*!
+ * \brief Updates the status icon and text for the current debounced status even if the status has not changed.
+ * \remarks Required when notifications have been received or read because the icon reflects them as well.
+ */
+void TrayIcon::refreshStatusIconAndText()
+{
+    const SyncthingStatus status = m_statusDebouncer.status();
+    if(m_status == status && (status == SyncthingStatus::Disconnected || status == SyncthingStatus::Reconnecting)) {
+        // the icon does not depend on notifications when not connected; avoid showing the disconnect notification again
+        return;
+    }
+    applyStatus(status);
+}
 
+/*!
+ * \brief Sets the status icon and text for the specified \a status.
+ */
+void TrayIcon::applyStatus(SyncthingStatus status)
+{
     const SyncthingConnection &connection = trayMenu().widget()->connection();
     const auto &settings = Settings::values();
     switch(status) {
     case SyncthingStatus::Disconnected:
-        setIcon(m_statusIconDisconnected);
+        setStatusIcon(m_statusIconDisconnected);
         if(connection.autoReconnectInterval() > 0) {
             setToolTip(tr("Not connected to Syncthing - trying to reconnect every %1 ms")
                        .arg(connection.autoReconnectInterval()));
@@ -187,7 +220,7 @@ void TrayIcon::updateStatusIconAndText(SyncthingStatus status)
         }
         break;
     case SyncthingStatus::Reconnecting:
-        setIcon(m_statusIconDisconnected);
+        setStatusIcon(m_statusIconDisconnected);
         setToolTip(tr("Reconnecting ..."));
         break;
     default:
@@ -196,31 +229,31 @@ void TrayIcon::updateStatusIconAndText(SyncthingStatus status)
 #endif
         if(connection.hasOutOfSyncDirs()) {
             if(status == SyncthingStatus::Synchronizing) {
-                setIcon(m_statusIconErrorSync);
+                setStatusIcon(m_statusIconErrorSync);
                 setToolTip(tr("Synchronization is ongoing but at least one directory is out of sync"));
             } else {
-                setIcon(m_statusIconError);
+                setStatusIcon(m_statusIconError);
                 setToolTip(tr("At least one directory is out of sync"));
             }
         } else if(connection.hasUnreadNotifications()) {
-            setIcon(m_statusIconNotify);
+            setStatusIcon(m_statusIconNotify);
             setToolTip(tr("Notifications available"));
         } else {
             switch(status) {
             case SyncthingStatus::Idle:
-                setIcon(m_statusIconIdling);
+                setStatusIcon(m_statusIconIdling);
                 setToolTip(tr("Syncthing is idling"));
                 break;
             case SyncthingStatus::Scanning:
-                setIcon(m_statusIconScanning);
+                setStatusIcon(m_statusIconScanning);
                 setToolTip(tr("Syncthing is scanning"));
                 break;
             case SyncthingStatus::Paused:
-                setIcon(m_statusIconPause);
+                setStatusIcon(m_statusIconPause);
                 setToolTip(tr("At least one device is paused"));
                 break;
             case SyncthingStatus::Synchronizing:
-                setIcon(m_statusIconSync);
+                setStatusIcon(m_statusIconSync);
                 setToolTip(tr("Synchronization is ongoing"));
                 break;
             default:
@@ -228,53 +261,116 @@ void TrayIcon::updateStatusIconAndText(SyncthingStatus status)
             }
         }
     }
-    switch(status) {
-    case SyncthingStatus::Disconnected:
-    case SyncthingStatus::Reconnecting:
-    case SyncthingStatus::Synchronizing:
-        break;
-    default:
-        if(m_status == SyncthingStatus::Synchronizing && settings.notifyOn.syncComplete) {
-            const vector<SyncthingDir *> &completedDirs = connection.completedDirs();
-            if(!completedDirs.empty()) {
-                QString message;
-                if(completedDirs.size() == 1) {
-                    message = tr("Synchronization of %1 complete").arg(completedDirs.front()->displayName());
-                } else {
-                    QStringList names;
-                    names.reserve(static_cast<int>(completedDirs.size()));
-                    for(const SyncthingDir *dir : completedDirs) {
-                        names << dir->displayName();
-                    }
-                    message = tr("Synchronization of the following devices complete:\n") + names.join(QStringLiteral(", "));
-                }
+    m_status = status;
+}
+
+/*!
+ * \brief Shows a notification that synchronization of the specified directories has been completed.
+ * \remarks Invoked by the StatusDebouncer after the quiet period has passed.
+ */
+void TrayIcon::showSyncComplete(const QStringList &dirNames)
+{
+    const auto &settings = Settings::values();
+    if(!settings.notifyOn.syncComplete || dirNames.isEmpty()) {
+        return;
+    }
+    const QString message(dirNames.size() == 1
+                          ? tr("Synchronization of %1 complete").arg(dirNames.front())
+                          : tr("Synchronization of the following devices complete:\n") + dirNames.join(QStringLiteral(", ")));
 #ifdef QT_UTILITIES_SUPPORT_DBUS_NOTIFICATIONS
-                if(settings.dbusNotifications) {
-                    m_syncCompleteNotification.update(message);
-                } else
+    if(settings.dbusNotifications) {
+        m_syncCompleteNotification.update(message);
+    } else
 #endif
-                {
-                    showMessage(QCoreApplication::applicationName(), message, QSystemTrayIcon::Information);
+    {
+        showMessage(QCoreApplication::applicationName(), message, QSystemTrayIcon::Information);
+    }
+}
+
+/*!
+ * \brief Returns the status icon with the specified \a name.
+ * \remarks The icon is rendered lazily by StatusIconEngine for the size actually requested by the platform.
+ */
+QIcon TrayIcon::statusIcon(const QString &name)
+{
+    return QIcon(new StatusIconEngine(QStringLiteral(":/icons/hicolor/scalable/status/syncthing-") % name % QStringLiteral(".svg")));
+}
+
+/*!
+ * \brief Sets the specified status \a icon taking the progress/error overlay into account.
+ * \remarks Composed icons are cached per progress bucket (5 %) and error count so neither the SVG nor the overlay
+ *          needs to be rendered again and setIcon() is only called if the icon actually changes.
+ */
+void TrayIcon::setStatusIcon(const QIcon &icon)
+{
+    m_baseIcon = &icon;
+
+    int progressBucket = -1, errorCount = 0;
+    if(Settings::values().appearance.trayIconOverlay && &icon != &m_statusIconDisconnected) {
+        const SyncthingConnection &connection = trayMenu().widget()->connection();
+        const bool synchronizing = &icon == &m_statusIconSync || &icon == &m_statusIconErrorSync;
+        int blocksDone = 0, blocksTotal = 0, percentageSum = 0, percentageCount = 0;
+        for(const SyncthingDir &dir : connection.dirInfo()) {
+            errorCount += static_cast<int>(dir.errors.size());
+            if(synchronizing && dir.status == SyncthingDirStatus::Synchronizing) {
+                if(dir.blocksToBeDownloaded > 0) {
+                    blocksDone += dir.blocksAlreadyDownloaded;
+                    blocksTotal += dir.blocksToBeDownloaded;
+                } else if(dir.progressPercentage > 0) {
+                    percentageSum += dir.progressPercentage;
+                    ++percentageCount;
                 }
             }
         }
+        if(blocksTotal > 0) {
+            progressBucket = static_cast<int>(static_cast<qint64>(blocksDone) * 100 / blocksTotal) / 5;
+        } else if(percentageCount) {
+            progressBucket = percentageSum / percentageCount / 5;
+        }
+        progressBucket = qMin(progressBucket, 20);
+        errorCount = qMin(errorCount, 10);
     }
-    m_status = status;
+
+    const int overlay = (progressBucket + 1) * 16 + errorCount;
+    const QPair<qint64, int> key(icon.cacheKey(), overlay);
+    if(key == m_currentIconKey) {
+        return;
+    }
+    m_currentIconKey = key;
+    if(!overlay) {
+        setIcon(icon);
+        return;
+    }
+    // the number of combinations is limited anyways but there's no need to keep icons for all of them, so the least
+    // recently used ones are evicted by QCache
+    QIcon *composedIcon = m_composedIcons.object(key);
+    if(!composedIcon) {
+        composedIcon = new QIcon(new StatusIconOverlayEngine(icon, progressBucket, errorCount));
+        m_composedIcons.insert(key, composedIcon);
+    }
+    setIcon(*composedIcon);
 }
 
 /*!
- * \brief Renders an SVG image to a QPixmap.
- * \remarks If instantiating QIcon directly from SVG image the icon is not displayed under Plasma 5. It would work
- *          with Tint2, tough.
+ * \brief Schedules re-evaluating the progress/error overlay of the current status icon.
+ * \remarks The overlay depends on all directories so it is only re-evaluated once for a burst of directory status and
+ *          download progress changes (eg. when connecting or while synchronizing many directories).
  */
-QPixmap TrayIcon::renderSvgImage(const QString &path)
+void TrayIcon::scheduleStatusIconOverlayUpdate()
 {
-    QSvgRenderer renderer(path);
-    QPixmap pm(m_size);
-    pm.fill(QColor(Qt::transparent));
-    QPainter painter(&pm);
-    renderer.render(&painter, pm.rect());
-    return pm;
+    if(!m_overlayUpdateTimer.isActive()) {
+        m_overlayUpdateTimer.start();
+    }
+}
+
+/*!
+ * \brief Re-evaluates the progress/error overlay of the current status icon.
+ */
+void TrayIcon::updateStatusIconOverlay()
+{
+    if(m_baseIcon) {
+        setStatusIcon(*m_baseIcon);
+    }
 }
 
 }
@@ -2,6 +2,8 @@
 #define TRAY_ICON_H
 
 #include "./traymenu.h"
+#include "./notificationaggregator.h"
+#include "./statusdebouncer.h"
 
 #include <c++utilities/chrono/datetime.h>
 
@@ -11,8 +13,9 @@
 
 #include <QSystemTrayIcon>
 #include <QIcon>
-
-QT_FORWARD_DECLARE_CLASS(QPixmap)
+#include <QCache>
+#include <QPair>
+#include <QTimer>
 
 namespace Data {
 enum class SyncthingStatus;
@@ -33,16 +36,21 @@ public slots:
     void showInternalError(const QString &errorMsg, Data::SyncthingErrorCategory category);
     void showSyncthingNotification(ChronoUtilities::DateTime when, const QString &message);
     void updateStatusIconAndText(Data::SyncthingStatus status);
+    void refreshStatusIconAndText();
+    void showSyncComplete(const QStringList &dirNames);
 
 private slots:
     void handleActivated(QSystemTrayIcon::ActivationReason reason);
     void handleSyncthingNotificationAction(const QString &action);
+    void scheduleStatusIconOverlayUpdate();
+    void updateStatusIconOverlay();
 
 private:
-    QPixmap renderSvgImage(const QString &path);
+    static QIcon statusIcon(const QString &name);
+    void setStatusIcon(const QIcon &icon);
+    void applyStatus(Data::SyncthingStatus status);
 
     bool m_initialized;
-    const QSize m_size;
     const QIcon m_statusIconDisconnected;
     const QIcon m_statusIconIdling;
     const QIcon m_statusIconScanning;
@@ -53,7 +61,13 @@ private:
     const QIcon m_statusIconErrorSync;
     TrayMenu m_trayMenu;
     QMenu m_contextMenu;
+    NotificationAggregator m_notificationAggregator;
+    StatusDebouncer m_statusDebouncer;
     Data::SyncthingStatus m_status;
+    const QIcon *m_baseIcon;
+    QPair<qint64, int> m_currentIconKey;
+    QCache<QPair<qint64, int>, QIcon> m_composedIcons;
+    QTimer m_overlayUpdateTimer;
 #ifdef QT_UTILITIES_SUPPORT_DBUS_NOTIFICATIONS
     MiscUtils::DBusNotification m_disconnectedNotification;
     MiscUtils::DBusNotification m_internalErrorNotification;
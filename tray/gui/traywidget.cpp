@@ -6,6 +6,7 @@
 #include "./textviewdialog.h"
 
 #include "../application/settings.h"
+#include "../application/startupprofile.h"
 
 #ifdef LIB_SYNCTHING_CONNECTOR_SUPPORT_SYSTEMD
 # include "../../connector/syncthingservice.h"
@@ -23,6 +24,7 @@
 #include <qtutilities/misc/desktoputils.h>
 
 #include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/misc/memory.h>
 
 #include <QCoreApplication>
 #include <QDesktopServices>
@@ -33,6 +35,7 @@
 #include <QStringBuilder>
 #include <QFontDatabase>
 #include <QCursor>
+#include <QTimer>
 
 #include <functional>
 #include <algorithm>
@@ -63,7 +66,8 @@ TrayWidget::TrayWidget(TrayMenu *parent) :
     m_dirModel(m_connection),
     m_devModel(m_connection),
     m_dlModel(m_connection),
-    m_selectedConnection(nullptr)
+    m_selectedConnection(nullptr),
+    m_droppedNotifications(0)
 {
     m_instances.push_back(this);
 
@@ -74,6 +78,9 @@ TrayWidget::TrayWidget(TrayMenu *parent) :
     m_ui->devsTreeView->setModel(&m_devModel);
     m_ui->downloadsTreeView->setModel(&m_dlModel);
 
+    // request folder sizes on connect so status snapshots handed to syncthingctl contain them
+    m_connection.setRequestingDirStatusOnConnect(true);
+
     // setup sync-all button
     m_cornerFrame = new QFrame(this);
     auto *cornerFrameLayout = new QHBoxLayout(m_cornerFrame);
@@ -114,8 +121,12 @@ TrayWidget::TrayWidget(TrayMenu *parent) :
     m_notificationsMenu->addAction(m_ui->actionDismissNotifications);
     m_ui->notificationsPushButton->setMenu(m_notificationsMenu);
 
-    // apply settings, this also establishes the connection to Syncthing (according to settings)
-    applySettings();
+    // apply settings when entering the event loop so the tray icon can be shown before, this also establishes
+    // the connection to Syncthing (according to settings) and populates the models
+    QTimer::singleShot(0, this, [] {
+        applySettings();
+        StartupProfile::mark("settings applied");
+    });
 
     // setup other widgets
     m_ui->notificationsPushButton->setHidden(true);
@@ -132,6 +143,7 @@ TrayWidget::TrayWidget(TrayMenu *parent) :
     connect(m_ui->settingsPushButton, &QPushButton::clicked, this, &TrayWidget::showSettingsDialog);
     connect(&m_connection, &SyncthingConnection::statusChanged, this, &TrayWidget::handleStatusChanged);
     connect(&m_connection, &SyncthingConnection::trafficChanged, this, &TrayWidget::updateTraffic);
+    connect(&m_connection, &SyncthingConnection::trafficChanged, this, &TrayWidget::addTrafficSample);
     connect(&m_connection, &SyncthingConnection::newNotification, this, &TrayWidget::handleNewNotification);
     connect(m_ui->dirsTreeView, &DirView::openDir, this, &TrayWidget::openDir);
     connect(m_ui->dirsTreeView, &DirView::scanDir, this, &TrayWidget::scanDir);
@@ -188,6 +200,11 @@ void TrayWidget::showAboutDialog()
 
 void TrayWidget::showWebUi()
 {
+    // neither the web view nor browsers are able to load pages served on a Unix domain socket
+    if(m_connection.isUsingLocalSocket()) {
+        QMessageBox::information(this, QCoreApplication::applicationName(), tr("The web UI can not be shown because Syncthing is connected via the Unix domain socket <i>%1</i> which can not be opened in a web view or browser. Configure Syncthing to serve the GUI on a TCP address to use the web UI.").arg(m_connection.localSocketPath()));
+        return;
+    }
 #ifndef SYNCTHINGTRAY_NO_WEBVIEW
     if(Settings::values().webView.disabled) {
 #endif
@@ -264,10 +281,14 @@ void TrayWidget::showLog()
 void TrayWidget::showNotifications()
 {
     auto *dlg = new TextViewDialog(tr("New notifications"), this);
+    if(m_droppedNotifications) {
+        dlg->browser()->append(tr("%1 older notifications have been discarded.").arg(m_droppedNotifications) % QChar('\n'));
+    }
     for(const SyncthingLogEntry &entry : m_notifications) {
         dlg->browser()->append(entry.when % QChar(':') % QChar(' ') % QChar('\n') % entry.message % QChar('\n'));
     }
     m_notifications.clear();
+    m_droppedNotifications = 0;
     showDialog(dlg);
     dismissNotifications();
 }
@@ -287,7 +308,7 @@ void TrayWidget::dismissNotifications()
     m_connection.considerAllNotificationsRead();
     m_ui->notificationsPushButton->setHidden(true);
     if(m_menu && m_menu->icon()) {
-        m_menu->icon()->updateStatusIconAndText(m_connection.status());
+        m_menu->icon()->refreshStatusIconAndText();
     }
 }
 
@@ -322,6 +343,7 @@ void TrayWidget::handleStatusChanged(SyncthingStatus status)
         m_ui->statusPushButton->setIcon(QIcon::fromTheme(QStringLiteral("view-refresh"), QIcon(QStringLiteral(":/icons/hicolor/scalable/actions/view-refresh.svg"))));
         m_ui->statusPushButton->setHidden(false);
         updateTraffic(); // ensure previous traffic statistics are no longer shown
+        m_ui->trafficSparkline->clear();
         break;
     case SyncthingStatus::Reconnecting:
         m_ui->statusPushButton->setHidden(true);
@@ -348,6 +370,9 @@ void TrayWidget::handleStatusChanged(SyncthingStatus status)
 void TrayWidget::applySettings()
 {
     for(TrayWidget *instance : m_instances) {
+        // standby connections refer to settings which might have been altered or removed
+        instance->m_standbyConnections.clear();
+
         // update connections menu
         int connectionIndex = 0;
         auto &settings = Settings::values();
@@ -381,9 +406,16 @@ void TrayWidget::applySettings()
         instance->m_connection.connect(*instance->m_selectedConnection);
 
         // web view
+        const bool webUiAvailable = !instance->m_connection.isUsingLocalSocket();
+        instance->m_ui->webUiPushButton->setEnabled(webUiAvailable);
+        instance->m_ui->webUiPushButton->setToolTip(webUiAvailable ? tr("Web UI") : tr("The web UI is not available when connecting via a Unix domain socket"));
 #ifndef SYNCTHINGTRAY_NO_WEBVIEW
         if(instance->m_webViewDlg) {
-            instance->m_webViewDlg->applySettings(*instance->m_selectedConnection);
+            if(webUiAvailable) {
+                instance->m_webViewDlg->applySettings(*instance->m_selectedConnection);
+            } else {
+                instance->m_webViewDlg->hide();
+            }
         }
 #endif
 
@@ -395,6 +427,7 @@ void TrayWidget::applySettings()
         // update visual appearance
         instance->m_ui->trafficFormWidget->setVisible(settings.appearance.showTraffic);
         instance->m_ui->trafficIconLabel->setVisible(settings.appearance.showTraffic);
+        instance->m_ui->trafficSparkline->setVisible(settings.appearance.showTraffic);
         instance->m_ui->trafficHorizontalSpacer->changeSize(0, 20, settings.appearance.showTraffic ? QSizePolicy::Expanding : QSizePolicy::Ignored, QSizePolicy::Minimum);
         if(settings.appearance.showTraffic) {
             instance->updateTraffic();
@@ -496,6 +529,17 @@ void TrayWidget::updateTraffic()
 
 }
 
+/*!
+ * \brief Adds the current traffic rates to the traffic history.
+ * \remarks Only buffers the sample while the tray menu is hidden.
+ */
+void TrayWidget::addTrafficSample()
+{
+    if(m_connection.isConnected()) {
+        m_ui->trafficSparkline->addSample(m_connection.totalIncomingRate(), m_connection.totalOutgoingRate());
+    }
+}
+
 #ifdef LIB_SYNCTHING_CONNECTOR_SUPPORT_SYSTEMD
 void TrayWidget::handleSystemdStatusChanged()
 {
@@ -557,6 +601,12 @@ void TrayWidget::handleWebViewDeleted()
 
 void TrayWidget::handleNewNotification(DateTime when, const QString &msg)
 {
+    // keep only the most recent notifications
+    static constexpr size_t maxNotifications = 500;
+    if(m_notifications.size() >= maxNotifications) {
+        m_notifications.pop_front();
+        ++m_droppedNotifications;
+    }
     m_notifications.emplace_back(QString::fromLocal8Bit(when.toString(DateTimeOutputFormat::DateAndTime, true).data()), msg);
     m_ui->notificationsPushButton->setHidden(false);
 }
@@ -565,11 +615,15 @@ void TrayWidget::handleConnectionSelected(QAction *connectionAction)
 {
     int index = m_connectionsMenu->actions().indexOf(connectionAction);
     if(index >= 0) {
+        SyncthingConnectionSettings *const previousConnection = m_selectedConnection;
         m_selectedConnection = (index == 0)
                 ? &Settings::values().connection.primary
                 : &Settings::values().connection.secondary[static_cast<size_t>(index - 1)];
         m_ui->connectionsPushButton->setText(m_selectedConnection->label);
-        m_connection.reconnect(*m_selectedConnection);
+        m_ui->trafficSparkline->clear();
+        if(!switchToStandbyConnection(previousConnection)) {
+            m_connection.reconnect(*m_selectedConnection);
+        }
 #ifdef LIB_SYNCTHING_CONNECTOR_SUPPORT_SYSTEMD
         handleSystemdStatusChanged();
 #endif
@@ -581,6 +635,76 @@ void TrayWidget::handleConnectionSelected(QAction *connectionAction)
     }
 }
 
+/*!
+ * \brief Keeps the state of the current connection in a standby connection and takes over the state of the standby
+ *        connection for the selected connection settings if there is one.
+ *
+ * This way switching between recently used Syncthing instances does not require establishing a new connection. The
+ * models just get the already populated state of the standby connection.
+ *
+ * \returns Returns whether the state of a standby connection could be taken over; otherwise the current connection
+ *          still needs to be (re)connected using the selected settings.
+ */
+bool TrayWidget::switchToStandbyConnection(SyncthingConnectionSettings *previousConnection)
+{
+    const auto maxStandbyConnections = static_cast<size_t>(max(Settings::values().connection.standbyConnections, 0));
+    if(!maxStandbyConnections || !previousConnection || previousConnection == m_selectedConnection) {
+        return false;
+    }
+
+    // find standby connection for the selected settings
+    auto standby = find_if(m_standbyConnections.begin(), m_standbyConnections.end(), [this] (const pair<SyncthingConnectionSettings *, unique_ptr<SyncthingConnection>> &standbyConnection) {
+        return standbyConnection.first == m_selectedConnection;
+    });
+    const bool takeOver = standby != m_standbyConnections.end() && standby->second->isConnected();
+
+    // discard the standby connection if it is not connected or the current connection is not worth keeping
+    if(!m_connection.isConnected()) {
+        if(standby != m_standbyConnections.end() && !takeOver) {
+            m_standbyConnections.erase(standby);
+        } else if(takeOver) {
+            auto connection(move(standby->second));
+            m_standbyConnections.erase(standby);
+            m_connection.swapState(*connection);
+            return true;
+        }
+        return false;
+    }
+
+    // keep the current state in a standby connection (recycling the one to be taken over)
+    unique_ptr<SyncthingConnection> connection;
+    if(standby != m_standbyConnections.end()) {
+        connection = move(standby->second);
+        m_standbyConnections.erase(standby);
+    }
+    if(!takeOver) {
+        connection = make_unique<SyncthingConnection>();
+        connect(connection.get(), &SyncthingConnection::error, this, &TrayWidget::handleStandbyConnectionError);
+    }
+    connection->setStandby(true);
+    m_connection.swapState(*connection);
+    m_standbyConnections.emplace(m_standbyConnections.begin(), previousConnection, move(connection));
+    if(m_standbyConnections.size() > maxStandbyConnections) {
+        m_standbyConnections.erase(m_standbyConnections.begin() + static_cast<ptrdiff_t>(maxStandbyConnections), m_standbyConnections.end());
+    }
+    return takeOver;
+}
+
+/*!
+ * \brief Adds errors of standby connections to the notifications so they don't vanish silently.
+ * \remarks The connection is not shown in the connection menu anymore, so its label is mentioned.
+ */
+void TrayWidget::handleStandbyConnectionError(const QString &errorMessage)
+{
+    const auto *const connection = static_cast<SyncthingConnection *>(sender());
+    for(const auto &standbyConnection : m_standbyConnections) {
+        if(standbyConnection.second.get() == connection) {
+            handleNewNotification(DateTime::now(), tr("Standby connection \"%1\": %2").arg(standbyConnection.first->label, errorMessage));
+            return;
+        }
+    }
+}
+
 void TrayWidget::showDialog(QWidget *dlg)
 {
     if(m_menu) {
@@ -15,6 +15,8 @@
 #include <QWidget>
 
 #include <memory>
+#include <deque>
+#include <utility>
 
 QT_FORWARD_DECLARE_CLASS(QFrame)
 QT_FORWARD_DECLARE_CLASS(QMenu)
@@ -71,6 +73,7 @@ private slots:
     void pauseResumeDev(const Data::SyncthingDev &dev);
     void changeStatus();
     void updateTraffic();
+    void addTrafficSample();
 #ifdef LIB_SYNCTHING_CONNECTOR_SUPPORT_SYSTEMD
     void handleSystemdStatusChanged();
     void connectIfServiceRunning();
@@ -80,6 +83,8 @@ private slots:
 #endif
     void handleNewNotification(ChronoUtilities::DateTime when, const QString &msg);
     void handleConnectionSelected(QAction *connectionAction);
+    bool switchToStandbyConnection(Data::SyncthingConnectionSettings *previousConnection);
+    void handleStandbyConnectionError(const QString &errorMessage);
     void showDialog(QWidget *dlg);
 
 private:
@@ -98,8 +103,10 @@ private:
     QMenu *m_connectionsMenu;
     QActionGroup *m_connectionsActionGroup;
     Data::SyncthingConnectionSettings *m_selectedConnection;
+    std::vector<std::pair<Data::SyncthingConnectionSettings *, std::unique_ptr<Data::SyncthingConnection>>> m_standbyConnections;
     QMenu *m_notificationsMenu;
-    std::vector<Data::SyncthingLogEntry> m_notifications;
+    std::deque<Data::SyncthingLogEntry> m_notifications;
+    std::size_t m_droppedNotifications;
     static std::vector<TrayWidget *> m_instances;
 };
 
@@ -38,9 +38,9 @@ WebPage::WebPage(WebViewDialog *dlg, WEB_VIEW_PROVIDER *view) :
     connect(this, &WebPage::authenticationRequired, this, static_cast<void(WebPage::*)(const QUrl &, QAuthenticator *)>(&WebPage::supplyCredentials));
 #else
     settings()->setAttribute(QWebSettings::JavascriptCanOpenWindows, true);
-    setNetworkAccessManager(&Data::networkAccessManager());
-    connect(&Data::networkAccessManager(), &QNetworkAccessManager::authenticationRequired, this, static_cast<void(WebPage::*)(QNetworkReply *, QAuthenticator *)>(&WebPage::supplyCredentials));
-    connect(&Data::networkAccessManager(), &QNetworkAccessManager::sslErrors, this, static_cast<void(WebPage::*)(QNetworkReply *, const QList<QSslError> &errors)>(&WebPage::handleSslErrors));
+    setNetworkAccessManager(&Data::networkAccessManager(Data::SyncthingNetworkLane::WebView));
+    connect(&Data::networkAccessManager(Data::SyncthingNetworkLane::WebView), &QNetworkAccessManager::authenticationRequired, this, static_cast<void(WebPage::*)(QNetworkReply *, QAuthenticator *)>(&WebPage::supplyCredentials));
+    connect(&Data::networkAccessManager(Data::SyncthingNetworkLane::WebView), &QNetworkAccessManager::sslErrors, this, static_cast<void(WebPage::*)(QNetworkReply *, const QList<QSslError> &errors)>(&WebPage::handleSslErrors));
 #endif
 
     if(!m_view) {
@@ -9,8 +9,11 @@
 #include <QIcon>
 #include <QCloseEvent>
 #include <QKeyEvent>
+#include <QShowEvent>
+#include <QHideEvent>
 #if defined(SYNCTHINGTRAY_USE_WEBENGINE)
 # include <QWebEngineView>
+# include <QWebEnginePage>
 #elif defined(SYNCTHINGTRAY_USE_WEBKIT)
 # include <QWebView>
 # include <QWebFrame>
@@ -22,21 +25,15 @@ namespace QtGui {
 
 WebViewDialog::WebViewDialog(QWidget *parent) :
     QMainWindow(parent),
-    m_view(new WEB_VIEW_PROVIDER(this))
+    m_view(nullptr)
 {
     setWindowTitle(tr("Syncthing"));
     setWindowIcon(QIcon(QStringLiteral(":/icons/hicolor/scalable/app/syncthingtray.svg")));
-    setCentralWidget(m_view);
+    loadView();
 
-    m_view->setPage(new WebPage(this, m_view));
-    connect(m_view, &WEB_VIEW_PROVIDER::titleChanged, this, &WebViewDialog::setWindowTitle);
-
-#if defined(SYNCTHINGTRAY_USE_WEBENGINE)
-    m_view->installEventFilter(this);
-    if(m_view->focusProxy()) {
-        m_view->focusProxy()->installEventFilter(this);
-    }
-#endif
+    m_unloadTimer.setSingleShot(true);
+    m_unloadTimer.setTimerType(Qt::VeryCoarseTimer);
+    connect(&m_unloadTimer, &QTimer::timeout, this, &WebViewDialog::unloadView);
 
     if(Settings::values().webView.geometry.isEmpty()) {
         resize(1200, 800);
@@ -54,16 +51,91 @@ QtGui::WebViewDialog::~WebViewDialog()
 void QtGui::WebViewDialog::applySettings(const Data::SyncthingConnectionSettings &connectionSettings)
 {
     m_settings = connectionSettings;
+    if(!m_view) {
+        // just forget the page to be restored when the view is loaded again
+        if(!WebPage::isSamePage(m_unloadedUrl, connectionSettings.syncthingUrl)) {
+            m_unloadedUrl.clear();
+            m_unloadedScrollPosition = QPointF();
+        }
+        return;
+    }
     if(!WebPage::isSamePage(m_view->url(), connectionSettings.syncthingUrl)) {
         m_view->setUrl(connectionSettings.syncthingUrl);
     }
     m_view->setZoomFactor(Settings::values().webView.zoomFactor);
 }
 
+/*!
+ * \brief Creates the web view; restores the page and the scroll position saved by unloadView() if present.
+ */
+void WebViewDialog::loadView()
+{
+    m_view = new WEB_VIEW_PROVIDER(this);
+    setCentralWidget(m_view);
+
+    m_view->setPage(new WebPage(this, m_view));
+    connect(m_view, &WEB_VIEW_PROVIDER::titleChanged, this, &WebViewDialog::setWindowTitle);
+
+#if defined(SYNCTHINGTRAY_USE_WEBENGINE)
+    m_view->installEventFilter(this);
+    if(m_view->focusProxy()) {
+        m_view->focusProxy()->installEventFilter(this);
+    }
+#endif
+
+    if(m_unloadedUrl.isEmpty()) {
+        return;
+    }
+    if(!m_unloadedScrollPosition.isNull()) {
+        connect(m_view, &WEB_VIEW_PROVIDER::loadFinished, this, &WebViewDialog::restoreScrollPosition);
+    }
+    m_view->setZoomFactor(Settings::values().webView.zoomFactor);
+    m_view->setUrl(m_unloadedUrl);
+    m_unloadedUrl.clear();
+}
+
+/*!
+ * \brief Destroys the web view while keeping the dialog itself alive.
+ *
+ * Only the current URL and the scroll position are kept. The view is loaded again when the dialog is shown the next time.
+ *
+ * \remarks Called after the dialog has been hidden for the time specified via Settings::WebView::unloadAfterIdle.
+ */
+void WebViewDialog::unloadView()
+{
+    if(!m_view || isVisible()) {
+        return;
+    }
+    m_unloadedUrl = m_view->url();
+#if defined(SYNCTHINGTRAY_USE_WEBENGINE)
+    m_unloadedScrollPosition = m_view->page()->scrollPosition();
+#elif defined(SYNCTHINGTRAY_USE_WEBKIT)
+    m_unloadedScrollPosition = m_view->page()->mainFrame() ? QPointF(m_view->page()->mainFrame()->scrollPosition()) : QPointF();
+#endif
+    delete takeCentralWidget();
+    m_view = nullptr;
+}
+
+/*!
+ * \brief Restores the scroll position saved by unloadView() when the page has been loaded again.
+ */
+void WebViewDialog::restoreScrollPosition()
+{
+    disconnect(m_view, &WEB_VIEW_PROVIDER::loadFinished, this, &WebViewDialog::restoreScrollPosition);
+#if defined(SYNCTHINGTRAY_USE_WEBENGINE)
+    m_view->page()->runJavaScript(QStringLiteral("window.scrollTo(%1, %2);").arg(m_unloadedScrollPosition.x()).arg(m_unloadedScrollPosition.y()));
+#elif defined(SYNCTHINGTRAY_USE_WEBKIT)
+    if(m_view->page()->mainFrame()) {
+        m_view->page()->mainFrame()->setScrollPosition(m_unloadedScrollPosition.toPoint());
+    }
+#endif
+    m_unloadedScrollPosition = QPointF();
+}
+
 #if defined(SYNCTHINGTRAY_USE_WEBKIT)
 bool WebViewDialog::isModalVisible() const
 {
-    if(m_view->page()->mainFrame()) {
+    if(m_view && m_view->page()->mainFrame()) {
         return m_view->page()->mainFrame()->evaluateJavaScript(QStringLiteral("$('.modal-dialog').is(':visible')")).toBool();
     }
     return false;
@@ -72,6 +144,10 @@ bool WebViewDialog::isModalVisible() const
 
 void WebViewDialog::closeUnlessModalVisible()
 {
+    if(!m_view) {
+        close();
+        return;
+    }
 #if defined(SYNCTHINGTRAY_USE_WEBKIT)
     if(!isModalVisible()) {
         close();
@@ -87,6 +163,28 @@ void WebViewDialog::closeUnlessModalVisible()
 #endif
 }
 
+void WebViewDialog::showEvent(QShowEvent *event)
+{
+    m_unloadTimer.stop();
+    if(!m_view) {
+        const bool restorePage = !m_unloadedUrl.isEmpty();
+        loadView();
+        if(!restorePage && !m_settings.syncthingUrl.isEmpty()) {
+            applySettings(m_settings);
+        }
+    }
+    QMainWindow::showEvent(event);
+}
+
+void WebViewDialog::hideEvent(QHideEvent *event)
+{
+    const auto &webViewSettings = Settings::values().webView;
+    if(webViewSettings.keepRunning && webViewSettings.unloadAfterIdle > 0) {
+        m_unloadTimer.start(webViewSettings.unloadAfterIdle * 1000);
+    }
+    QMainWindow::hideEvent(event);
+}
+
 void QtGui::WebViewDialog::closeEvent(QCloseEvent *event)
 {
     if(!Settings::values().webView.keepRunning) {
@@ -99,7 +197,9 @@ void WebViewDialog::keyPressEvent(QKeyEvent *event)
 {
     switch(event->key()) {
     case Qt::Key_F5:
-        m_view->reload();
+        if(m_view) {
+            m_view->reload();
+        }
         event->accept();
         break;
     case Qt::Key_Escape:
@@ -116,7 +216,7 @@ bool WebViewDialog::eventFilter(QObject *watched, QEvent *event)
 {
     switch(event->type()) {
     case QEvent::ChildAdded:
-        if(m_view->focusProxy()) {
+        if(m_view && m_view->focusProxy()) {
             m_view->focusProxy()->installEventFilter(this);
         }
         break;
@@ -7,6 +7,9 @@
 #include "../application/settings.h"
 
 #include <QMainWindow>
+#include <QTimer>
+#include <QUrl>
+#include <QPointF>
 
 QT_FORWARD_DECLARE_CLASS(WEB_VIEW_PROVIDER)
 
@@ -30,17 +33,29 @@ public slots:
     bool isModalVisible() const;
 #endif
     void closeUnlessModalVisible();
+    bool isViewLoaded() const;
+    void unloadView();
 
 protected:
+    void showEvent(QShowEvent *event);
+    void hideEvent(QHideEvent *event);
     void closeEvent(QCloseEvent *event);
     void keyPressEvent(QKeyEvent *event);
 #if defined(SYNCTHINGTRAY_USE_WEBENGINE)
     bool eventFilter(QObject *watched, QEvent *event);
 #endif
 
+private slots:
+    void restoreScrollPosition();
+
 private:
+    void loadView();
+
     WEB_VIEW_PROVIDER *m_view;
     Data::SyncthingConnectionSettings m_settings;
+    QTimer m_unloadTimer;
+    QUrl m_unloadedUrl;
+    QPointF m_unloadedScrollPosition;
 };
 
 inline const Data::SyncthingConnectionSettings &WebViewDialog::settings() const
@@ -48,6 +63,15 @@ inline const Data::SyncthingConnectionSettings &WebViewDialog::settings() const
     return m_settings;
 }
 
+/*!
+ * \brief Returns whether the web view is currently loaded.
+ * \remarks The web view is unloaded after it has not been shown for the time specified in the settings.
+ */
+inline bool WebViewDialog::isViewLoaded() const
+{
+    return m_view != nullptr;
+}
+
 }
 
 #endif // SYNCTHINGTRAY_NO_WEBVIEW